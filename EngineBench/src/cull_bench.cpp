@@ -0,0 +1,117 @@
+#include "EngineCore/Modules/CullingBatch.hpp"
+#include "EngineCore/Bounds.hpp"
+
+#include <glm/ext/matrix_clip_space.hpp>
+#include <glm/ext/matrix_transform.hpp>
+#include <glm/trigonometric.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <format>
+#include <random>
+#include <vector>
+#include <algorithm>
+
+// Frustum culling throughput of the CullingBatch kernels against a per-object Frustum::intersects loop,
+// for 10k, 100k and 1M random spheres around the camera. Every path has to return the same index list
+// as the loop, the bench fails otherwise. Paths the CPU doesn't support are skipped.
+// usage: CullBench [passes]
+
+using EngineCore::BoundingSphere;
+using EngineCore::CullingBatch;
+using EngineCore::Frustum;
+
+// roughly a fifth of the spheres end up inside the frustum
+static std::vector<BoundingSphere> make_spheres(const size_t count) {
+    std::mt19937 rng(1337);
+    std::uniform_real_distribution<float> position(-60.f, 60.f);
+    std::uniform_real_distribution<float> radius(0.05f, 2.f);
+
+    std::vector<BoundingSphere> res(count);
+    for (auto& sphere : res) {
+        sphere.center = { position(rng), position(rng), position(rng) };
+        sphere.radius = radius(rng);
+    }
+    return res;
+}
+
+// the editor's projection (80 degrees, 16:9, 0.1 to 100) looking down -z from the origin
+static Frustum make_frustum() {
+    const glm::mat4 projection = glm::perspective(glm::radians(80.f), 16.f / 9.f, 0.1f, 100.f);
+    const glm::mat4 view = glm::lookAt(glm::vec3(0.f), glm::vec3(0.f, 0.f, -1.f), glm::vec3(0.f, 1.f, 0.f));
+    return Frustum::from_matrix(projection * view);
+}
+
+// keeps the culling from being optimized out
+static volatile size_t g_sink = 0;
+
+template<typename Cull>
+static double best_pass_ms(const int passes, Cull&& cull) {
+    double best = 0.0;
+    for (int pass = 0; pass < passes; ++pass) {
+        const auto start = std::chrono::steady_clock::now();
+        g_sink = g_sink + cull();
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        best = pass == 0 ? ms : std::min(best, ms);
+    }
+    return best;
+}
+
+static void report(const char* name, const double ms, const size_t count, const double baseline_ms) {
+    const double per_second = ms > 0.0 ? count / (ms / 1000.0) / 1e6 : 0.0;
+    std::puts(std::format("  {:<24} {:9.3f} ms  {:8.1f} M/s  x{:.2f}", name, ms, per_second, ms > 0.0 ? baseline_ms / ms : 0.0).c_str());
+}
+
+int main(int argc, char** argv) {
+    const int passes = argc > 1 ? std::max(std::atoi(argv[1]), 1) : 20;
+    const Frustum frustum = make_frustum();
+    const CullingBatch::Path best_path = CullingBatch::get_best_path();
+    bool valid = true;
+
+    // the engine logs compile out of release builds, results go straight to stdout
+    std::puts(std::format("best of {} passes, best path on this CPU: {}", passes, CullingBatch::get_path_name(best_path)).c_str());
+
+    for (const size_t count : { size_t(10000), size_t(100000), size_t(1000000) }) {
+        const auto spheres = make_spheres(count);
+        CullingBatch batch;
+        batch.reserve(count);
+        for (auto const& sphere : spheres) {
+            batch.push_back(sphere);
+        }
+
+        std::vector<uint32_t> expected;
+        expected.reserve(count);
+        const double loop_ms = best_pass_ms(passes, [&]() {
+            expected.clear();
+            for (size_t i = 0; i < spheres.size(); ++i) {
+                if (frustum.intersects(spheres[i])) {
+                    expected.push_back(static_cast<uint32_t>(i));
+                }
+            }
+            return expected.size();
+        });
+
+        std::puts(std::format("{} spheres, {} visible", count, expected.size()).c_str());
+        report("Frustum::intersects", loop_ms, count, loop_ms);
+
+        std::vector<uint32_t> visible;
+        for (const auto path : { CullingBatch::Path::Scalar, CullingBatch::Path::SSE, CullingBatch::Path::AVX2 }) {
+            const auto name = std::format("CullingBatch {}", CullingBatch::get_path_name(path));
+            if (path > best_path) {
+                std::puts(std::format("  {:<24} not supported", name).c_str());
+                continue;
+            }
+            const double ms = best_pass_ms(passes, [&]() {
+                return batch.cull(frustum, visible, path);
+            });
+            report(name.c_str(), ms, count, loop_ms);
+            if (visible != expected) {
+                std::fputs(std::format("{}: {} visible, Frustum::intersects found {}\n", name, visible.size(), expected.size()).c_str(), stderr);
+                valid = false;
+            }
+        }
+    }
+
+    return valid ? 0 : 1;
+}
@@ -0,0 +1,133 @@
+
+#include "EngineCore/Modules/FileRead.hpp"
+
+#include <stb_image.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <format>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <filesystem>
+#include <initializer_list>
+
+// Shader and texture load throughput of FileView against the readers it replaced.
+// Every file is read once before timing, so the numbers are for a warm page cache.
+// usage: FileReadBench [passes]
+
+// read_file before FileView: line by line into a growing string
+static std::string read_file_getline(std::string const& name) {
+    std::ifstream input(name);
+    std::string res, buf;
+    while (std::getline(input, buf)) {
+        res += buf + '\n';
+    }
+    return res;
+}
+
+static std::vector<std::string> collect_files(std::filesystem::path const& root, std::initializer_list<const char*> extensions) {
+    std::vector<std::string> res;
+    std::error_code ec;
+    for (auto const& entry : std::filesystem::recursive_directory_iterator(root, ec)) {
+        if (!entry.is_regular_file()) {
+            continue;
+        }
+        const auto extension = entry.path().extension().string();
+        if (std::find_if(extensions.begin(), extensions.end(), [&](const char* e) { return extension == e; }) != extensions.end()) {
+            res.push_back(entry.path().string());
+        }
+    }
+    std::sort(res.begin(), res.end());
+    return res;
+}
+
+// keeps the loads from being optimized out
+static volatile size_t g_sink = 0;
+
+// best pass of 'passes', each pass loads every file once
+template<typename Load>
+static double best_pass_ms(std::vector<std::string> const& files, const int passes, Load&& load) {
+    double best = 0.0;
+    for (int pass = 0; pass < passes; ++pass) {
+        const auto start = std::chrono::steady_clock::now();
+        for (auto const& file : files) {
+            g_sink = g_sink + load(file);
+        }
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        best = pass == 0 ? ms : std::min(best, ms);
+    }
+    return best;
+}
+
+static void report(const char* name, const double ms, const size_t bytes, const double baseline_ms) {
+    const double mb_per_s = ms > 0.0 ? (bytes / (1024.0 * 1024.0)) / (ms / 1000.0) : 0.0;
+    std::puts(std::format("{:<28} {:9.3f} ms  {:9.1f} MB/s  x{:.2f}", name, ms, mb_per_s, ms > 0.0 ? baseline_ms / ms : 0.0).c_str());
+}
+
+int main(int argc, char** argv) {
+    const int passes = argc > 1 ? std::max(std::atoi(argv[1]), 1) : 20;
+
+    const auto shaders = collect_files(PROJECT_SOURCE_DIR "EngineCore/src/EngineCore/Shaders", { ".vert", ".frag", ".comp", ".glsl" });
+    const auto images = collect_files(PROJECT_SOURCE_DIR "resources", { ".png", ".jpg", ".jpeg" });
+
+    size_t shader_bytes = 0;
+    for (auto const& file : shaders) {
+        shader_bytes += EngineCore::FileView(file).size();
+    }
+    size_t image_bytes = 0;
+    for (auto const& file : images) {
+        image_bytes += EngineCore::FileView(file).size();
+    }
+
+    // the engine logs compile out of release builds, results go straight to stdout
+    std::puts(std::format("{} shaders ({} KB), {} images ({} KB), best of {} passes",
+        shaders.size(), shader_bytes / 1024, images.size(), image_bytes / 1024, passes).c_str());
+
+    const double shader_getline = best_pass_ms(shaders, passes, [](std::string const& file) {
+        return read_file_getline(file).size();
+    });
+    const double shader_mapped = best_pass_ms(shaders, passes, [](std::string const& file) {
+        return EngineCore::FileView(file).str().size();
+    });
+    const double shader_read = best_pass_ms(shaders, passes, [](std::string const& file) {
+        return EngineCore::FileView(file, EngineCore::FileView::Mode::Read).str().size();
+    });
+    report("shaders: getline", shader_getline, shader_bytes, shader_getline);
+    report("shaders: FileView mapped", shader_mapped, shader_bytes, shader_getline);
+    report("shaders: FileView read", shader_read, shader_bytes, shader_getline);
+
+    // decode only once per image and pass, stb frees its own buffers
+    auto decode = [](const unsigned char* data, const int width, const int height, const int channels) -> size_t {
+        if (!data) {
+            return 0;
+        }
+        stbi_image_free(const_cast<unsigned char*>(data));
+        return static_cast<size_t>(width) * height * channels;
+    };
+
+    const double image_path = best_pass_ms(images, passes, [&](std::string const& file) {
+        int width = 0, height = 0, channels = 0;
+        unsigned char* data = stbi_load(file.c_str(), &width, &height, &channels, 0);
+        return decode(data, width, height, channels);
+    });
+    const double image_mapped = best_pass_ms(images, passes, [&](std::string const& file) {
+        const EngineCore::FileView view(file);
+        int width = 0, height = 0, channels = 0;
+        unsigned char* data = stbi_load_from_memory(view.data(), static_cast<int>(view.size()), &width, &height, &channels, 0);
+        return decode(data, width, height, channels);
+    });
+    const double image_read = best_pass_ms(images, passes, [&](std::string const& file) {
+        const EngineCore::FileView view(file, EngineCore::FileView::Mode::Read);
+        int width = 0, height = 0, channels = 0;
+        unsigned char* data = stbi_load_from_memory(view.data(), static_cast<int>(view.size()), &width, &height, &channels, 0);
+        return decode(data, width, height, channels);
+    });
+    report("images: stbi_load", image_path, image_bytes, image_path);
+    report("images: FileView mapped", image_mapped, image_bytes, image_path);
+    report("images: FileView read", image_read, image_bytes, image_path);
+
+    return 0;
+}
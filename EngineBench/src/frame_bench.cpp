@@ -0,0 +1,646 @@
+#include <EngineCore/Application.hpp>
+#include <EngineCore/CameraPath.hpp>
+#include <EngineCore/Profiler.hpp>
+#include <EngineCore/RenderStats.hpp>
+#include <EngineCore/Model.hpp>
+#include <EngineCore/Modules/ModelCache.hpp>
+#include <EngineCore/Rendering/OpenGL/ShaderProgram.hpp>
+
+#include <glad/glad.h>
+
+#include <glm/trigonometric.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Frame time benchmark: replays a camera path with a fixed time step, so every run renders the same
+// frames, and writes p50/p95/p99/max of the CPU, whole frame, GPU and light binning times as JSON.
+// Runs headless unless --window is given; frames are recorded once every model is loaded.
+// --model-load times a cold import of the model (cooked cache deleted) against a load from the cache instead.
+// --uniforms times a 32 point light upload through name lookups against ShaderProgram::Uniform handles.
+// --unsorted, --no-mdi, --no-instancing and --mixed-field change how the scene is submitted, the JSON keeps the
+// RenderQueue counters (binds issued and saved, multi-draw batches) per frame for comparing runs.
+// usage: bench [--path file.campath] [--out result.json] [--fps n] [--warmup n] [--cubes n] [--lights n] [--size WxH] [--window] [--trace trace.json] [--stats-csv stats.csv]
+//              [--unsorted] [--no-mdi] [--no-instancing] [--mixed-field]
+//        bench --model-load [--model file] [--out result.json]
+//        bench --uniforms
+
+struct BenchOptions {
+    std::string path = PROJECT_SOURCE_DIR "resources/bench/orbit.campath";
+    std::string out = "bench.json";
+    // Chrome trace of the last Profiler::HISTORY_FRAMES frames, none when empty
+    std::string trace;
+    // Renderer_OpenGL counters of every recorded frame, none when empty
+    std::string stats_csv;
+    // path time advances 1 / fps per frame, independent of how long frames take
+    uint32_t fps = 60;
+    uint32_t warmup = 30;
+    size_t cubes = 10000;
+    // point lights scattered around the model, their clustering time is recorded with every frame
+    size_t lights = 1;
+    // RenderQueue and cube field switches, the JSON gets the queue counters of every run
+    bool sorted = true;
+    bool multi_draw = true;
+    bool instancing = true;
+    bool mixed_field = false;
+    uint32_t width = 1280;
+    uint32_t height = 720;
+    bool window = false;
+    bool model_load = false;
+    bool uniforms = false;
+    std::string model = PROJECT_SOURCE_DIR "resources/nanosuit/nanosuit.obj";
+};
+
+// frames still rendered after the last recorded one, until its timer query result arrives
+static constexpr uint32_t MAX_TAIL_FRAMES = 16;
+
+struct Percentiles {
+    double p50 = 0.0;
+    double p95 = 0.0;
+    double p99 = 0.0;
+    double max = 0.0;
+    double mean = 0.0;
+};
+
+// nearest rank
+static Percentiles get_percentiles(std::vector<double> values) {
+    Percentiles res;
+    if (values.empty()) {
+        return res;
+    }
+    std::sort(values.begin(), values.end());
+    auto rank = [&values](const double p) {
+        const auto index = static_cast<size_t>(std::ceil(p / 100.0 * values.size()));
+        return values[std::clamp<size_t>(index, 1, values.size()) - 1];
+    };
+    res.p50 = rank(50.0);
+    res.p95 = rank(95.0);
+    res.p99 = rank(99.0);
+    res.max = values.back();
+    for (auto value : values) {
+        res.mean += value;
+    }
+    res.mean /= values.size();
+    return res;
+}
+
+static std::string to_json(Percentiles const& stats) {
+    return std::format("{{ \"p50\": {:.4f}, \"p95\": {:.4f}, \"p99\": {:.4f}, \"max\": {:.4f}, \"mean\": {:.4f} }}",
+        stats.p50, stats.p95, stats.p99, stats.max, stats.mean);
+}
+
+static std::string escape_json(std::string const& str) {
+    std::string res;
+    for (char c : str) {
+        if (c == '"' || c == '\\') {
+            res += '\\';
+        }
+        res += c;
+    }
+    return res;
+}
+
+class FrameBench : public EngineCore::Application {
+public:
+    FrameBench(EngineCore::CameraPath path, BenchOptions const& options)
+        : m_path(std::move(path)), m_options(options)
+    {
+        m_recorded_frames = static_cast<uint32_t>(std::floor(m_path.get_duration() * m_options.fps)) + 1;
+    }
+
+    void init() override {
+        Application::init();
+        camera.set_far_plane(100.f);
+        camera.set_near_plane(0.1f);
+        camera.set_field_of_view(glm::radians(80.f));
+        m_background_color[0] = 0.345f;
+        m_background_color[1] = 0.510f;
+        m_background_color[2] = 0.510f;
+        m_background_color[3] = 0.f;
+        cube_field_count = m_options.cubes;
+        sorted_submission = m_options.sorted;
+        multi_draw_indirect = m_options.multi_draw;
+        instanced_drawing = m_options.instancing;
+        mixed_cube_field = m_options.mixed_field;
+        set_lights(m_options.lights);
+        m_path.apply(0.f, camera);
+    }
+
+    void on_update() override {
+        const auto now = std::chrono::steady_clock::now();
+        const double frame_ms = std::chrono::duration<double, std::milli>(now - m_last_update).count();
+        m_last_update = now;
+        if (is_loading()) {
+            return;
+        }
+
+        if (m_frame >= m_options.warmup && m_samples.size() < m_recorded_frames) {
+            m_samples.push_back({ get_frame_index(), get_cpu_frame_ms(), frame_ms, get_light_binning_ms(), get_render_frame_stats(), get_render_queue_stats() });
+        }
+        ++m_frame;
+
+        if (m_samples.size() == m_recorded_frames) {
+            const bool gpu_done = !has_gpu_timer() || m_gpu_ms.count(m_samples.back().frame_index) != 0;
+            if (gpu_done || ++m_tail_frames > MAX_TAIL_FRAMES) {
+                close();
+            }
+        }
+
+        // the pose for the next frame, warmup frames stay at the start
+        const uint32_t step = m_frame > m_options.warmup ? m_frame - m_options.warmup : 0;
+        m_path.apply(static_cast<float>(step) / m_options.fps, camera);
+    }
+
+    void on_gpu_frame_time(const uint64_t frame_index, const double ms) override {
+        m_gpu_ms[frame_index] = ms;
+    }
+
+    bool write_results() const {
+        std::vector<double> cpu, frame, gpu, light_binning;
+        for (auto const& sample : m_samples) {
+            cpu.push_back(sample.cpu_ms);
+            frame.push_back(sample.frame_ms);
+            light_binning.push_back(sample.light_binning_ms);
+            const auto it = m_gpu_ms.find(sample.frame_index);
+            if (it != m_gpu_ms.end()) {
+                gpu.push_back(it->second);
+            }
+        }
+
+        const auto cpu_stats = get_percentiles(cpu);
+        const auto frame_stats = get_percentiles(frame);
+        const auto gpu_stats = get_percentiles(gpu);
+        const auto light_binning_stats = get_percentiles(light_binning);
+
+        std::string json = "{\n";
+        json += std::format("  \"path\": \"{}\",\n", escape_json(m_options.path));
+        json += std::format("  \"width\": {}, \"height\": {}, \"cubes\": {}, \"lights\": {}, \"fps\": {}, \"warmup\": {},\n",
+            m_options.width, m_options.height, m_options.cubes, point_lights.size(), m_options.fps, m_options.warmup);
+        json += std::format("  \"frames\": {}, \"gpu_frames\": {},\n", m_samples.size(), gpu.size());
+        json += std::format("  \"cpu_ms\": {},\n", to_json(cpu_stats));
+        json += std::format("  \"frame_ms\": {},\n", to_json(frame_stats));
+        json += std::format("  \"light_binning_ms\": {},\n", to_json(light_binning_stats));
+        json += std::format("  \"render_queue\": {},\n", get_render_queue_json());
+        json += std::format("  \"gpu_ms\": {}\n", gpu.empty() ? std::string("null") : to_json(gpu_stats));
+        json += "}\n";
+
+        std::ofstream out(m_options.out, std::ios::trunc);
+        out << json;
+        if (!out.good()) {
+            std::fputs(std::format("failed to write '{}'\n", m_options.out).c_str(), stderr);
+            return false;
+        }
+
+        // the engine logs compile out of release builds, results go straight to stdout
+        std::puts(std::format("{} frames, ms p50 / p95 / p99 / max", m_samples.size()).c_str());
+        std::puts(std::format("  cpu   {:8.3f} {:8.3f} {:8.3f} {:8.3f}", cpu_stats.p50, cpu_stats.p95, cpu_stats.p99, cpu_stats.max).c_str());
+        std::puts(std::format("  frame {:8.3f} {:8.3f} {:8.3f} {:8.3f}", frame_stats.p50, frame_stats.p95, frame_stats.p99, frame_stats.max).c_str());
+        if (!gpu.empty()) {
+            std::puts(std::format("  gpu   {:8.3f} {:8.3f} {:8.3f} {:8.3f}", gpu_stats.p50, gpu_stats.p95, gpu_stats.p99, gpu_stats.max).c_str());
+        }
+        std::puts(std::format("  light {:8.3f} {:8.3f} {:8.3f} {:8.3f}  binning {} lights",
+            light_binning_stats.p50, light_binning_stats.p95, light_binning_stats.p99, light_binning_stats.max, point_lights.size()).c_str());
+        const auto queue = get_render_queue_totals();
+        const double frames = std::max<double>(static_cast<double>(m_samples.size()), 1.0);
+        std::puts(std::format("  queue {:.1f} commands, {:.1f} binds saved per frame ({}, {})", queue.commands / frames,
+            queue.get_binds_saved() / frames, m_options.sorted ? "sorted" : "unsorted", m_options.multi_draw ? "multi-draw" : "no multi-draw").c_str());
+        std::puts(std::format("written to {}", m_options.out).c_str());
+        return m_samples.size() == m_recorded_frames;
+    }
+
+    bool write_stats_csv(std::string const& path) const {
+        std::ofstream out(path, std::ios::trunc);
+        EngineCore::write_csv_header(out);
+        for (auto const& sample : m_samples) {
+            const auto it = m_gpu_ms.find(sample.frame_index);
+            EngineCore::write_csv_row(out, sample.render_stats, sample.cpu_ms, it != m_gpu_ms.end() ? it->second : 0.0);
+        }
+        if (!out.good()) {
+            std::fputs(std::format("failed to write '{}'\n", path).c_str(), stderr);
+            return false;
+        }
+        return true;
+    }
+
+private:
+    EngineCore::RenderQueueStats get_render_queue_totals() const {
+        EngineCore::RenderQueueStats res;
+        for (auto const& sample : m_samples) {
+            auto const& cur = sample.queue_stats;
+            res.commands += cur.commands;
+            res.program_binds += cur.program_binds;
+            res.program_binds_saved += cur.program_binds_saved;
+            res.material_binds += cur.material_binds;
+            res.material_binds_saved += cur.material_binds_saved;
+            res.vertex_array_binds += cur.vertex_array_binds;
+            res.vertex_array_binds_saved += cur.vertex_array_binds_saved;
+            res.multi_draw_batches += cur.multi_draw_batches;
+            res.multi_draw_commands += cur.multi_draw_commands;
+        }
+        return res;
+    }
+
+    // RenderQueueStats per recorded frame, averaged
+    std::string get_render_queue_json() const {
+        const auto totals = get_render_queue_totals();
+        const double frames = std::max<double>(static_cast<double>(m_samples.size()), 1.0);
+        std::string res = std::format("{{ \"sorted\": {}, \"multi_draw_indirect\": {}, \"instancing\": {}, \"mixed_field\": {}, ",
+            m_options.sorted, m_options.multi_draw, m_options.instancing, m_options.mixed_field);
+        res += std::format("\"commands\": {:.1f}, \"binds_saved\": {:.1f}, ", totals.commands / frames, totals.get_binds_saved() / frames);
+        res += std::format("\"program_binds\": {:.1f}, \"program_binds_saved\": {:.1f}, ", totals.program_binds / frames, totals.program_binds_saved / frames);
+        res += std::format("\"material_binds\": {:.1f}, \"material_binds_saved\": {:.1f}, ", totals.material_binds / frames, totals.material_binds_saved / frames);
+        res += std::format("\"vertex_array_binds\": {:.1f}, \"vertex_array_binds_saved\": {:.1f}, ", totals.vertex_array_binds / frames, totals.vertex_array_binds_saved / frames);
+        res += std::format("\"multi_draw_batches\": {:.1f}, \"multi_draw_commands\": {:.1f} }}", totals.multi_draw_batches / frames, totals.multi_draw_commands / frames);
+        return res;
+    }
+
+    // the editor's light benchmark scene: small lights scattered around the model, the same for every run
+    void set_lights(const size_t count) {
+        if (count <= 1) {
+            return;
+        }
+
+        std::mt19937 rng(1337);
+        std::uniform_real_distribution<float> pos_xy(-30.f, 30.f);
+        std::uniform_real_distribution<float> pos_z(-2.f, 18.f);
+        std::uniform_real_distribution<float> color(0.2f, 1.f);
+
+        point_lights.clear();
+        point_lights.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            PointLight light;
+            light.position = { pos_xy(rng), pos_xy(rng), pos_z(rng) };
+            light.ambient = glm::vec3(0.f);
+            light.diffuse = { color(rng), color(rng), color(rng) };
+            light.specular = light.diffuse;
+            light.intensity = 1.f;
+            light.linear = 0.7f;
+            light.quadro = 1.8f;
+            point_lights.push_back(light);
+        }
+    }
+
+    struct Sample {
+        uint64_t frame_index;
+        // engine frame loop without the swap, and the whole frame between two on_update calls
+        double cpu_ms;
+        double frame_ms;
+        // clustering of point_lights, 0 with clustered_lighting off
+        double light_binning_ms;
+        EngineCore::RenderFrameStats render_stats;
+        EngineCore::RenderQueueStats queue_stats;
+    };
+
+    EngineCore::CameraPath m_path;
+    BenchOptions m_options;
+    uint32_t m_recorded_frames = 0;
+    uint32_t m_frame = 0;
+    uint32_t m_tail_frames = 0;
+    std::chrono::steady_clock::time_point m_last_update = std::chrono::steady_clock::now();
+    std::vector<Sample> m_samples;
+    std::unordered_map<uint64_t, double> m_gpu_ms;
+};
+
+// Loads the model in init(), before the scene of run() is created, and closes the application right away.
+// Every pass deletes the cooked cache, loads the model (import + cache write) and loads it again from the cache;
+// the best time of each is reported. Textures come from the same files both times, the models are destroyed
+// between loads so TextureCache holds nothing over.
+class ModelLoadBench : public EngineCore::Application {
+public:
+    static constexpr uint32_t PASSES = 3;
+
+    ModelLoadBench(BenchOptions const& options)
+        : m_options(options)
+    {
+    }
+
+    void init() override {
+        const std::string cache = EngineCore::ModelCache::cache_path(m_options.model);
+        m_cold_ms = m_warm_ms = std::numeric_limits<double>::max();
+        m_valid = true;
+        for (uint32_t pass = 0; pass < PASSES && m_valid; ++pass) {
+            std::error_code ec;
+            std::filesystem::remove(cache, ec);
+            m_cold_ms = std::min(m_cold_ms, load_ms());
+            if (!std::filesystem::exists(cache, ec)) {
+                std::fputs(std::format("'{}' wasn't written by the cold load\n", cache).c_str(), stderr);
+                m_valid = false;
+            }
+            m_warm_ms = std::min(m_warm_ms, load_ms());
+        }
+        close();
+    }
+
+    bool write_results() const {
+        if (!m_valid) {
+            return false;
+        }
+        std::string json = "{\n";
+        json += std::format("  \"model\": \"{}\",\n", escape_json(m_options.model));
+        json += std::format("  \"passes\": {}, \"cold_ms\": {:.4f}, \"warm_ms\": {:.4f}\n", PASSES, m_cold_ms, m_warm_ms);
+        json += "}\n";
+
+        std::ofstream out(m_options.out, std::ios::trunc);
+        out << json;
+        if (!out.good()) {
+            std::fputs(std::format("failed to write '{}'\n", m_options.out).c_str(), stderr);
+            return false;
+        }
+
+        std::puts(std::format("{}, best of {} passes", m_options.model, PASSES).c_str());
+        std::puts(std::format("  cold (import)  {:10.3f} ms", m_cold_ms).c_str());
+        std::puts(std::format("  warm (cooked)  {:10.3f} ms  x{:.2f}", m_warm_ms, m_cold_ms / m_warm_ms).c_str());
+        std::puts(std::format("written to {}", m_options.out).c_str());
+        return true;
+    }
+
+private:
+    double load_ms() {
+        const auto start = std::chrono::steady_clock::now();
+        EngineCore::Model model(m_options.model.c_str());
+        const double res = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (!model.is_loaded()) {
+            std::fputs(std::format("can't load model '{}'\n", m_options.model).c_str(), stderr);
+            m_valid = false;
+        }
+        return res;
+    }
+
+    BenchOptions m_options;
+    double m_cold_ms = 0.0;
+    double m_warm_ms = 0.0;
+    bool m_valid = false;
+};
+
+// The per-frame light upload as it was before lights moved into a storage buffer: every field of 32 lights
+// set by name, the name built with std::format and passed to glGetUniformLocation like the old set_* did.
+// Compared with the same upload through the reflected name table and through handles resolved once.
+// Runs in init() with the program bound and closes the application right away.
+class UniformBench : public EngineCore::Application {
+public:
+    static constexpr uint32_t LIGHTS = 32;
+    static constexpr uint32_t FRAMES = 1000;
+    static constexpr uint32_t PASSES = 5;
+
+    void init() override {
+        using EngineCore::ShaderProgram;
+
+        ShaderProgram program(PROJECT_SOURCE_DIR "resources/bench/uniform_lights.vert", PROJECT_SOURCE_DIR "resources/bench/uniform_lights.frag");
+        if (!program.is_compiled()) {
+            std::fputs("can't compile resources/bench/uniform_lights\n", stderr);
+            close();
+            return;
+        }
+        program.bind();
+        point_lights.assign(LIGHTS, {});
+        for (uint32_t i = 0; i < LIGHTS; ++i) {
+            point_lights[i].position = glm::vec3(static_cast<float>(i), 1.f, -static_cast<float>(i));
+        }
+        const glm::mat4 view_matrix = camera.get_view_matrix();
+
+        const GLuint program_id = program.get_id();
+        auto location = [program_id](std::string const& name) {
+            return glGetUniformLocation(program_id, name.c_str());
+        };
+        auto set_vec3 = [&location](std::string const& name, const glm::vec3& vec) {
+            glUniform3f(location(name), vec.x, vec.y, vec.z);
+        };
+        const double by_location = best_pass_ms([&]() {
+            glUniform1ui(location("PLA.size"), LIGHTS);
+            for (uint32_t i = 0; i < LIGHTS; ++i) {
+                auto name = std::format("PLA.pnts[{}]", i);
+                const auto& cur = point_lights[i];
+                set_vec3(name + ".position_eye", glm::vec3(view_matrix * glm::vec4(cur.position, 1.f)));
+                set_vec3(name + ".ambient", cur.ambient);
+                set_vec3(name + ".diffuse", cur.diffuse);
+                set_vec3(name + ".specular", cur.specular);
+                glUniform1f(location(name + ".shininess"), cur.shininess);
+                glUniform1f(location(name + ".linear"), cur.linear);
+                glUniform1f(location(name + ".quadro"), cur.quadro);
+                glUniform1f(location(name + ".intensity"), cur.intensity);
+            }
+        });
+
+        const double by_name = best_pass_ms([&]() {
+            program.set_uint("PLA.size", LIGHTS);
+            for (uint32_t i = 0; i < LIGHTS; ++i) {
+                auto name = std::format("PLA.pnts[{}]", i);
+                const auto& cur = point_lights[i];
+                program.set_vec3((name + ".position_eye").c_str(), glm::vec3(view_matrix * glm::vec4(cur.position, 1.f)));
+                program.set_vec3((name + ".ambient").c_str(), cur.ambient);
+                program.set_vec3((name + ".diffuse").c_str(), cur.diffuse);
+                program.set_vec3((name + ".specular").c_str(), cur.specular);
+                program.set_float((name + ".shininess").c_str(), cur.shininess);
+                program.set_float((name + ".linear").c_str(), cur.linear);
+                program.set_float((name + ".quadro").c_str(), cur.quadro);
+                program.set_float((name + ".intensity").c_str(), cur.intensity);
+            }
+        });
+
+        struct LightUniforms {
+            ShaderProgram::Uniform<glm::vec3> position_eye, ambient, diffuse, specular;
+            ShaderProgram::Uniform<float> shininess, linear, quadro, intensity;
+        };
+        ShaderProgram::Uniform<unsigned int> size;
+        LightUniforms lights[LIGHTS];
+        const double resolve = best_pass_ms([&]() {
+            size = program.get_uniform<unsigned int>("PLA.size");
+            for (uint32_t i = 0; i < LIGHTS; ++i) {
+                auto name = std::format("PLA.pnts[{}]", i);
+                auto& res = lights[i];
+                res.position_eye = program.get_uniform<glm::vec3>((name + ".position_eye").c_str());
+                res.ambient = program.get_uniform<glm::vec3>((name + ".ambient").c_str());
+                res.diffuse = program.get_uniform<glm::vec3>((name + ".diffuse").c_str());
+                res.specular = program.get_uniform<glm::vec3>((name + ".specular").c_str());
+                res.shininess = program.get_uniform<float>((name + ".shininess").c_str());
+                res.linear = program.get_uniform<float>((name + ".linear").c_str());
+                res.quadro = program.get_uniform<float>((name + ".quadro").c_str());
+                res.intensity = program.get_uniform<float>((name + ".intensity").c_str());
+            }
+        });
+        m_valid = size.is_valid() && lights[LIGHTS - 1].intensity.is_valid();
+
+        const double by_handle = best_pass_ms([&]() {
+            program.set(size, LIGHTS);
+            for (uint32_t i = 0; i < LIGHTS; ++i) {
+                const auto& cur = point_lights[i];
+                const auto& uniforms = lights[i];
+                program.set(uniforms.position_eye, glm::vec3(view_matrix * glm::vec4(cur.position, 1.f)));
+                program.set(uniforms.ambient, cur.ambient);
+                program.set(uniforms.diffuse, cur.diffuse);
+                program.set(uniforms.specular, cur.specular);
+                program.set(uniforms.shininess, cur.shininess);
+                program.set(uniforms.linear, cur.linear);
+                program.set(uniforms.quadro, cur.quadro);
+                program.set(uniforms.intensity, cur.intensity);
+            }
+        });
+
+        // the engine logs compile out of release builds, results go straight to stdout
+        std::puts(std::format("{} lights, best of {} passes, us per frame", LIGHTS, PASSES).c_str());
+        std::puts(std::format("  glGetUniformLocation  {:9.3f}", by_location * 1000.0 / FRAMES).c_str());
+        std::puts(std::format("  reflected table       {:9.3f}  x{:.2f}", by_name * 1000.0 / FRAMES, by_name > 0.0 ? by_location / by_name : 0.0).c_str());
+        std::puts(std::format("  Uniform<T> handles    {:9.3f}  x{:.2f}", by_handle * 1000.0 / FRAMES, by_handle > 0.0 ? by_location / by_handle : 0.0).c_str());
+        std::puts(std::format("  resolving handles     {:9.3f}  once per program", resolve * 1000.0 / FRAMES).c_str());
+        if (!m_valid) {
+            std::fputs("PLA uniforms are not active in resources/bench/uniform_lights.frag\n", stderr);
+        }
+        close();
+    }
+
+    bool is_valid() const {
+        return m_valid;
+    }
+
+private:
+    // FRAMES uploads per pass, glFinish keeps the driver's queued work out of the next pass
+    template<class Upload>
+    static double best_pass_ms(Upload&& upload) {
+        double best = 0.0;
+        for (uint32_t pass = 0; pass < PASSES; ++pass) {
+            glFinish();
+            const auto start = std::chrono::steady_clock::now();
+            for (uint32_t frame = 0; frame < FRAMES; ++frame) {
+                upload();
+            }
+            const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            best = pass == 0 ? ms : std::min(best, ms);
+        }
+        return best;
+    }
+
+    bool m_valid = false;
+};
+
+static int print_usage() {
+    std::fputs("usage: bench [--path file.campath] [--out result.json] [--fps n] [--warmup n] [--cubes n] [--lights n] [--size WxH] [--window] [--trace trace.json] [--stats-csv stats.csv]\n"
+        "             [--unsorted] [--no-mdi] [--no-instancing] [--mixed-field]\n"
+        "       bench --model-load [--model file] [--out result.json]\n"
+        "       bench --uniforms\n", stderr);
+    return 2;
+}
+
+int main(int argc, char** argv) {
+    BenchOptions options;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (std::strcmp(arg, "--path") == 0 && has_value) {
+            options.path = argv[++i];
+        }
+        else if (std::strcmp(arg, "--out") == 0 && has_value) {
+            options.out = argv[++i];
+        }
+        else if (std::strcmp(arg, "--fps") == 0 && has_value) {
+            options.fps = static_cast<uint32_t>(std::max(std::atoi(argv[++i]), 1));
+        }
+        else if (std::strcmp(arg, "--warmup") == 0 && has_value) {
+            options.warmup = static_cast<uint32_t>(std::max(std::atoi(argv[++i]), 0));
+        }
+        else if (std::strcmp(arg, "--cubes") == 0 && has_value) {
+            options.cubes = static_cast<size_t>(std::max(std::atoll(argv[++i]), 0ll));
+        }
+        else if (std::strcmp(arg, "--lights") == 0 && has_value) {
+            options.lights = static_cast<size_t>(std::max(std::atoll(argv[++i]), 1ll));
+        }
+        else if (std::strcmp(arg, "--size") == 0 && has_value) {
+            if (std::sscanf(argv[++i], "%ux%u", &options.width, &options.height) != 2 || options.width == 0 || options.height == 0) {
+                return print_usage();
+            }
+        }
+        else if (std::strcmp(arg, "--trace") == 0 && has_value) {
+            options.trace = argv[++i];
+        }
+        else if (std::strcmp(arg, "--stats-csv") == 0 && has_value) {
+            options.stats_csv = argv[++i];
+        }
+        else if (std::strcmp(arg, "--window") == 0) {
+            options.window = true;
+        }
+        else if (std::strcmp(arg, "--unsorted") == 0) {
+            options.sorted = false;
+        }
+        else if (std::strcmp(arg, "--no-mdi") == 0) {
+            options.multi_draw = false;
+        }
+        else if (std::strcmp(arg, "--no-instancing") == 0) {
+            options.instancing = false;
+        }
+        else if (std::strcmp(arg, "--mixed-field") == 0) {
+            options.mixed_field = true;
+        }
+        else if (std::strcmp(arg, "--model-load") == 0) {
+            options.model_load = true;
+        }
+        else if (std::strcmp(arg, "--model") == 0 && has_value) {
+            options.model = argv[++i];
+        }
+        else if (std::strcmp(arg, "--uniforms") == 0) {
+            options.uniforms = true;
+        }
+        else {
+            return print_usage();
+        }
+    }
+
+    if (options.model_load) {
+        // init() closes the application before its first frame
+        ModelLoadBench bench(options);
+        const int res = bench.start_headless(options.width, options.height, EngineCore::Application::HeadlessOptions{});
+        if (res != 0) {
+            return res;
+        }
+        return bench.write_results() ? 0 : 1;
+    }
+
+    if (options.uniforms) {
+        UniformBench bench;
+        const int res = bench.start_headless(options.width, options.height, EngineCore::Application::HeadlessOptions{});
+        if (res != 0) {
+            return res;
+        }
+        return bench.is_valid() ? 0 : 1;
+    }
+
+    EngineCore::CameraPath path;
+    if (!path.load(options.path)) {
+        std::fputs(std::format("can't load camera path '{}'\n", options.path).c_str(), stderr);
+        return 1;
+    }
+
+    FrameBench bench(std::move(path), options);
+    int res = 0;
+    if (options.window) {
+        res = bench.start(options.width, options.height, "bench");
+    }
+    else {
+        // the bench closes itself once every frame is recorded
+        EngineCore::Application::HeadlessOptions headless;
+        headless.frame_count = std::numeric_limits<uint32_t>::max();
+        headless.wait_for_assets = false;
+        res = bench.start_headless(options.width, options.height, headless);
+    }
+    if (res != 0) {
+        return res;
+    }
+    if (!options.trace.empty() && !EngineCore::Profiler::write_chrome_trace(options.trace)) {
+        return 1;
+    }
+    if (!options.stats_csv.empty() && !bench.write_stats_csv(options.stats_csv)) {
+        return 1;
+    }
+    return bench.write_results() ? 0 : 1;
+}
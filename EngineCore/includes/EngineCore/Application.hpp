@@ -3,8 +3,12 @@
 #include "glm/vec3.hpp"
 #include "EngineCore/Event.hpp"
 #include "EngineCore/Camera.hpp"
+#include "EngineCore/Bounds.hpp"
+#include "EngineCore/RenderStats.hpp"
 
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace EngineCore {
 
@@ -23,16 +27,38 @@ namespace EngineCore {
 
 		Application& operator=(Application&&) = delete;
 
-		virtual void init() {};
+		// called once the context exists, before the scene is loaded; the default adds one point light
+		virtual void init() { point_lights.assign(1, {}); };
 
+		// start() or start_headless() runs once per process, the GL singletons live as long as the first context
 		virtual int start(size_t WINDOW_WIDTH, size_t WINDOW_HEIGHT, const char* title);
 
+		struct HeadlessOptions {
+			uint32_t frame_count = 100;
+			// every 'dump_interval'-th frame is written to 'dump_directory' as frame_NNNNN.tga, 0 writes none
+			uint32_t dump_interval = 0;
+			std::string dump_directory = ".";
+			// frames rendered while models are still loading are not counted
+			bool wait_for_assets = true;
+		};
+
+		// renders 'frame_count' frames into an offscreen framebuffer and returns, no window is shown
+		// and on_UI_update() is not called; returns non zero when the context or a dump failed
+		virtual int start_headless(size_t WIDTH, size_t HEIGHT, HeadlessOptions const& options);
+
+		bool is_headless() const { return m_headless != nullptr; }
+		// frames counted by the headless run so far
+		uint32_t get_headless_frame() const { return m_headless_frame; }
+
 		virtual void on_update() {};
 
 		virtual void on_UI_update() {};
 
 		virtual void on_mouse_key_activity(const MouseKeyCode key_code, const float x, const float y, const bool pressed) {};
 
+		// GPU time of frame 'frame_index' (see get_frame_index()), delivered a few frames after it was recorded
+		virtual void on_gpu_frame_time(const uint64_t frame_index, const double ms) {};
+
 		glm::vec2 get_current_mouse_position() const;
 
 		void set_title(const char* title) const;
@@ -58,11 +84,72 @@ namespace EngineCore {
 
 		std::vector<PointLight> point_lights;
 
+		// LOG_* calls are queued and written by a background thread while the application runs,
+		// off writes every message on the thread that logs it; read when start() is called
+		bool async_logging = true;
+
+		// bin point lights into view-space clusters, otherwise every fragment loops over all lights
+		bool clustered_lighting = true;
+
+		double get_light_binning_ms() const { return m_light_binning_ms; }
+
+		// meshes drawn and rejected by frustum culling during the last frame
+		const CullingStats& get_culling_stats() const { return m_culling_stats; }
+
+		// grid of cubes drawn with one instanced call, or with a draw call per cube when instancing is off
+		size_t cube_field_count = 0;
+		bool instanced_drawing = true;
+		// every other cube is replaced by a soldier of the same size: many meshes over a few materials, with
+		// scene order alternating programs and materials; such a field is always drawn one mesh at a time
+		bool mixed_cube_field = false;
+		// pick simplified meshes by projected error, 'lod_error_pixels' is the error allowed on screen
+		bool lod_enabled = true;
+		float lod_error_pixels = 1.f;
+
+		size_t get_visible_cube_count() const { return m_visible_cube_count; }
+		size_t get_draw_call_count() const { return m_draw_call_count; }
+		// frame loop time on the CPU, without the buffer swap
+		double get_cpu_frame_ms() const { return m_cpu_frame_ms; }
+		// latest GPU frame time from timer queries, 0 when the context has none
+		double get_gpu_frame_ms() const { return m_gpu_frame_ms; }
+		bool has_gpu_timer() const { return m_has_gpu_timer; }
+		// advanced once at the start of every frame
+		uint64_t get_frame_index() const { return m_frame_index; }
+		// models are still loading in the background
+		bool is_loading() const { return m_loading; }
+
+		// sort queued draws by state before executing them, off keeps scene order
+		bool sorted_submission = true;
+		// merge queued draws with the same state into glMultiDrawElementsIndirect calls
+		bool multi_draw_indirect = true;
+		const RenderQueueStats& get_render_queue_stats() const { return m_render_queue_stats; }
+		const GLStateStats& get_gl_state_stats() const { return m_gl_state_stats; }
+		const MaterialStats& get_material_stats() const { return m_material_stats; }
+		// Renderer_OpenGL counters of the last finished frame
+		const RenderFrameStats& get_render_frame_stats() const { return m_render_frame_stats; }
+
 	private:
 
+		int run(size_t WIDTH, size_t HEIGHT, const char* title);
+
 		std::unique_ptr<class Window> m_pWindow;
+		const HeadlessOptions* m_headless = nullptr;
+		uint32_t m_headless_frame = 0;
 		EventDispatcher m_event_dispatcher;
 		bool m_bCloseWindow = false;
+		double m_light_binning_ms = 0.0;
+		CullingStats m_culling_stats;
+		size_t m_visible_cube_count = 0;
+		size_t m_draw_call_count = 0;
+		double m_cpu_frame_ms = 0.0;
+		double m_gpu_frame_ms = 0.0;
+		bool m_has_gpu_timer = false;
+		uint64_t m_frame_index = 0;
+		bool m_loading = false;
+		RenderQueueStats m_render_queue_stats;
+		GLStateStats m_gl_state_stats;
+		MaterialStats m_material_stats;
+		RenderFrameStats m_render_frame_stats;
 
 	};
 
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <string>
+#include <memory>
+#include <atomic>
+#include <chrono>
+
+#include "EngineCore/Model.hpp"
+#include "EngineCore/Modules/ThreadPool.hpp"
+#include "EngineCore/Modules/BoundedQueue.hpp"
+
+namespace EngineCore {
+
+	// Loads models on a background thread and hands the finished meshes to the render thread.
+	// Handles are usable immediately: an unfinished Model draws a placeholder.
+	class AssetManager {
+	public:
+		using ModelHandle = std::shared_ptr<Model>;
+
+		AssetManager(size_t upload_queue_capacity = 64);
+		~AssetManager();
+
+		AssetManager(AssetManager const&) = delete;
+		AssetManager& operator=(AssetManager const&) = delete;
+
+		ModelHandle load_model_async(std::string path);
+
+		// render thread only: creates GL objects for finished loads until the budget is spent,
+		// at least one upload is done per call so loading always progresses
+		size_t process_uploads(std::chrono::microseconds budget);
+
+		size_t get_pending_count() const { return m_pending_models.load(); }
+
+	private:
+		struct UploadItem {
+			ModelHandle model;
+			std::shared_ptr<ModelData> data;
+			size_t mesh_index;
+		};
+
+		BoundedQueue<UploadItem> m_uploads;
+		ThreadPool m_loader{ 1 };
+		std::atomic<size_t> m_pending_models{ 0 };
+		std::atomic<bool> m_closing{ false };
+	};
+
+}
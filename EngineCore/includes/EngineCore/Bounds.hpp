@@ -0,0 +1,60 @@
+#pragma once 
+
+#include <array>
+#include <span>
+#include <cstddef>
+
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <glm/ext/matrix_float4x4.hpp>
+
+namespace EngineCore {
+
+	struct AABB {
+		glm::vec3 min{ 0.f };
+		glm::vec3 max{ 0.f };
+
+		static AABB from_points(std::span<const glm::vec3> points);
+
+		void merge(const AABB& other);
+		glm::vec3 get_center() const { return (min + max) * 0.5f; }
+		glm::vec3 get_extent() const { return (max - min) * 0.5f; }
+	};
+
+	struct BoundingSphere {
+		glm::vec3 center{ 0.f };
+		float radius = 0.f;
+
+		static BoundingSphere from_aabb(const AABB& box);
+
+		// radius grows by the largest axis scale of 'matrix'
+		BoundingSphere transformed(const glm::mat4& matrix) const;
+	};
+
+	// Six planes (xyz = inward normal, w = distance) in the space the source matrix maps from:
+	// a view-projection matrix gives world-space planes, a model-view-projection gives model-space ones
+	class Frustum {
+	public:
+		enum Plane {
+			Left, Right, Bottom, Top, Near, Far,
+			PlanesCount
+		};
+
+		Frustum() = default;
+		static Frustum from_matrix(const glm::mat4& matrix);
+
+		bool intersects(const BoundingSphere& sphere) const;
+		bool intersects(const AABB& box) const;
+
+		const glm::vec4& get_plane(const Plane plane) const { return m_planes[plane]; }
+
+	private:
+		std::array<glm::vec4, PlanesCount> m_planes{};
+	};
+
+	struct CullingStats {
+		size_t drawn = 0;
+		size_t culled = 0;
+	};
+
+}
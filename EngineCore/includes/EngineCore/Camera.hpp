@@ -4,6 +4,8 @@
 #include <glm/trigonometric.hpp>
 #include <glm/ext/matrix_float4x4.hpp>
 
+#include "EngineCore/Bounds.hpp"
+
 
 namespace EngineCore {
 
@@ -41,6 +43,7 @@ namespace EngineCore {
 		const glm::mat4& get_view_matrix();
 		const glm::mat4& get_projection_matrix() const;
 		glm::mat4 get_view_projection_matrix() const;
+		Frustum get_frustum() const;
 
 		void move_forward(const float delta);
 		void move_right(const float delta);
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <glm/vec3.hpp>
+
+#include <string>
+#include <vector>
+
+namespace EngineCore {
+
+	class Camera;
+
+	// Camera position and rotation keyframes, sampled by time with linear interpolation.
+	// Text file, one keyframe per line: 'time px py pz rx ry rz', '#' starts a comment.
+	class CameraPath {
+	public:
+		struct Keyframe {
+			float time = 0.f;
+			glm::vec3 position{ 0.f };
+			// Camera rotation in degrees, not wrapped so that interpolation keeps turning the same way
+			glm::vec3 rotation{ 0.f };
+		};
+
+		bool load(std::string const& path);
+		bool save(std::string const& path) const;
+
+		// keyframes must come in increasing time order
+		void add_keyframe(Keyframe const& keyframe);
+		// records the current pose of 'camera' at 'time'
+		void add_keyframe(const float time, Camera const& camera);
+		void clear();
+
+		// clamps 'time' to the path
+		Keyframe sample(const float time) const;
+		void apply(const float time, Camera& camera) const;
+
+		bool empty() const { return m_keyframes.empty(); }
+		float get_duration() const { return m_keyframes.empty() ? 0.f : m_keyframes.back().time; }
+		std::vector<Keyframe> const& get_keyframes() const { return m_keyframes; }
+
+	private:
+		std::vector<Keyframe> m_keyframes;
+	};
+
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <span>
+#include <cstdint>
+
+#include <glm/vec3.hpp>
+
+#include "EngineCore/Bounds.hpp"
+
+namespace EngineCore {
+
+	class Camera;
+
+	static constexpr uint32_t MAX_LOD_LEVELS = 4;
+
+	// Picks the coarsest level whose simplification error covers at most 'error_pixels' on screen.
+	// Leaving the current level takes a margin of 'hysteresis' (a fraction of the threshold),
+	// so an object sitting at the threshold does not switch back and forth every frame.
+	struct LodSelector {
+		glm::vec3 camera_position{ 0.f };
+		// pixels covered by one unit at distance one: viewport height / (2 tan(fov / 2)), 0 keeps level 0
+		float projection_scale = 0.f;
+		float error_pixels = 1.f;
+		float hysteresis = 0.25f;
+
+		static LodSelector from_camera(Camera const& camera, const float error_pixels);
+
+		// 'errors' per level relative to the radius the model was built with, 'sphere' in world space;
+		// 'level' is the level of the previous frame and is updated
+		uint32_t select(std::span<const float> errors, BoundingSphere const& sphere, uint8_t& level) const;
+	};
+
+}
@@ -1,22 +1,201 @@
-#pragma once 
+#pragma once
 
 #include "spdlog/spdlog.h"
 
+#include <array>
+#include <tuple>
+#include <format>
+#include <string>
+#include <algorithm>
+#include <string_view>
+#include <type_traits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
 namespace EngineCore {
-#ifdef _DEBUG 
 
-#define LOG_INFO(...) spdlog::info(__VA_ARGS__)
-#define LOG_WARN(...) spdlog::warn(__VA_ARGS__)
-#define LOG_ERROR(...) spdlog::error(__VA_ARGS__)
-#define LOG_CRITICAL(...) spdlog::critical(__VA_ARGS__)
+	enum class LogLevel : uint8_t {
+		Info,
+		Warn,
+		Error,
+		Critical
+	};
+
+	// rate limits are kept per category
+	enum class LogCategory : uint8_t {
+		General,
+		OpenGL,
+		Assets,
+		Count
+	};
+
+	namespace detail {
+
+		template<class T>
+		concept LogString = std::is_convertible_v<T const&, std::string_view>;
+
+		template<class T>
+		concept LogValue = std::is_arithmetic_v<T> || (std::is_pointer_v<T> && !LogString<T>);
+
+		// arguments of these types are copied into the record and formatted by the flusher,
+		// anything else is formatted on the calling thread
+		template<class T>
+		concept DeferredLogArg = LogString<T> || LogValue<T>;
+
+		template<class T>
+		using LogStored = std::conditional_t<LogString<T>, std::string_view, std::conditional_t<std::is_pointer_v<T>, const void*, T>>;
+
+		// the format string is checked at compile time like with std::format
+		template<class... Args>
+		struct LogFormat {
+			template<class S>
+				requires std::is_convertible_v<S const&, std::string_view>
+			consteval LogFormat(S const& format)
+				: str(format)
+			{
+				(void)std::format_string<Args...>(format);
+			}
+
+			std::string_view str;
+		};
+
+	}
+
+	// LOG_* macros go through Log::write. Until start_async() messages are formatted and written on the
+	// calling thread; after it they are copied into a preallocated lock-free queue and a flusher thread
+	// formats and writes them. Producers never block or allocate: when the queue is full the message is dropped
+	// and counted. Every category has a per-second budget, messages over it are counted and reported as one line.
+	class Log {
+	public:
+		// records in the queue, a power of two
+		static constexpr size_t QUEUE_CAPACITY = 4096;
+		// bytes of copied arguments per record, long strings are truncated
+		static constexpr size_t PAYLOAD_SIZE = 256;
+		static constexpr int64_t RATE_WINDOW_MS = 1000;
+
+		static void start_async();
+		// writes what is queued and joins the flusher, later messages are written synchronously again
+		static void stop_async();
+		static bool is_async();
+		// blocks until every message queued before the call is written
+		static void flush();
+
+		// messages of 'category' written per second, 0 for no limit
+		static void set_rate_limit(const LogCategory category, const uint32_t messages_per_second);
+		static size_t get_dropped_count();
+
+		template<class... Args>
+		static void write(const LogLevel level, const LogCategory category, detail::LogFormat<std::type_identity_t<Args>...> format, Args&&... args) {
+			if (!allow(category)) {
+				return;
+			}
+			if constexpr ((detail::DeferredLogArg<std::remove_cvref_t<Args>> && ...)) {
+				if (is_async()) {
+					Payload payload;
+					encode<std::remove_cvref_t<Args>...>(payload, args...);
+					push(level, format.str, &format_payload<detail::LogStored<std::remove_cvref_t<Args>>...>, payload);
+					return;
+				}
+			}
+			write_message(level, std::vformat(format.str, std::make_format_args(args...)));
+		}
+
+	private:
+		struct Payload {
+			std::array<std::byte, PAYLOAD_SIZE> data;
+			size_t size = 0;
+		};
+
+		using FormatFunction = void(*)(std::string_view format, const std::byte* data, std::string& out);
+
+		static bool allow(const LogCategory category);
+		static void push(const LogLevel level, std::string_view format, FormatFunction format_function, Payload const& payload);
+		static void write_message(const LogLevel level, std::string_view message);
+
+		template<class T>
+		static constexpr size_t get_encoded_size() {
+			return detail::LogString<T> ? sizeof(uint16_t) : sizeof(detail::LogStored<T>);
+		}
+
+		// values first take their fixed size, strings share what is left in argument order
+		template<class... Args>
+		static void encode(Payload& payload, Args const&... args) {
+			static_assert((get_encoded_size<Args>() + ... + 0) <= PAYLOAD_SIZE, "too many log arguments");
+			size_t string_budget = PAYLOAD_SIZE - (get_encoded_size<Args>() + ... + 0);
+			(encode_arg(payload, string_budget, args), ...);
+		}
+
+		template<class T>
+		static void encode_arg(Payload& payload, size_t& string_budget, T const& arg) {
+			if constexpr (detail::LogString<T>) {
+				std::string_view str;
+				if constexpr (std::is_pointer_v<T>) {
+					str = arg != nullptr ? std::string_view(arg) : std::string_view("(null)");
+				}
+				else {
+					str = arg;
+				}
+				const auto length = static_cast<uint16_t>(std::min<size_t>(str.size(), string_budget));
+				string_budget -= length;
+				std::memcpy(payload.data.data() + payload.size, &length, sizeof(length));
+				std::memcpy(payload.data.data() + payload.size + sizeof(length), str.data(), length);
+				payload.size += sizeof(length) + length;
+			}
+			else {
+				const detail::LogStored<T> value = arg;
+				std::memcpy(payload.data.data() + payload.size, &value, sizeof(value));
+				payload.size += sizeof(value);
+			}
+		}
+
+		template<class T>
+		static T decode_arg(const std::byte*& data) {
+			if constexpr (std::is_same_v<T, std::string_view>) {
+				uint16_t length = 0;
+				std::memcpy(&length, data, sizeof(length));
+				const std::string_view res(reinterpret_cast<const char*>(data + sizeof(length)), length);
+				data += sizeof(length) + length;
+				return res;
+			}
+			else {
+				T res;
+				std::memcpy(&res, data, sizeof(res));
+				data += sizeof(res);
+				return res;
+			}
+		}
+
+		// runs on the flusher thread
+		template<class... Stored>
+		static void format_payload(std::string_view format, const std::byte* data, std::string& out) {
+			// braced initialization decodes the arguments in order
+			const std::tuple<Stored...> values{ decode_arg<Stored>(data)... };
+			std::apply([&](auto const&... value) {
+				out = std::vformat(format, std::make_format_args(value...));
+			}, values);
+		}
+	};
+
+#ifdef _DEBUG
+
+#define LOG_CATEGORY_INFO(category, ...) ::EngineCore::Log::write(::EngineCore::LogLevel::Info, ::EngineCore::LogCategory::category, __VA_ARGS__)
+#define LOG_CATEGORY_WARN(category, ...) ::EngineCore::Log::write(::EngineCore::LogLevel::Warn, ::EngineCore::LogCategory::category, __VA_ARGS__)
+#define LOG_CATEGORY_ERROR(category, ...) ::EngineCore::Log::write(::EngineCore::LogLevel::Error, ::EngineCore::LogCategory::category, __VA_ARGS__)
+#define LOG_CATEGORY_CRITICAL(category, ...) ::EngineCore::Log::write(::EngineCore::LogLevel::Critical, ::EngineCore::LogCategory::category, __VA_ARGS__)
+
+#else
 
-#elif 
+#define LOG_CATEGORY_INFO(category, ...)
+#define LOG_CATEGORY_WARN(category, ...)
+#define LOG_CATEGORY_ERROR(category, ...)
+#define LOG_CATEGORY_CRITICAL(category, ...)
 
-#define LOG_INFO(...) 
-#define LOG_WARN(...) 
-#define LOG_ERROR(...)
-#define LOG_CRITICAL(...)
+#endif
 
-#endif 
+#define LOG_INFO(...) LOG_CATEGORY_INFO(General, __VA_ARGS__)
+#define LOG_WARN(...) LOG_CATEGORY_WARN(General, __VA_ARGS__)
+#define LOG_ERROR(...) LOG_CATEGORY_ERROR(General, __VA_ARGS__)
+#define LOG_CRITICAL(...) LOG_CATEGORY_CRITICAL(General, __VA_ARGS__)
 
-}
\ No newline at end of file
+}
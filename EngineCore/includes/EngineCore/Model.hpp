@@ -8,6 +8,9 @@
 #include "EngineCore/Rendering/OpenGL/Texture2D.hpp"
 #include "EngineCore/Rendering/OpenGL/ShaderProgram.hpp"
 #include "EngineCore/Logs.hpp"
+#include "EngineCore/Bounds.hpp"
+#include "EngineCore/Lod.hpp"
+#include "EngineCore/RenderStats.hpp"
 
 struct aiNode;
 struct aiScene;
@@ -17,26 +20,57 @@ enum aiTextureType;
 
 namespace EngineCore {
 
+	struct ModelData;
+	class RenderQueue;
+	class ShaderStorageBuffer;
+
 	class Model {
 	private:
 
 		std::vector<Mesh> meshes;
 		std::string directory;
+		bool m_loaded = false;
+		// bounds of the placeholder cube until the model is loaded
+		AABB m_bounds{ glm::vec3(-0.5f), glm::vec3(0.5f) };
+		BoundingSphere m_bounding_sphere = BoundingSphere::from_aabb(m_bounds);
+		// per level, relative to the bounding radius
+		std::vector<float> m_lod_errors{ 0.f };
+
+		Model() = default;
 
-		void load_model(std::string path);
-		void process_node(aiNode* node, const aiScene* scene);
+		static std::shared_ptr<ModelData> load_data(std::string const& path);
+		static size_t get_mesh_count(ModelData const& data);
+		void upload_mesh(ModelData& data, size_t index);
+		void update_lod_errors();
+
+		static void process_node(aiNode* node, const aiScene* scene, std::vector<aiMesh*>& ai_meshes);
+		static Mesh const& get_placeholder_mesh();
+		void log_memory_stats(ModelData const& data) const;
 
 		Model(Model const&) = delete;
 		auto operator=(Model const&) = delete;
 
+		friend class AssetManager;
+
 	public:
-		Model(const char* path) {
-			load_model(path);
-			LOG_INFO("MODEL LOADED FROM '{}'", path);
-		}
+		Model(const char* path);
+
+		bool is_loaded() const { return m_loaded; }
+
+		const AABB& get_bounds() const { return m_bounds; }
+		const BoundingSphere& get_bounding_sphere() const { return m_bounding_sphere; }
+		ModelMemoryStats get_memory_stats() const;
+
+		uint32_t get_lod_count() const { return static_cast<uint32_t>(m_lod_errors.size()); }
+		// 'level' is the level this instance had in the previous frame, kept for the hysteresis
+		uint32_t select_lod(LodSelector const& selector, const glm::mat4& module, uint8_t& level) const;
+		// 'sphere' is the world space bounding sphere of the instance
+		uint32_t select_lod(LodSelector const& selector, BoundingSphere const& sphere, uint8_t& level) const;
 
-		void draw(ShaderProgram const& shader);
-		void raw_draw(ShaderProgram const& shader);
+		// records the meshes that pass frustum culling into 'queue', RenderQueue::execute() draws them
+		void submit(RenderQueue& queue, ShaderProgram const& shader, const glm::mat4& module, CullingStats& stats, const uint32_t lod = 0);
+		// one command per mesh, the shader reads the transforms of 'instances' at StorageBinding::InstanceTransforms
+		void submit_instanced(RenderQueue& queue, ShaderProgram const& shader, ShaderStorageBuffer const& instances, const uint32_t instance_count, const uint32_t lod = 0);
 	};
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace EngineCore {
+
+	struct ProfileZone {
+		// the string literal given to the PROFILE_* macro, only the pointer is kept
+		const char* name = nullptr;
+		// Profiler::now_ns() clock
+		int64_t start_ns = 0;
+		int64_t end_ns = 0;
+		uint16_t depth = 0;
+		// index into Profiler::get_track_names()
+		uint16_t track = 0;
+	};
+
+	struct ProfileFrame {
+		uint64_t number = 0;
+		int64_t start_ns = 0;
+		int64_t end_ns = 0;
+		// sorted by start; zones of other threads are drained into the frame they ended in
+		std::vector<ProfileZone> zones;
+	};
+
+	// Scoped zones are written to a lock-free ring of the thread that records them (single writer),
+	// the render thread drains every ring at new_frame() into a history of the last frames.
+	// GPU zones use GL_TIMESTAMP queries, they are added to their frame on the "GPU" track
+	// a few frames later, once the queries are available.
+	class Profiler {
+	public:
+		static constexpr size_t HISTORY_FRAMES = 240;
+		// zones per thread between two new_frame() calls, the rest are dropped and counted
+		static constexpr size_t RING_CAPACITY = 16384;
+		// GPU zones of a frame are in the history at the latest this many frames after it
+		static constexpr size_t GPU_FRAMES_IN_FLIGHT = 4;
+
+		static void set_enabled(const bool enabled);
+		static bool is_enabled() {
+			return s_enabled.load(std::memory_order_relaxed);
+		}
+
+		// name of the calling thread in the panel and in traces
+		static void set_thread_name(const char* name);
+
+		// render thread, once per frame: closes the current frame, drains the rings into it,
+		// collects finished GPU zones and opens the next frame
+		static void new_frame();
+		// render thread, before its context goes away
+		static void release_gpu();
+
+		// render thread only; finished frames, oldest first
+		static std::deque<ProfileFrame> const& get_frames();
+		static std::vector<std::string> get_track_names();
+		static size_t get_dropped_zone_count();
+
+		// Chrome trace event format (chrome://tracing, Perfetto) of every frame in the history
+		static bool write_chrome_trace(std::string const& path);
+
+		static int64_t now_ns();
+
+		// used by the scopes below
+		static uint16_t begin_zone();
+		static void end_zone(const char* name, const int64_t start_ns, const uint16_t depth);
+		static bool begin_gpu_zone(const char* name);
+		static void end_gpu_zone();
+
+	private:
+		static std::atomic<bool> s_enabled;
+	};
+
+	class ProfileScope {
+	public:
+		explicit ProfileScope(const char* name)
+			: m_name(name), m_active(Profiler::is_enabled())
+		{
+			if (m_active) {
+				m_depth = Profiler::begin_zone();
+				m_start_ns = Profiler::now_ns();
+			}
+		}
+
+		~ProfileScope() {
+			if (m_active) {
+				Profiler::end_zone(m_name, m_start_ns, m_depth);
+			}
+		}
+
+		ProfileScope(const ProfileScope&) = delete;
+		ProfileScope& operator=(const ProfileScope&) = delete;
+
+	private:
+		const char* m_name;
+		int64_t m_start_ns = 0;
+		uint16_t m_depth = 0;
+		bool m_active;
+	};
+
+	// render thread only, needs the GL context
+	class GpuProfileScope {
+	public:
+		explicit GpuProfileScope(const char* name)
+			: m_active(Profiler::is_enabled() && Profiler::begin_gpu_zone(name))
+		{}
+
+		~GpuProfileScope() {
+			if (m_active) {
+				Profiler::end_gpu_zone();
+			}
+		}
+
+		GpuProfileScope(const GpuProfileScope&) = delete;
+		GpuProfileScope& operator=(const GpuProfileScope&) = delete;
+
+	private:
+		bool m_active;
+	};
+
+}
+
+#ifndef ENGINE_DISABLE_PROFILER
+
+#define PROFILE_CONCAT_IMPL(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_IMPL(a, b)
+
+#define PROFILE_SCOPE(name) ::EngineCore::ProfileScope PROFILE_CONCAT(profile_scope_, __LINE__)(name)
+#define PROFILE_FUNCTION() PROFILE_SCOPE(__func__)
+#define PROFILE_GPU_SCOPE(name) ::EngineCore::GpuProfileScope PROFILE_CONCAT(gpu_profile_scope_, __LINE__)(name)
+
+#else
+
+#define PROFILE_SCOPE(name)
+#define PROFILE_FUNCTION()
+#define PROFILE_GPU_SCOPE(name)
+
+#endif
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <array>
+#include <iosfwd>
+#include <cstddef>
+#include <cstdint>
+
+#include "EngineCore/Lod.hpp"
+
+namespace EngineCore {
+
+	// Counted by Renderer_OpenGL over one frame. Every counter is a plain increment next to the
+	// GL call it counts, so they stay on in release builds.
+	struct RenderFrameStats {
+		uint64_t frame = 0;
+		// glDraw* calls, a multi-draw is one call and 'draws' counts each of its commands
+		size_t draw_calls = 0;
+		size_t draws = 0;
+		// indices submitted, once per instance
+		size_t indices = 0;
+		size_t instances = 0;
+		// binds that reached the driver, the ones GLStateCache dropped are not counted
+		size_t program_binds = 0;
+		size_t vertex_array_binds = 0;
+		size_t texture_binds = 0;
+		size_t uniform_uploads = 0;
+		// glNamedBuffer(Sub)Data calls and StreamBuffer writes
+		size_t buffer_uploads = 0;
+		size_t buffer_bytes = 0;
+		size_t texture_bytes = 0;
+
+		size_t get_triangles() const { return indices / 3; }
+	};
+
+	// one line per frame for offline analysis; times are passed in, GPU time is 0 when unknown
+	void write_csv_header(std::ostream& out);
+	void write_csv_row(std::ostream& out, RenderFrameStats const& stats, const double cpu_ms, const double gpu_ms);
+
+	// state changes done and skipped by RenderQueue::execute during the last frame
+	struct RenderQueueStats {
+		size_t commands = 0;
+
+		size_t program_binds = 0;
+		size_t program_binds_saved = 0;
+		// one bind of the texture arrays per execute; saved counts commands whose material repeats the previous one
+		size_t material_binds = 0;
+		size_t material_binds_saved = 0;
+		size_t vertex_array_binds = 0;
+		size_t vertex_array_binds_saved = 0;
+
+		// runs of commands merged into one glMultiDrawElementsIndirect
+		size_t multi_draw_batches = 0;
+		size_t multi_draw_commands = 0;
+
+		// instances counted once per mesh; 'full_detail_triangles' is what level 0 would have drawn
+		size_t triangles = 0;
+		size_t full_detail_triangles = 0;
+		std::array<size_t, MAX_LOD_LEVELS> lod_instances{};
+
+		size_t get_binds_saved() const { return program_binds_saved + material_binds_saved + vertex_array_binds_saved; }
+	};
+
+	// GL state calls passed to the driver and dropped by the state cache since the last reset
+	struct GLStateStats {
+		size_t issued = 0;
+		size_t skipped = 0;
+	};
+
+	// material entries and the texture arrays holding their layers
+	struct MaterialStats {
+		size_t materials = 0;
+		size_t texture_arrays = 0;
+		size_t layers_used = 0;
+		size_t layers_allocated = 0;
+		size_t gpu_bytes = 0;
+	};
+
+	// MeshPool memory of the meshes of one model, and what they took as 32 byte Vertex and 32 bit indices
+	struct ModelMemoryStats {
+		size_t meshes = 0;
+		size_t vertices = 0;
+		// all levels of detail
+		size_t indices = 0;
+		// meshes with 16 bit indices
+		size_t uint16_meshes = 0;
+		size_t vertex_bytes = 0;
+		size_t index_bytes = 0;
+		size_t unpacked_bytes = 0;
+
+		size_t get_bytes() const { return vertex_bytes + index_bytes; }
+	};
+
+}
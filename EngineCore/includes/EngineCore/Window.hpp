@@ -14,7 +14,9 @@ namespace EngineCore {
 	public:
 		using EventCallbackFn = std::function<void(BaseEvent&)>;
 
-		Window(std::string title, const uint32_t width, const uint32_t height);
+		// a headless window is never shown, it only owns a context (EGL or OSMesa when GLFW
+		// has the null platform) and rendering goes into a Framebuffer; no UI is created for it
+		Window(std::string title, const uint32_t width, const uint32_t height, const bool headless = false);
 
 		~Window();
 
@@ -28,6 +30,10 @@ namespace EngineCore {
 
 		void on_update();
 
+		bool is_headless() const {
+			return m_headless;
+		}
+
 		uint32_t get_width() const {
 			return m_data.width;
 		};
@@ -63,6 +69,7 @@ namespace EngineCore {
 
 		GLFWwindow* m_pWindow = nullptr;
 		WindowData m_data;
+		bool m_headless = false;
 
 	};
 
@@ -9,8 +9,15 @@
 #include <ImGui/imgui.h>
 
 #include <format>
+#include <array>
 #include <vector>
 #include <deque>
+#include <algorithm>
+#include <cstring>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <cassert>
 
 #include "EngineCore/Application.hpp"
 #include "EngineCore/Logs.hpp"
@@ -18,6 +25,8 @@
 #include "EngineCore/Camera.hpp"
 #include "EngineCore/Input.hpp"
 #include "EngineCore/Model.hpp"
+#include "EngineCore/AssetManager.hpp"
+#include "EngineCore/Profiler.hpp"
 
 #include "Rendering/OpenGL/ShaderProgram.hpp"
 #include "Rendering/OpenGL/VertexBuffer.hpp"
@@ -25,17 +34,77 @@
 #include "Rendering/OpenGL/IndexBuffer.hpp"
 #include "Rendering/OpenGL/Texture2D.hpp"
 #include "Rendering/OpenGL/Mesh.hpp"
+#include "Rendering/OpenGL/ShaderStorageBuffer.hpp"
+#include "Rendering/OpenGL/LightClusters.hpp"
+#include "Rendering/OpenGL/RenderQueue.hpp"
+#include "Rendering/OpenGL/MaterialTable.hpp"
+#include "Rendering/OpenGL/Framebuffer.hpp"
+#include "Rendering/OpenGL/GpuTimer.hpp"
 
 #include "Rendering/OpenGL/Renderer_OpenGL.hpp"
+#include "Rendering/OpenGL/GLStateCache.hpp"
 
 #include "Modules/UIModule.hpp"
 #include "Modules/FileRead.hpp"
+#include "Modules/CullingBatch.hpp"
+#include "Modules/TextureFile.hpp"
 
 
 namespace EngineCore {
 
+    static constexpr auto UPLOAD_BUDGET_PER_FRAME = std::chrono::milliseconds(2);
+
 	Application::Application() {
         LOG_INFO("Open Application");
+
+        // registered once, run() only points the window callback at the dispatcher
+        m_event_dispatcher.add_event_listener<EventMouseMoved>(
+            [](EventMouseMoved& event) {}
+        );
+
+        m_event_dispatcher.add_event_listener<EventWindowResize>(
+            [&](EventWindowResize& event) {
+                camera.set_viewport_size(
+                    static_cast<float>(event.w), 
+                    static_cast<float>(event.h)
+                );
+            }
+        );
+
+        m_event_dispatcher.add_event_listener<EventWindowClose>(
+            [&](EventWindowClose& event) {
+                LOG_INFO("[WindowClose] Goodbye!");
+                close();
+            }
+        );
+
+        m_event_dispatcher.add_event_listener<EventKeyPressed>(
+            [](EventKeyPressed& event) {
+                Input::PressKey(static_cast<KeyCode>(event.key_code));
+            }
+        );
+
+        m_event_dispatcher.add_event_listener<EventKeyReleased>(
+            [](EventKeyReleased& event) {
+                Input::ReleaseKey(static_cast<KeyCode>(event.key_code));
+            }
+        );
+
+        m_event_dispatcher.add_event_listener<EventMouseButtonPressed>(
+            [&](EventMouseButtonPressed& event) {
+                Input::PressMouseKey(static_cast<MouseKeyCode>(event.key_code));
+                auto p = get_current_mouse_position();
+                on_mouse_key_activity(static_cast<MouseKeyCode>(event.key_code), p.x, p.y, true);
+            }
+        );
+
+        m_event_dispatcher.add_event_listener<EventMouseButtonReleased>(
+            [&](EventMouseButtonReleased& event) {
+                Input::ReleaseMouseKey(static_cast<MouseKeyCode>(event.key_code));
+                auto p = get_current_mouse_position();
+                on_mouse_key_activity(static_cast<MouseKeyCode>(event.key_code), p.x, p.y, false);
+            }
+        );
     };
 
 	Application::~Application() {
@@ -45,75 +114,78 @@ namespace EngineCore {
 
 
 	int Application::start(size_t WINDOW_WIDTH, size_t WINDOW_HEIGHT, const char* title) {
+        m_headless = nullptr;
+        return run(WINDOW_WIDTH, WINDOW_HEIGHT, title);
+    }
+
+    int Application::start_headless(size_t WIDTH, size_t HEIGHT, HeadlessOptions const& options) {
+        if (options.dump_interval != 0) {
+            std::error_code ec;
+            std::filesystem::create_directories(options.dump_directory, ec);
+        }
+        m_headless = &options;
+        m_headless_frame = 0;
+        const int res = run(WIDTH, HEIGHT, "headless");
+        m_headless = nullptr;
+        return res;
+    }
+
+	int Application::run(size_t WINDOW_WIDTH, size_t WINDOW_HEIGHT, const char* title) {
+
+        // MeshPool, MaterialTable and the placeholder meshes keep the GL objects of the first context
+        // until the process exits, a second run would use them in a context that doesn't own them
+        static bool s_started = false;
+        assert(!s_started && "Application::start() can only be called once per process");
+        if (s_started) {
+            LOG_CRITICAL("Application::start() can only be called once per process");
+            return -1;
+        }
+        s_started = true;
 
-        m_pWindow = std::make_unique<Window>(title, WINDOW_WIDTH, WINDOW_HEIGHT);
+        m_bCloseWindow = false;
+        Profiler::set_thread_name("render");
+        if (async_logging) {
+            Log::start_async();
+        }
+        m_pWindow = std::make_unique<Window>(title, WINDOW_WIDTH, WINDOW_HEIGHT, m_headless != nullptr);
+        if (m_pWindow->get_window_ptr() == nullptr) {
+            m_pWindow = nullptr;
+            Log::stop_async();
+            return -1;
+        }
         camera.set_viewport_size(
             static_cast<float>(WINDOW_WIDTH), 
             static_cast<float>(WINDOW_HEIGHT)
         );
 
-        // Add Events
-        {
-
-            m_event_dispatcher.add_event_listener<EventMouseMoved>(
-                [](EventMouseMoved& event) {}
-            );
-
-            m_event_dispatcher.add_event_listener<EventWindowResize>(
-                [&](EventWindowResize& event) {
-                    camera.set_viewport_size(
-                        static_cast<float>(event.w), 
-                        static_cast<float>(event.h)
-                    );
-                }
-            );
-
-            m_event_dispatcher.add_event_listener<EventWindowClose>(
-                [&](EventWindowClose& event) {
-                    LOG_INFO("[WindowClose] Goodbye!");
-                    close();
-                }
-            );
-
-            m_event_dispatcher.add_event_listener<EventKeyPressed>(
-                [](EventKeyPressed& event) {
-                    Input::PressKey(static_cast<KeyCode>(event.key_code));
-                }
-            );
-
-            m_event_dispatcher.add_event_listener<EventKeyReleased>(
-                [](EventKeyReleased& event) {
-                    Input::ReleaseKey(static_cast<KeyCode>(event.key_code));
-                }
-            );
-
-            m_event_dispatcher.add_event_listener<EventMouseButtonPressed>(
-                [&](EventMouseButtonPressed& event) {
-                    Input::PressMouseKey(static_cast<MouseKeyCode>(event.key_code));
-                    auto p = get_current_mouse_position();
-                    on_mouse_key_activity(static_cast<MouseKeyCode>(event.key_code), p.x, p.y, true);
-                }
-            );
+        m_pWindow->set_event_callback(
+            [&](BaseEvent& event) {
+                m_event_dispatcher.dispatch(event);
+            }
+        );
 
-            m_event_dispatcher.add_event_listener<EventMouseButtonReleased>(
-                [&](EventMouseButtonReleased& event) {
-                    Input::ReleaseMouseKey(static_cast<MouseKeyCode>(event.key_code));
-                    auto p = get_current_mouse_position();
-                    on_mouse_key_activity(static_cast<MouseKeyCode>(event.key_code), p.x, p.y, false);
-                }
-            );
+        Renderer_OpenGL::enable_depth_testing();
 
-            m_pWindow->set_event_callback(
-                [&](BaseEvent& event) {
-                    m_event_dispatcher.dispatch(event);
-                }
-            );
+        // headless frames go here, nothing else binds framebuffers while there is no UI
+        std::unique_ptr<Framebuffer> offscreen;
+        std::vector<uint8_t> frame_pixels;
+        int exit_code = 0;
+        if (m_headless) {
+            offscreen = std::make_unique<Framebuffer>(static_cast<uint32_t>(WINDOW_WIDTH), static_cast<uint32_t>(WINDOW_HEIGHT));
+            if (!offscreen->is_complete()) {
+                m_pWindow = nullptr;
+                Log::stop_async();
+                return -1;
+            }
+            offscreen->bind();
         }
 
-        Renderer_OpenGL::enable_depth_testing();
+        GpuTimer gpu_timer;
+        m_has_gpu_timer = gpu_timer.is_supported();
 
         auto CVSP = PROJECT_SOURCE_DIR "EngineCore/src/EngineCore/Shaders/cube.vert";
         auto CFSP = PROJECT_SOURCE_DIR "EngineCore/src/EngineCore/Shaders/cube.frag";
+        auto CIVSP = PROJECT_SOURCE_DIR "EngineCore/src/EngineCore/Shaders/cube_instanced.vert";
         auto VSP = PROJECT_SOURCE_DIR "EngineCore/src/EngineCore/Shaders/nanosuit.vert";
         auto FSP = PROJECT_SOURCE_DIR "EngineCore/src/EngineCore/Shaders/nanosuit.frag";
         auto MOP = PROJECT_SOURCE_DIR "resources/nanosuit/nanosuit.obj";
@@ -122,106 +194,332 @@ namespace EngineCore {
 
         ShaderProgram NSP(VSP, FSP);
         ShaderProgram CSP(CVSP, CFSP);
+        ShaderProgram CISP(CIVSP, CFSP);
 
 
         init();
 
-        for (int i = 0; i < 1; ++i) {
-            point_lights.push_back({});
-        }
+        AssetManager assets;
 
         struct Entity {
-            Model model;
+            AssetManager::ModelHandle model;
             glm::mat4 module;
+            // level of detail of the previous frame, the selector needs it for hysteresis
+            uint8_t lod = 0;
         };
         
         Entity cube{
-            {CMP},
+            assets.load_model_async(CMP),
             glm::mat4(1.f)
         };
 
         Entity soldier{
-            {MOP},
+            assets.load_model_async(MOP),
             glm::mat4(1.f)
         };
         
 
 
-        auto draw = [&](Entity* en, ShaderProgram const& shd) -> void {
-            auto mvp_matrix = camera.get_view_projection_matrix() * en->module;
-            auto mv_matrix = camera.get_view_matrix() * en->module;
-            auto normal_matrix = glm::mat3(glm::transpose(glm::inverse(glm::mat3(en->module))));
-            
-            shd.bind();
+        // uniform handles are resolved once, the frame loop only uses locations
+        struct ProgramUniforms {
+            ShaderProgram::Uniform<glm::mat4> view_matrix, projection_matrix;
+        };
 
-            shd.set_mat4("module_view_matrix", mv_matrix);
-            shd.set_mat4("mvp_matrix", mvp_matrix);
-            shd.set_mat3("normal_matrix", normal_matrix);
-            
-            en->model.draw(shd);
-            };
+        auto resolve_uniforms = [](ShaderProgram const& SHD) -> ProgramUniforms {
+            ProgramUniforms res;
+            res.view_matrix = SHD.get_uniform<glm::mat4>("view_matrix");
+            res.projection_matrix = SHD.get_uniform<glm::mat4>("projection_matrix");
+            return res;
+        };
+
+        const ProgramUniforms NSP_uniforms = resolve_uniforms(NSP);
+        const ProgramUniforms CSP_uniforms = resolve_uniforms(CSP);
+        const ProgramUniforms CISP_uniforms = resolve_uniforms(CISP);
+        const auto CSP_flag = CSP.get_uniform<int>("flag");
 
-        auto shd_light_uniform = [&](ShaderProgram const& SHD) -> void {
-            SHD.bind();
 
-            SHD.set_float("material.shininess", 32.f);
+        // point lights live in one std430 buffer bound to StorageBinding::PointLights,
+        // every program reads it from there and lights are transformed to eye space in the shader
+        struct PointLightData {
+            glm::vec4 position_intensity;
+            glm::vec4 ambient_shininess;
+            glm::vec4 diffuse_linear;
+            glm::vec4 specular_quadro;
+        };
+
+        struct PointLightBufferHeader {
+            uint32_t count;
+            uint32_t pad[3];
+        };
+
+        ShaderStorageBuffer point_lights_buffer(StorageBinding::PointLights);
+        std::vector<unsigned char> point_lights_packed;
+        std::vector<unsigned char> point_lights_uploaded;
 
-            SHD.set_uint("PLA.size", point_lights.size());
+        auto upload_point_lights = [&]() -> void {
+            point_lights_packed.resize(sizeof(PointLightBufferHeader) + std::max<size_t>(point_lights.size(), 1) * sizeof(PointLightData));
 
-            for (int i = 0; i < point_lights.size(); ++i) {
-                auto name = std::format("PLA.pnts[{}]", i);
+            PointLightBufferHeader header{ static_cast<uint32_t>(point_lights.size()) };
+            std::memcpy(point_lights_packed.data(), &header, sizeof(header));
+
+            auto lights = reinterpret_cast<PointLightData*>(point_lights_packed.data() + sizeof(header));
+            for (size_t i = 0; i < point_lights.size(); ++i) {
                 const auto& cur = point_lights[i];
+                lights[i] = {
+                    glm::vec4(cur.position, cur.intensity),
+                    glm::vec4(cur.ambient, cur.shininess),
+                    glm::vec4(cur.diffuse, cur.linear),
+                    glm::vec4(cur.specular, cur.quadro),
+                };
+            }
+
+            if (point_lights_packed != point_lights_uploaded) {
+                point_lights_buffer.set_data(point_lights_packed.data(), point_lights_packed.size());
+                point_lights_uploaded = point_lights_packed;
+            }
+            point_lights_buffer.bind();
+        };
 
-                auto position_eye = camera.get_view_matrix() * glm::vec4(cur.position, 1.f);
-                SHD.set_vec3((name + ".position_eye").c_str(), glm::vec3(position_eye));
-                SHD.set_vec3((name + ".ambient").c_str(), cur.ambient);
-                SHD.set_vec3((name + ".diffuse").c_str(), cur.diffuse);
-                SHD.set_vec3((name + ".specular").c_str(), cur.specular);
-                SHD.set_float((name + ".shininess").c_str(), cur.shininess);
-                SHD.set_float((name + ".linear").c_str(), cur.linear);
-                SHD.set_float((name + ".quadro").c_str(), cur.quadro);
-                SHD.set_float((name + ".intensity").c_str(), cur.intensity);
+        LightClusters light_clusters;
+        std::vector<LightClusters::Light> cluster_lights;
 
+        auto update_light_clusters = [&]() -> void {
+            cluster_lights.resize(point_lights.size());
+            for (size_t i = 0; i < point_lights.size(); ++i) {
+                const auto& cur = point_lights[i];
+                cluster_lights[i] = { cur.position, LightClusters::light_radius(cur.intensity, cur.linear, cur.quadro) };
             }
+            light_clusters.update(camera.get_view_matrix(), camera, cluster_lights, clustered_lighting);
+            light_clusters.bind();
+            m_light_binning_ms = light_clusters.get_binning_ms();
+        };
 
+        auto shd_frame_uniform = [&](ShaderProgram const& SHD, ProgramUniforms const& uniforms) -> void {
+            SHD.bind();
 
+            SHD.set(uniforms.view_matrix, camera.get_view_matrix());
+            SHD.set(uniforms.projection_matrix, camera.get_projection_matrix());
             };
+
+        RenderQueue queue;
+        // the highlight needs its own 'flag' value, so it is executed separately
+        RenderQueue highlight_queue;
+
+        // cube field: batch-culled on the CPU, then the visible transforms go to the GPU
+        // in one buffer per level of detail, each level is one instanced call
+        std::vector<ShaderStorageBuffer> instance_transforms_buffers;
+        std::array<std::vector<glm::mat4>, MAX_LOD_LEVELS> field_visible_modules;
+        for (uint32_t i = 0; i < MAX_LOD_LEVELS; ++i) {
+            instance_transforms_buffers.emplace_back(StorageBinding::InstanceTransforms, ShaderStorageBuffer::EUsage::Stream);
+        }
+        struct FieldEntry {
+            Model* model;
+            ShaderProgram const* program;
+        };
+        std::vector<glm::mat4> field_modules;
+        std::vector<FieldEntry> field_entries;
+        std::vector<uint8_t> field_lods;
+        std::vector<uint32_t> field_visible;
+        CullingBatch field_bounds;
+        // the bounds change when a model finishes loading, the field is rebuilt then
+        auto get_field_state = [&]() -> int {
+            return int(cube.model->is_loaded()) | int(soldier.model->is_loaded()) << 1 | int(mixed_cube_field) << 2;
+        };
+        int field_built_state = -1;
+
+        auto build_cube_field = [&]() -> void {
+            static constexpr float scale = 0.05f;
+            static constexpr float spacing = 2.f;
+
+            field_modules.clear();
+            field_entries.clear();
+            field_bounds.clear();
+            field_modules.reserve(cube_field_count);
+            field_entries.reserve(cube_field_count);
+            field_bounds.reserve(cube_field_count);
+            field_lods.assign(cube_field_count, 0);
+
+            const auto side = std::max<size_t>(static_cast<size_t>(std::ceil(std::cbrt(static_cast<double>(cube_field_count)))), 1);
+            const BoundingSphere cube_local = cube.model->get_bounding_sphere();
+            const BoundingSphere soldier_local = soldier.model->get_bounding_sphere();
+            for (size_t i = 0; i < cube_field_count; ++i) {
+                const bool is_soldier = mixed_cube_field && i % 2 == 1;
+                const BoundingSphere& local = is_soldier ? soldier_local : cube_local;
+                // soldiers are shrunk to the size of a cube
+                const float entry_scale = is_soldier ? scale * cube_local.radius / soldier_local.radius : scale;
+                const glm::vec3 offset(
+                    5.f + spacing * static_cast<float>(i % side),
+                    spacing * static_cast<float>(i / side % side),
+                    spacing * static_cast<float>(i / (side * side))
+                );
+                const glm::mat4 module = glm::scale(glm::translate(glm::mat4(1.f), offset), glm::vec3(entry_scale));
+                field_modules.push_back(module);
+                field_entries.push_back(is_soldier ? FieldEntry{ soldier.model.get(), &NSP } : FieldEntry{ cube.model.get(), &CSP });
+                field_bounds.push_back({ glm::vec3(module * glm::vec4(local.center, 1.f)), local.radius * entry_scale });
+            }
+            field_built_state = get_field_state();
+        };
+
+        auto submit_cube_field = [&](LodSelector const& selector) -> void {
+            // one zone for the whole field, a zone per Model::submit would fill the profiler ring with a large field
+            PROFILE_SCOPE("cube field");
+            if (field_modules.size() != cube_field_count || field_built_state != get_field_state()) {
+                build_cube_field();
+            }
+            field_bounds.cull(camera.get_frustum(), field_visible);
+            m_visible_cube_count = field_visible.size();
+            if (field_visible.empty()) {
+                return;
+            }
+
+            if (instanced_drawing && !mixed_cube_field) {
+                for (auto& modules : field_visible_modules) {
+                    modules.clear();
+                }
+                for (auto index : field_visible) {
+                    const uint32_t lod = cube.model->select_lod(selector, field_bounds.get(index), field_lods[index]);
+                    field_visible_modules[lod].push_back(field_modules[index]);
+                }
+
+                for (uint32_t lod = 0; lod < MAX_LOD_LEVELS; ++lod) {
+                    auto const& modules = field_visible_modules[lod];
+                    if (modules.empty()) {
+                        continue;
+                    }
+                    instance_transforms_buffers[lod].set_data(modules.data(), modules.size() * sizeof(glm::mat4));
+                    cube.model->submit_instanced(queue, CISP, instance_transforms_buffers[lod], static_cast<uint32_t>(modules.size()), lod);
+                }
+                return;
+            }
+
+            for (auto index : field_visible) {
+                auto const& entry = field_entries[index];
+                const uint32_t lod = entry.model->select_lod(selector, field_bounds.get(index), field_lods[index]);
+                entry.model->submit(queue, *entry.program, field_modules[index], m_culling_stats, lod);
+            }
+        };
        
 
 		while (!m_bCloseWindow) {
 
+            Profiler::new_frame();
+            PROFILE_SCOPE("frame");
+            PROFILE_GPU_SCOPE("frame");
+
+            const auto frame_start = std::chrono::steady_clock::now();
+            Renderer_OpenGL::begin_frame();
+            m_frame_index = Renderer_OpenGL::get_frame_index();
+            gpu_timer.begin(m_frame_index);
+            Renderer_OpenGL::get_state().reset_stats();
+
+            {
+                PROFILE_SCOPE("load");
+                assets.process_uploads(UPLOAD_BUDGET_PER_FRAME);
+            }
+            m_culling_stats = {};
+
             Renderer_OpenGL::set_clear_color(m_background_color);
 
-            shd_light_uniform(NSP);
-            shd_light_uniform(CSP);
+            {
+                PROFILE_SCOPE("uniform upload");
+                upload_point_lights();
+                update_light_clusters();
+                shd_frame_uniform(NSP, NSP_uniforms);
+                shd_frame_uniform(CSP, CSP_uniforms);
+                shd_frame_uniform(CISP, CISP_uniforms);
+            }
 
             Renderer_OpenGL::clear();
 
-            soldier.module = glm::mat4(1.f);
-            draw(&soldier, NSP);
+            queue.begin(camera.get_view_matrix(), camera.get_projection_matrix(), camera.get_far_plane());
+
+            auto lod_selector = LodSelector::from_camera(camera, lod_error_pixels);
+            if (!lod_enabled) {
+                lod_selector.projection_scale = 0.f;
+            }
 
             auto size = 21.0;
             auto resize1 = 0.1;
-            cube.module = glm::translate(glm::scale(glm::mat4(1.f), { resize1, resize1, resize1}), { 0, 0, 0});
-            draw(&cube, NSP);
+            {
+                PROFILE_SCOPE("culling and submission");
+                soldier.module = glm::mat4(1.f);
+                soldier.model->submit(queue, NSP, soldier.module, m_culling_stats, soldier.model->select_lod(lod_selector, soldier.module, soldier.lod));
+
+                cube.module = glm::translate(glm::scale(glm::mat4(1.f), { resize1, resize1, resize1}), { 0, 0, 0});
+                cube.model->submit(queue, NSP, cube.module, m_culling_stats, cube.model->select_lod(lod_selector, cube.module, cube.lod));
+
+                submit_cube_field(lod_selector);
+            }
+
+            {
+                PROFILE_SCOPE("scene");
+                PROFILE_GPU_SCOPE("scene");
+                queue.execute(sorted_submission, multi_draw_indirect);
+            }
+            m_render_queue_stats = queue.get_stats();
+            m_material_stats = MaterialTable::get().get_stats();
 
             auto scf = 0.11;
             auto tsf = (scf * size - resize1 * size) / 2.0;
             cube.module = glm::scale(glm::mat4(1.f), { scf, scf, scf });
+
+            {
+                PROFILE_SCOPE("highlight");
+                PROFILE_GPU_SCOPE("highlight");
+                highlight_queue.begin(camera.get_view_matrix(), camera.get_projection_matrix(), camera.get_far_plane());
+                cube.model->submit(highlight_queue, CSP, cube.module, m_culling_stats);
+                CSP.bind();
+                CSP.set(CSP_flag, 1);
+                highlight_queue.execute();
+                CSP.bind();
+                CSP.set(CSP_flag, 0);
+            }
             
-            CSP.bind();
-            CSP.set_int("flag", 1);
-            draw(&cube, CSP);
-            
-            UIModule::UI_draw_begin();
-            on_UI_update();
-            UIModule::UI_draw_end();
+            m_loading = assets.get_pending_count() != 0;
+            const bool counted_frame = m_headless && (!m_headless->wait_for_assets || !m_loading);
+            if (!m_headless) {
+                PROFILE_SCOPE("UI");
+                UIModule::UI_draw_begin();
+                on_UI_update();
+                UIModule::UI_draw_end();
+            }
+
+            m_render_frame_stats = Renderer_OpenGL::get_frame_stats();
+            m_draw_call_count = m_render_frame_stats.draw_calls;
+            m_gl_state_stats = Renderer_OpenGL::get_state().get_stats();
+            m_cpu_frame_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - frame_start).count();
+
+            gpu_timer.end();
+            GpuTimer::Result gpu_time;
+            while (gpu_timer.pop_result(gpu_time)) {
+                m_gpu_frame_ms = gpu_time.ms;
+                on_gpu_frame_time(gpu_time.tag, gpu_time.ms);
+            }
+
+            // the read back waits for the GPU, it stays out of the frame times
+            if (counted_frame && m_headless->dump_interval != 0 && m_headless_frame % m_headless->dump_interval == 0) {
+                offscreen->read_pixels(frame_pixels);
+                const auto path = std::format("{}/frame_{:05}.tga", m_headless->dump_directory, m_headless_frame);
+                if (!write_tga(path, offscreen->get_width(), offscreen->get_height(), frame_pixels)) {
+                    exit_code = 1;
+                }
+            }
 			
             m_pWindow->on_update();
-    		on_update();
+            {
+                PROFILE_SCOPE("Application::on_update");
+                on_update();
+            }
+
+            if (counted_frame && ++m_headless_frame >= m_headless->frame_count) {
+                close();
+            }
 		}
+        Profiler::release_gpu();
+        offscreen = nullptr;
 		m_pWindow = nullptr;
-		return 0;
+        Log::stop_async();
+		return exit_code;
 	};
 
 
@@ -0,0 +1,76 @@
+#include "EngineCore/AssetManager.hpp"
+#include "EngineCore/Logs.hpp"
+#include "EngineCore/Profiler.hpp"
+#include "EngineCore/Rendering/OpenGL/TextureCache.hpp"
+
+namespace EngineCore {
+
+	AssetManager::AssetManager(size_t upload_queue_capacity)
+		: m_uploads(upload_queue_capacity)
+	{}
+
+	AssetManager::~AssetManager() {
+		// unblock the loader and let it skip whatever is still queued
+		m_closing = true;
+		m_uploads.close();
+	}
+
+	AssetManager::ModelHandle AssetManager::load_model_async(std::string path) {
+		ModelHandle model(new Model());
+		++m_pending_models;
+
+		m_loader.submit([this, model, path = std::move(path)]() {
+			if (m_closing) {
+				return;
+			}
+			Profiler::set_thread_name("asset loader");
+
+			auto data = Model::load_data(path);
+			const size_t mesh_count = Model::get_mesh_count(*data);
+
+			// one item per mesh so the render thread can spread the uploads over several frames,
+			// the last item (mesh_index == mesh_count) marks the model as finished
+			for (size_t i = 0; i <= mesh_count; ++i) {
+				if (!m_uploads.push({ model, data, i })) {
+					return;
+				}
+			}
+		});
+
+		return model;
+	}
+
+	size_t AssetManager::process_uploads(std::chrono::microseconds budget) {
+		PROFILE_SCOPE("AssetManager::process_uploads");
+		const auto start = std::chrono::steady_clock::now();
+		size_t uploaded = 0;
+
+		while (auto item = m_uploads.try_pop()) {
+			if (item->mesh_index < Model::get_mesh_count(*item->data)) {
+				item->model->upload_mesh(*item->data, item->mesh_index);
+			}
+			else {
+				item->model->m_loaded = !item->model->meshes.empty();
+				--m_pending_models;
+				if (!item->model->m_loaded) {
+					LOG_ERROR("[ASSET MANAGER] Failed to load model, keeping placeholder");
+				}
+				else {
+					item->model->log_memory_stats(*item->data);
+				}
+
+				auto stats = TextureCache::get().get_stats();
+				LOG_INFO("[TEXTURE CACHE] hits = {} | misses = {} | saved = {} KB | resident = {} textures, {} KB",
+					stats.hits, stats.misses, stats.bytes_saved / 1024, stats.textures_resident, stats.gpu_bytes_resident / 1024);
+			}
+			++uploaded;
+
+			if (std::chrono::steady_clock::now() - start >= budget) {
+				break;
+			}
+		}
+
+		return uploaded;
+	}
+
+}
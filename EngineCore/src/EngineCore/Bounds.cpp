@@ -0,0 +1,86 @@
+#include "EngineCore/Bounds.hpp"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <limits>
+
+namespace EngineCore {
+
+	AABB AABB::from_points(std::span<const glm::vec3> points) {
+		if (points.empty()) {
+			return {};
+		}
+
+		AABB box{ points[0], points[0] };
+		for (auto const& point : points) {
+			box.min = glm::min(box.min, point);
+			box.max = glm::max(box.max, point);
+		}
+		return box;
+	}
+
+	void AABB::merge(const AABB& other) {
+		min = glm::min(min, other.min);
+		max = glm::max(max, other.max);
+	}
+
+	BoundingSphere BoundingSphere::from_aabb(const AABB& box) {
+		return { box.get_center(), glm::length(box.get_extent()) };
+	}
+
+	BoundingSphere BoundingSphere::transformed(const glm::mat4& matrix) const {
+		const float scale = std::max({
+			glm::length(glm::vec3(matrix[0])), glm::length(glm::vec3(matrix[1])), glm::length(glm::vec3(matrix[2]))
+		});
+		return { glm::vec3(matrix * glm::vec4(center, 1.f)), radius * scale };
+	}
+
+	Frustum Frustum::from_matrix(const glm::mat4& matrix) {
+		// Gribb/Hartmann: planes are sums/differences of the matrix rows, glm stores columns
+		auto row = [&](const int i) {
+			return glm::vec4(matrix[0][i], matrix[1][i], matrix[2][i], matrix[3][i]);
+		};
+
+		Frustum frustum;
+		frustum.m_planes[Left] = row(3) + row(0);
+		frustum.m_planes[Right] = row(3) - row(0);
+		frustum.m_planes[Bottom] = row(3) + row(1);
+		frustum.m_planes[Top] = row(3) - row(1);
+		frustum.m_planes[Near] = row(3) + row(2);
+		frustum.m_planes[Far] = row(3) - row(2);
+
+		for (auto& plane : frustum.m_planes) {
+			const float length = glm::length(glm::vec3(plane));
+			if (length > 0.f) {
+				plane /= length;
+			}
+		}
+		return frustum;
+	}
+
+	bool Frustum::intersects(const BoundingSphere& sphere) const {
+		for (auto const& plane : m_planes) {
+			if (glm::dot(glm::vec3(plane), sphere.center) + plane.w < -sphere.radius) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool Frustum::intersects(const AABB& box) const {
+		for (auto const& plane : m_planes) {
+			// corner furthest along the plane normal
+			const glm::vec3 positive(
+				plane.x >= 0.f ? box.max.x : box.min.x,
+				plane.y >= 0.f ? box.max.y : box.min.y,
+				plane.z >= 0.f ? box.max.z : box.min.z
+			);
+			if (glm::dot(glm::vec3(plane), positive) + plane.w < 0.f) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+}
@@ -136,6 +136,10 @@ namespace EngineCore {
 		return m_projection_matrix * m_view_matrix;
 	}
 
+	Frustum Camera::get_frustum() const {
+		return Frustum::from_matrix(get_view_projection_matrix());
+	}
+
 
 	void Camera::move_forward(const float delta) {
 		if (delta != 0.f) {
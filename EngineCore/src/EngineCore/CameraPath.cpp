@@ -0,0 +1,108 @@
+#include "EngineCore/CameraPath.hpp"
+#include "EngineCore/Camera.hpp"
+#include "EngineCore/Logs.hpp"
+
+#include <glm/common.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+namespace EngineCore {
+
+	bool CameraPath::load(std::string const& path) {
+		std::ifstream in(path);
+		if (!in.is_open()) {
+			LOG_ERROR("[CAMERA PATH] Can't open '{}'", path);
+			return false;
+		}
+
+		std::vector<Keyframe> keyframes;
+		std::string line;
+		size_t line_number = 0;
+		while (std::getline(in, line)) {
+			++line_number;
+			const auto comment = line.find('#');
+			if (comment != std::string::npos) {
+				line.resize(comment);
+			}
+			if (line.find_first_not_of(" \t\r") == std::string::npos) {
+				continue;
+			}
+
+			std::istringstream fields(line);
+			Keyframe keyframe;
+			fields >> keyframe.time
+				>> keyframe.position.x >> keyframe.position.y >> keyframe.position.z
+				>> keyframe.rotation.x >> keyframe.rotation.y >> keyframe.rotation.z;
+			if (fields.fail() || (!keyframes.empty() && keyframe.time < keyframes.back().time)) {
+				LOG_ERROR("[CAMERA PATH] '{}':{} is not a keyframe in time order", path, line_number);
+				return false;
+			}
+			keyframes.push_back(keyframe);
+		}
+
+		if (keyframes.empty()) {
+			LOG_ERROR("[CAMERA PATH] '{}' has no keyframes", path);
+			return false;
+		}
+		m_keyframes = std::move(keyframes);
+		return true;
+	}
+
+	bool CameraPath::save(std::string const& path) const {
+		std::ofstream out(path, std::ios::trunc);
+		if (!out.is_open()) {
+			LOG_ERROR("[CAMERA PATH] Can't open '{}' for writing", path);
+			return false;
+		}
+
+		out << "# time px py pz rx ry rz\n";
+		for (auto const& keyframe : m_keyframes) {
+			out << keyframe.time << ' '
+				<< keyframe.position.x << ' ' << keyframe.position.y << ' ' << keyframe.position.z << ' '
+				<< keyframe.rotation.x << ' ' << keyframe.rotation.y << ' ' << keyframe.rotation.z << '\n';
+		}
+		return out.good();
+	}
+
+	void CameraPath::add_keyframe(Keyframe const& keyframe) {
+		m_keyframes.push_back(keyframe);
+	}
+
+	void CameraPath::add_keyframe(const float time, Camera const& camera) {
+		m_keyframes.push_back({ time, camera.get_position(), camera.get_rotation() });
+	}
+
+	void CameraPath::clear() {
+		m_keyframes.clear();
+	}
+
+	CameraPath::Keyframe CameraPath::sample(const float time) const {
+		if (m_keyframes.empty()) {
+			return {};
+		}
+		if (time <= m_keyframes.front().time) {
+			return m_keyframes.front();
+		}
+		if (time >= m_keyframes.back().time) {
+			return m_keyframes.back();
+		}
+
+		const auto next = std::upper_bound(m_keyframes.begin(), m_keyframes.end(), time,
+			[](const float t, Keyframe const& keyframe) { return t < keyframe.time; });
+		auto const& b = *next;
+		auto const& a = *(next - 1);
+
+		const float span = b.time - a.time;
+		const float t = span > 0.f ? (time - a.time) / span : 1.f;
+		return { time, glm::mix(a.position, b.position, t), glm::mix(a.rotation, b.rotation, t) };
+	}
+
+	void CameraPath::apply(const float time, Camera& camera) const {
+		const Keyframe keyframe = sample(time);
+		camera.set_position(keyframe.position);
+		camera.set_rotation(keyframe.rotation);
+	}
+
+}
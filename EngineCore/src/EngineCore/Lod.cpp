@@ -0,0 +1,53 @@
+#include "EngineCore/Lod.hpp"
+#include "EngineCore/Camera.hpp"
+
+#include <glm/glm.hpp>
+
+#include <cmath>
+#include <algorithm>
+
+namespace EngineCore {
+
+	LodSelector LodSelector::from_camera(Camera const& camera, const float error_pixels) {
+		LodSelector res;
+		res.camera_position = camera.get_position();
+		res.error_pixels = error_pixels;
+		if (camera.get_projection_mode() == Camera::ProjectionMode::Perspective) {
+			res.projection_scale = camera.get_viewport_height() / (2.f * std::tan(camera.get_field_of_view() * 0.5f));
+		}
+		return res;
+	}
+
+	uint32_t LodSelector::select(std::span<const float> errors, BoundingSphere const& sphere, uint8_t& level) const {
+		const float distance = glm::length(sphere.center - camera_position);
+		if (errors.size() <= 1 || projection_scale <= 0.f || distance <= sphere.radius) {
+			level = 0;
+			return 0;
+		}
+
+		const float pixels_per_error = sphere.radius * projection_scale / distance;
+		auto projected = [&](const uint32_t i) { return errors[i] * pixels_per_error; };
+
+		const auto last = static_cast<uint32_t>(errors.size() - 1);
+		const uint32_t current = std::min<uint32_t>(level, last);
+
+		// errors grow with the level
+		uint32_t desired = 0;
+		while (desired < last && projected(desired + 1) <= error_pixels) {
+			++desired;
+		}
+
+		if (desired > current) {
+			while (desired > current && projected(desired) > error_pixels * (1.f - hysteresis)) {
+				--desired;
+			}
+		}
+		else if (desired < current && projected(current) <= error_pixels * (1.f + hysteresis)) {
+			desired = current;
+		}
+
+		level = static_cast<uint8_t>(desired);
+		return desired;
+	}
+
+}
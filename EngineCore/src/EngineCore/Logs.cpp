@@ -1,9 +1,294 @@
-
 #include "EngineCore/Logs.hpp"
 #include "spdlog/spdlog.h"
 
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
 namespace EngineCore {
 
+	namespace {
+
+		// how long the flusher sleeps when nobody asks for a flush
+		constexpr auto FLUSH_INTERVAL = std::chrono::milliseconds(5);
+
+		static_assert((Log::QUEUE_CAPACITY & (Log::QUEUE_CAPACITY - 1)) == 0, "Log::QUEUE_CAPACITY must be a power of two");
+
+		constexpr const char* CATEGORY_NAMES[] = { "General", "OpenGL", "Assets" };
+		// messages per second, a burst of driver debug messages is the usual reason to hit one
+		constexpr uint32_t DEFAULT_RATE_LIMITS[] = { 1000, 50, 200 };
+		static_assert(std::size(CATEGORY_NAMES) == size_t(LogCategory::Count));
+		static_assert(std::size(DEFAULT_RATE_LIMITS) == size_t(LogCategory::Count));
+
+		// slot of the bounded MPSC queue: 'sequence' equals the position a producer may claim it at,
+		// position + 1 once the record is written and position + QUEUE_CAPACITY once the flusher is done with it
+		struct Record {
+			std::atomic<uint64_t> sequence{ 0 };
+			spdlog::log_clock::time_point time;
+			std::string_view format;
+			void (*format_function)(std::string_view, const std::byte*, std::string&) = nullptr;
+			LogLevel level = LogLevel::Info;
+			std::array<std::byte, Log::PAYLOAD_SIZE> payload;
+		};
+
+		struct CategoryLimit {
+			std::atomic<uint32_t> messages_per_second{ 0 };
+			std::atomic<int64_t> window_start{ 0 };
+			std::atomic<uint32_t> count{ 0 };
+			std::atomic<size_t> suppressed{ 0 };
+		};
+
+		struct LogState {
+			LogState()
+				: records(std::make_unique<Record[]>(Log::QUEUE_CAPACITY))
+			{
+				for (size_t i = 0; i < Log::QUEUE_CAPACITY; ++i) {
+					records[i].sequence.store(i, std::memory_order_relaxed);
+				}
+				for (size_t i = 0; i < size_t(LogCategory::Count); ++i) {
+					limits[i].messages_per_second.store(DEFAULT_RATE_LIMITS[i], std::memory_order_relaxed);
+				}
+			}
+
+			std::unique_ptr<Record[]> records;
+			alignas(64) std::atomic<uint64_t> enqueue_position{ 0 };
+			// flusher only, 'written' is what flush() waits on
+			alignas(64) uint64_t dequeue_position = 0;
+			std::atomic<uint64_t> written{ 0 };
+
+			std::atomic<bool> async{ false };
+			std::atomic<size_t> dropped{ 0 };
+			size_t dropped_reported = 0;
+			CategoryLimit limits[size_t(LogCategory::Count)];
+
+			// guards the flusher handshake, never taken by a producer
+			std::mutex mutex;
+			std::condition_variable wake;
+			std::condition_variable flushed;
+			bool running = false;
+			bool flush_requested = false;
+			std::thread flusher;
+			// serializes start_async() and stop_async()
+			std::mutex lifetime_mutex;
+		};
+
+		// never destroyed, threads may still log during static destruction
+		LogState& get_state() {
+			static LogState* state = new LogState();
+			return *state;
+		}
+
+		spdlog::level::level_enum to_spdlog_level(const LogLevel level) {
+			switch (level) {
+			case LogLevel::Info: return spdlog::level::info;
+			case LogLevel::Warn: return spdlog::level::warn;
+			case LogLevel::Error: return spdlog::level::err;
+			case LogLevel::Critical: return spdlog::level::critical;
+			}
+			return spdlog::level::info;
+		}
+
+		void write_at(const spdlog::log_clock::time_point time, const LogLevel level, std::string_view message) {
+			spdlog::default_logger_raw()->log(time, spdlog::source_loc{}, to_spdlog_level(level), spdlog::string_view_t(message.data(), message.size()));
+		}
+
+		int64_t now_ms() {
+			return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+		}
+
+		void report_suppressed(LogState& state, const size_t category) {
+			const size_t suppressed = state.limits[category].suppressed.exchange(0, std::memory_order_relaxed);
+			if (suppressed != 0) {
+				write_at(spdlog::log_clock::now(), LogLevel::Warn,
+					std::format("[LOG] {} {} messages over the rate limit were dropped", suppressed, CATEGORY_NAMES[category]));
+			}
+		}
+
+		bool write_next(LogState& state, std::string& message) {
+			auto& record = state.records[state.dequeue_position & (Log::QUEUE_CAPACITY - 1)];
+			if (record.sequence.load(std::memory_order_acquire) != state.dequeue_position + 1) {
+				return false;
+			}
+			record.format_function(record.format, record.payload.data(), message);
+			write_at(record.time, record.level, message);
+			record.sequence.store(state.dequeue_position + Log::QUEUE_CAPACITY, std::memory_order_release);
+			++state.dequeue_position;
+			return true;
+		}
+
+		void drain(LogState& state) {
+			std::string message;
+			bool any = false;
+			while (write_next(state, message)) {
+				any = true;
+			}
+			state.written.store(state.dequeue_position, std::memory_order_release);
+
+			for (size_t i = 0; i < size_t(LogCategory::Count); ++i) {
+				report_suppressed(state, i);
+			}
+			const size_t dropped = state.dropped.load(std::memory_order_relaxed);
+			if (dropped != state.dropped_reported) {
+				write_at(spdlog::log_clock::now(), LogLevel::Warn,
+					std::format("[LOG] queue full, {} messages were dropped", dropped - state.dropped_reported));
+				state.dropped_reported = dropped;
+				any = true;
+			}
+			if (any) {
+				spdlog::default_logger_raw()->flush();
+			}
+		}
+
+		void run_flusher(LogState& state) {
+			for (;;) {
+				bool stopping = false;
+				{
+					std::unique_lock lock(state.mutex);
+					state.wake.wait_for(lock, FLUSH_INTERVAL, [&state]() { return state.flush_requested || !state.running; });
+					state.flush_requested = false;
+					stopping = !state.running;
+				}
+
+				drain(state);
+				{
+					std::lock_guard lock(state.mutex);
+				}
+				state.flushed.notify_all();
+
+				if (stopping) {
+					return;
+				}
+			}
+		}
+
+	}
+
+	void Log::start_async() {
+		auto& state = get_state();
+		std::lock_guard lifetime(state.lifetime_mutex);
+		if (state.flusher.joinable()) {
+			return;
+		}
+		{
+			std::lock_guard lock(state.mutex);
+			state.running = true;
+		}
+		state.flusher = std::thread(run_flusher, std::ref(state));
+		state.async.store(true, std::memory_order_release);
+	}
+
+	void Log::stop_async() {
+		auto& state = get_state();
+		std::lock_guard lifetime(state.lifetime_mutex);
+		if (!state.flusher.joinable()) {
+			return;
+		}
+		// new messages are written synchronously from here, the flusher drains the queue once more before it exits
+		state.async.store(false, std::memory_order_release);
+		{
+			std::lock_guard lock(state.mutex);
+			state.running = false;
+		}
+		state.wake.notify_one();
+		state.flusher.join();
+		// a producer that saw is_async() before the store may have queued its message after the last drain
+		drain(state);
+	}
+
+	bool Log::is_async() {
+		return get_state().async.load(std::memory_order_acquire);
+	}
+
+	void Log::flush() {
+		auto& state = get_state();
+		if (!is_async()) {
+			spdlog::default_logger_raw()->flush();
+			return;
+		}
+
+		const uint64_t target = state.enqueue_position.load(std::memory_order_acquire);
+		std::unique_lock lock(state.mutex);
+		state.flush_requested = true;
+		state.wake.notify_one();
+		state.flushed.wait(lock, [&state, target]() {
+			return state.written.load(std::memory_order_acquire) >= target || !state.running;
+		});
+	}
+
+	void Log::set_rate_limit(const LogCategory category, const uint32_t messages_per_second) {
+		get_state().limits[size_t(category)].messages_per_second.store(messages_per_second, std::memory_order_relaxed);
+	}
+
+	size_t Log::get_dropped_count() {
+		return get_state().dropped.load(std::memory_order_relaxed);
+	}
+
+	bool Log::allow(const LogCategory category) {
+		auto& state = get_state();
+		auto& limit = state.limits[size_t(category)];
+		const uint32_t messages_per_second = limit.messages_per_second.load(std::memory_order_relaxed);
+		if (messages_per_second == 0) {
+			return true;
+		}
+
+		const int64_t now = now_ms();
+		int64_t window_start = limit.window_start.load(std::memory_order_relaxed);
+		if (now - window_start >= RATE_WINDOW_MS && limit.window_start.compare_exchange_strong(window_start, now, std::memory_order_relaxed)) {
+			limit.count.store(0, std::memory_order_relaxed);
+			// the flusher reports on its own while it runs
+			if (!is_async()) {
+				report_suppressed(state, size_t(category));
+			}
+		}
+
+		if (limit.count.fetch_add(1, std::memory_order_relaxed) < messages_per_second) {
+			return true;
+		}
+		limit.suppressed.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	void Log::push(const LogLevel level, std::string_view format, FormatFunction format_function, Payload const& payload) {
+		auto& state = get_state();
+
+		uint64_t position = state.enqueue_position.load(std::memory_order_relaxed);
+		Record* record = nullptr;
+		for (;;) {
+			record = &state.records[position & (QUEUE_CAPACITY - 1)];
+			const uint64_t sequence = record->sequence.load(std::memory_order_acquire);
+			const auto difference = static_cast<int64_t>(sequence - position);
+			if (difference == 0) {
+				if (state.enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+					break;
+				}
+			}
+			else if (difference < 0) {
+				// full, the flusher hasn't reached this slot yet
+				state.dropped.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+			else {
+				position = state.enqueue_position.load(std::memory_order_relaxed);
+			}
+		}
+
+		record->time = spdlog::log_clock::now();
+		record->format = format;
+		record->format_function = format_function;
+		record->level = level;
+		std::memcpy(record->payload.data(), payload.data.data(), payload.size);
+		record->sequence.store(position + 1, std::memory_order_release);
+
+		// whatever comes after a critical message may not get the chance to be written
+		if (level == LogLevel::Critical) {
+			flush();
+		}
+	}
 
+	void Log::write_message(const LogLevel level, std::string_view message) {
+		write_at(spdlog::log_clock::now(), level, message);
+	}
 
-}
\ No newline at end of file
+}
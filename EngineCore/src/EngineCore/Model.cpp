@@ -5,59 +5,393 @@
 #include <assimp/postprocess.h>
 
 #include "EngineCore/Modules/FileRead.hpp"
+#include "EngineCore/Modules/TextureFile.hpp"
+#include "EngineCore/Modules/ModelCache.hpp"
+#include "EngineCore/Modules/MeshOptimizer.hpp"
+#include "EngineCore/Modules/ThreadPool.hpp"
 
 #include "EngineCore/Logs.hpp"
+#include "EngineCore/Profiler.hpp"
 
 #include "EngineCore/Rendering/OpenGL/Mesh.hpp"
 #include "EngineCore/Rendering/OpenGL/Texture2D.hpp"
+#include "EngineCore/Rendering/OpenGL/TextureCache.hpp"
 #include "EngineCore/Rendering/OpenGL/ShaderProgram.hpp"
+#include "EngineCore/Rendering/OpenGL/RenderQueue.hpp"
 
 #include <string>
 #include <vector>
 #include <memory>
+#include <chrono>
+#include <span>
+#include <array>
+#include <algorithm>
+#include <future>
+#include <unordered_map>
 
 namespace EngineCore {
 
-	void Model::load_model(std::string path) {
-		auto scene = import_scene(path, aiProcess_Triangulate | aiProcess_FlipUVs);
+	static double elapsed_ms(std::chrono::steady_clock::time_point start) {
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	static constexpr uint32_t MODEL_IMPORT_FLAGS = aiProcess_Triangulate | aiProcess_FlipUVs;
+	static const MeshOptimizeOptions MODEL_OPTIMIZE_OPTIONS{};
+
+	static void log_cache_stats(std::string const& path, const char* pass, VertexCacheStats const& stats) {
+		LOG_CATEGORY_INFO(Assets, "[MODEL] '{}' {:>12}: {} triangles, {} vertices, ACMR {:.3f}, ATVR {:.3f}",
+			path, pass, stats.triangles, stats.vertices, stats.get_acmr(), stats.get_atvr());
+	}
+
+	struct MeshSource {
+		std::span<const Vertex> vertices;
+		std::span<const GLuint> indices;
+		std::vector<TextureRef> const* textures;
+		std::span<const MeshLod> lods;
+	};
 
-		if (scene == nullptr) {
-			LOG_ERROR("LOAD_MODEL_ERROR: {}", path);
+	// Everything a model needs before touching GL: mesh arrays (owned or viewed from the cache mapping)
+	// and decoded images. Built off the render thread, consumed by upload_mesh().
+	struct ModelData {
+		std::string path;
+		std::string directory;
+		std::unique_ptr<ModelCache> cache;
+		std::vector<MeshData> meshes;
+		std::vector<MeshSource> sources;
+		std::unordered_map<std::string, TextureImage> images;
+	};
+
+	Model::Model(const char* path) {
+		auto data = load_data(path);
+
+		auto start = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < get_mesh_count(*data); ++i) {
+			upload_mesh(*data, i);
+		}
+		m_loaded = !meshes.empty();
+		if (!m_loaded) {
+			LOG_ERROR("[MODEL] Failed to load '{}', keeping placeholder", path);
 			return;
 		}
+		LOG_CATEGORY_INFO(Assets, "[MODEL] '{}' stage 'upload': {:.2f} ms", path, elapsed_ms(start));
+		log_memory_stats(*data);
+		LOG_INFO("MODEL LOADED FROM '{}'", path);
+	}
+
+	ModelMemoryStats Model::get_memory_stats() const {
+		ModelMemoryStats res;
+		res.meshes = meshes.size();
+		for (auto const& mesh : meshes) {
+			res.vertices += mesh.get_vertex_count();
+			res.indices += mesh.get_allocated_index_count();
+			res.vertex_bytes += mesh.get_vertex_count() * sizeof(PackedVertex);
+			res.index_bytes += mesh.get_allocated_index_count() * index_type_size(mesh.get_index_type());
+			if (mesh.get_index_type() == IndexType::UInt16) {
+				++res.uint16_meshes;
+			}
+		}
+		res.unpacked_bytes = res.vertices * sizeof(Vertex) + res.indices * sizeof(GLuint);
+		return res;
+	}
 
-		directory = path.substr(0, path.find_last_of('/') + 1);
-		process_node(scene->mRootNode, scene);
+	void Model::log_memory_stats(ModelData const& data) const {
+		const auto stats = get_memory_stats();
+		LOG_CATEGORY_INFO(Assets, "[MODEL] '{}' memory: {} KB vertices + {} KB indices ({}/{} meshes 16 bit) = {} KB, unpacked {} KB ({:.1f}%)",
+			data.path, stats.vertex_bytes / 1024, stats.index_bytes / 1024, stats.uint16_meshes, stats.meshes, stats.get_bytes() / 1024,
+			stats.unpacked_bytes / 1024, stats.unpacked_bytes ? 100.0 * stats.get_bytes() / stats.unpacked_bytes : 0.0);
 	}
 
+	// Import and conversion of aiMesh data and image decoding run on the loader pool,
+	// only the creation of GL objects stays on the thread that owns the context.
+	std::shared_ptr<ModelData> Model::load_data(std::string const& path) {
+		PROFILE_SCOPE("Model::load_data");
+		auto& pool = ThreadPool::get();
+		auto total_start = std::chrono::steady_clock::now();
+		auto stage_start = total_start;
+
+		auto data = std::make_shared<ModelData>();
+		data->path = path;
+		data->directory = path.substr(0, path.find_last_of('/') + 1);
+		data->cache = ModelCache::open(path, MODEL_IMPORT_FLAGS, MODEL_OPTIMIZE_OPTIONS.get_cache_key());
+
+		if (data->cache) {
+			auto const& cache = *data->cache;
+			data->sources.reserve(cache.get_mesh_count());
+			for (size_t i = 0; i < cache.get_mesh_count(); ++i) {
+				auto const& mesh = cache.get_mesh(i);
+				data->sources.push_back({ mesh.vertices, mesh.indices, &mesh.textures, mesh.lods });
+			}
+			LOG_CATEGORY_INFO(Assets, "[MODEL] '{}' stage 'cache map': {:.2f} ms", path, elapsed_ms(stage_start));
+		}
+		else {
+			Assimp::Importer importer;
+			std::vector<std::string> read_files;
+			auto scene = import_scene(importer, path, MODEL_IMPORT_FLAGS, &read_files);
+
+			if (scene == nullptr) {
+				LOG_ERROR("LOAD_MODEL_ERROR: {}", path);
+				return data;
+			}
+
+			std::vector<aiMesh*> ai_meshes;
+			process_node(scene->mRootNode, scene, ai_meshes);
+			LOG_CATEGORY_INFO(Assets, "[MODEL] '{}' stage 'import': {:.2f} ms", path, elapsed_ms(stage_start));
+
+			stage_start = std::chrono::steady_clock::now();
+			std::vector<std::future<MeshData>> converted;
+			converted.reserve(ai_meshes.size());
+			for (auto mesh : ai_meshes) {
+				converted.push_back(pool.submit([mesh, scene]() { return import_mesh(mesh, scene); }));
+			}
+
+			data->meshes.reserve(converted.size());
+			for (auto& future : converted) {
+				data->meshes.push_back(future.get());
+			}
+
+			LOG_CATEGORY_INFO(Assets, "[MODEL] '{}' stage 'convert': {} meshes in {:.2f} ms", path, data->meshes.size(), elapsed_ms(stage_start));
+
+			// the cooked file stores the optimized order, cached loads skip this stage
+			stage_start = std::chrono::steady_clock::now();
+			std::vector<std::future<MeshOptimizeReport>> optimized;
+			optimized.reserve(data->meshes.size());
+			for (auto& mesh : data->meshes) {
+				optimized.push_back(pool.submit([&mesh]() {
+					auto report = optimize_mesh(mesh.vertices, mesh.indices, MODEL_OPTIMIZE_OPTIONS);
+					mesh.lods = build_lods(mesh.vertices, mesh.indices, MODEL_OPTIMIZE_OPTIONS);
+					return report;
+				}));
+			}
+
+			MeshOptimizeReport report;
+			for (auto& future : optimized) {
+				report.merge(future.get());
+			}
+			LOG_CATEGORY_INFO(Assets, "[MODEL] '{}' stage 'optimize': {:.2f} ms", path, elapsed_ms(stage_start));
+			log_cache_stats(path, "input", report.input);
+			log_cache_stats(path, "deduplicated", report.deduplicated);
+			log_cache_stats(path, "vertex cache", report.vertex_cache);
+			log_cache_stats(path, "overdraw", report.overdraw);
+			log_cache_stats(path, "vertex fetch", report.vertex_fetch);
+
+			std::array<size_t, MAX_LOD_LEVELS> lod_triangles{};
+			for (auto const& mesh : data->meshes) {
+				for (uint32_t level = 0; level < MAX_LOD_LEVELS; ++level) {
+					lod_triangles[level] += mesh.lods[std::min<size_t>(level, mesh.lods.size() - 1)].index_count / 3;
+				}
+			}
+			LOG_CATEGORY_INFO(Assets, "[MODEL] '{}' LOD triangles: {} / {} / {} / {}", path, lod_triangles[0], lod_triangles[1], lod_triangles[2], lod_triangles[3]);
+
+			data->sources.reserve(data->meshes.size());
+			for (auto const& mesh : data->meshes) {
+				data->sources.push_back({ mesh.vertices, mesh.indices, &mesh.textures, mesh.lods });
+			}
+
+			ModelCache::write(path, read_files, MODEL_IMPORT_FLAGS, MODEL_OPTIMIZE_OPTIONS.get_cache_key(), data->meshes);
+		}
+
+		stage_start = std::chrono::steady_clock::now();
+		std::unordered_map<std::string, std::future<TextureImage>> pending_images;
+		auto& texture_cache = TextureCache::get();
+		auto const& material_table = MaterialTable::get();
+		for (auto const& source : data->sources) {
+			for (auto const& ref : *source.textures) {
+				const auto full_path = data->directory + ref.path;
+				if (material_table.is_resident(full_path, ref.type) || texture_cache.is_resident(full_path, ref.type)) {
+					continue;
+				}
+				auto [it, inserted] = pending_images.try_emplace(ref.path);
+				if (inserted) {
+					it->second = pool.submit([full_path]() { return load_texture_image(full_path); });
+				}
+			}
+		}
+
+		for (auto& [image_path, future] : pending_images) {
+			data->images.emplace(image_path, future.get());
+		}
+		LOG_CATEGORY_INFO(Assets, "[MODEL] '{}' stage 'decode': {} images in {:.2f} ms", path, data->images.size(), elapsed_ms(stage_start));
+
+		LOG_CATEGORY_INFO(Assets, "[MODEL] '{}' {} CPU load ({}): {} meshes in {:.2f} ms on {} workers",
+			path, data->cache ? "warm" : "cold", data->cache ? "cache hit" : "cache miss",
+			data->sources.size(), elapsed_ms(total_start), pool.get_thread_count());
+
+		return data;
+	}
+
+	size_t Model::get_mesh_count(ModelData const& data) {
+		return data.sources.size();
+	}
+
+	void Model::upload_mesh(ModelData& data, size_t index) {
+		PROFILE_SCOPE("Model::upload_mesh");
+		auto const& source = data.sources[index];
+
+		// textures already in a MaterialTable layer are not created again; the others are released
+		// once the mesh has copied them, unless another user still holds them in TextureCache
+		auto& texture_cache = TextureCache::get();
+		auto const& material_table = MaterialTable::get();
+		std::vector<MaterialTable::TextureSource> textures;
+		textures.reserve(source.textures->size());
+		for (auto const& ref : *source.textures) {
+			auto full_path = data.directory + ref.path;
+			TextureCache::TextureHandle texture;
+			if (!material_table.is_resident(full_path, ref.type)) {
+				texture = texture_cache.find(full_path, ref.type);
+				if (!texture) {
+					// decoded by load_data, or evicted since then and has to be read again
+					auto image = data.images.find(ref.path);
+					texture = (image != data.images.end()
+						? texture_cache.insert(full_path, ref.type, image->second)
+						: texture_cache.load(full_path, ref.type));
+				}
+			}
+			textures.push_back({ std::move(full_path), ref.type, std::move(texture) });
+		}
 
+		directory = data.directory;
+		meshes.emplace_back(source.vertices, source.indices, textures, source.lods);
 
-	void Model::process_node(aiNode* node, const aiScene* scene) {
+		if (meshes.size() == 1) {
+			m_bounds = meshes.back().get_bounds();
+		}
+		else {
+			m_bounds.merge(meshes.back().get_bounds());
+		}
+		m_bounding_sphere = BoundingSphere::from_aabb(m_bounds);
+		update_lod_errors();
+	}
+
+	// the error of a model level is the worst of its meshes, relative to the model radius,
+	// so the selection does not depend on the scale the model is drawn at
+	void Model::update_lod_errors() {
+		uint32_t levels = 1;
+		for (auto const& mesh : meshes) {
+			levels = std::max(levels, mesh.get_lod_count());
+		}
+
+		m_lod_errors.assign(levels, 0.f);
+		const float radius = m_bounding_sphere.radius > 0.f ? m_bounding_sphere.radius : 1.f;
+		for (auto const& mesh : meshes) {
+			for (uint32_t level = 0; level < levels; ++level) {
+				m_lod_errors[level] = std::max(m_lod_errors[level], mesh.get_lod(level).error / radius);
+			}
+		}
+	}
+
+	uint32_t Model::select_lod(LodSelector const& selector, const glm::mat4& module, uint8_t& level) const {
+		if (!m_loaded) {
+			level = 0;
+			return 0;
+		}
+		return selector.select(m_lod_errors, m_bounding_sphere.transformed(module), level);
+	}
+
+	uint32_t Model::select_lod(LodSelector const& selector, BoundingSphere const& sphere, uint8_t& level) const {
+		if (!m_loaded) {
+			level = 0;
+			return 0;
+		}
+		return selector.select(m_lod_errors, sphere, level);
+	}
+
+	void Model::process_node(aiNode* node, const aiScene* scene, std::vector<aiMesh*>& ai_meshes) {
 		for (uint32_t i = 0; i < node->mNumMeshes; ++i) {
-			aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
-			meshes.emplace_back(mesh, scene, directory.c_str());
+			ai_meshes.push_back(scene->mMeshes[node->mMeshes[i]]);
 		}
 
 		for (uint32_t i = 0; i < node->mNumChildren; ++i) {
-			process_node(node->mChildren[i], scene);
+			process_node(node->mChildren[i], scene, ai_meshes);
+		}
+	}
+
+	static Mesh make_placeholder_mesh() {
+		// unit cube without textures, MaterialTable gives it a material that samples white
+		const std::vector<Vertex> vertices = {
+			{ { -0.5f, -0.5f,  0.5f }, {  0.f,  0.f,  1.f }, { 0.f, 0.f } },
+			{ {  0.5f, -0.5f,  0.5f }, {  0.f,  0.f,  1.f }, { 1.f, 0.f } },
+			{ {  0.5f,  0.5f,  0.5f }, {  0.f,  0.f,  1.f }, { 1.f, 1.f } },
+			{ { -0.5f,  0.5f,  0.5f }, {  0.f,  0.f,  1.f }, { 0.f, 1.f } },
+
+			{ { -0.5f, -0.5f, -0.5f }, {  0.f,  0.f, -1.f }, { 0.f, 0.f } },
+			{ { -0.5f,  0.5f, -0.5f }, {  0.f,  0.f, -1.f }, { 1.f, 0.f } },
+			{ {  0.5f,  0.5f, -0.5f }, {  0.f,  0.f, -1.f }, { 1.f, 1.f } },
+			{ {  0.5f, -0.5f, -0.5f }, {  0.f,  0.f, -1.f }, { 0.f, 1.f } },
+
+			{ { -0.5f,  0.5f, -0.5f }, {  0.f,  1.f,  0.f }, { 0.f, 0.f } },
+			{ { -0.5f,  0.5f,  0.5f }, {  0.f,  1.f,  0.f }, { 1.f, 0.f } },
+			{ {  0.5f,  0.5f,  0.5f }, {  0.f,  1.f,  0.f }, { 1.f, 1.f } },
+			{ {  0.5f,  0.5f, -0.5f }, {  0.f,  1.f,  0.f }, { 0.f, 1.f } },
+
+			{ { -0.5f, -0.5f, -0.5f }, {  0.f, -1.f,  0.f }, { 0.f, 0.f } },
+			{ {  0.5f, -0.5f, -0.5f }, {  0.f, -1.f,  0.f }, { 1.f, 0.f } },
+			{ {  0.5f, -0.5f,  0.5f }, {  0.f, -1.f,  0.f }, { 1.f, 1.f } },
+			{ { -0.5f, -0.5f,  0.5f }, {  0.f, -1.f,  0.f }, { 0.f, 1.f } },
+
+			{ {  0.5f, -0.5f, -0.5f }, {  1.f,  0.f,  0.f }, { 0.f, 0.f } },
+			{ {  0.5f,  0.5f, -0.5f }, {  1.f,  0.f,  0.f }, { 1.f, 0.f } },
+			{ {  0.5f,  0.5f,  0.5f }, {  1.f,  0.f,  0.f }, { 1.f, 1.f } },
+			{ {  0.5f, -0.5f,  0.5f }, {  1.f,  0.f,  0.f }, { 0.f, 1.f } },
+
+			{ { -0.5f, -0.5f, -0.5f }, { -1.f,  0.f,  0.f }, { 0.f, 0.f } },
+			{ { -0.5f, -0.5f,  0.5f }, { -1.f,  0.f,  0.f }, { 1.f, 0.f } },
+			{ { -0.5f,  0.5f,  0.5f }, { -1.f,  0.f,  0.f }, { 1.f, 1.f } },
+			{ { -0.5f,  0.5f, -0.5f }, { -1.f,  0.f,  0.f }, { 0.f, 1.f } },
+		};
+
+		std::vector<GLuint> indices;
+		for (GLuint face = 0; face < 6; ++face) {
+			const GLuint base = face * 4;
+			indices.insert(indices.end(), { base, base + 1, base + 2, base + 2, base + 3, base });
 		}
+
+		return Mesh(vertices, indices, {});
+	}
+
+	Mesh const& Model::get_placeholder_mesh() {
+		// created on first use from the render thread and intentionally never destroyed,
+		// so it does not outlive the GL context during static destruction
+		static Mesh* placeholder = new Mesh(make_placeholder_mesh());
+		return *placeholder;
 	}
 
-	void Model::draw(ShaderProgram const& shader) {
-		shader.bind();
+	void Model::submit(RenderQueue& queue, ShaderProgram const& shader, const glm::mat4& module, CullingStats& stats, const uint32_t lod) {
+		if (!m_loaded) {
+			queue.submit(shader, get_placeholder_mesh(), module);
+			++stats.drawn;
+			return;
+		}
+
+		const auto frustum = Frustum::from_matrix(queue.get_view_projection_matrix() * module);
+		if (!frustum.intersects(m_bounding_sphere)) {
+			stats.culled += meshes.size();
+			return;
+		}
+
 		for (auto const& mesh : meshes) {
-			mesh.draw(shader);
+			if (frustum.intersects(mesh.get_bounds())) {
+				queue.submit(shader, mesh, module, lod);
+				++stats.drawn;
+			}
+			else {
+				++stats.culled;
+			}
 		}
 	}
 
-	void Model::raw_draw(ShaderProgram const& shader) {
-		shader.bind();
+	void Model::submit_instanced(RenderQueue& queue, ShaderProgram const& shader, ShaderStorageBuffer const& instances, const uint32_t instance_count, const uint32_t lod) {
+		PROFILE_SCOPE("Model::submit_instanced");
+		if (!m_loaded) {
+			queue.submit_instanced(shader, get_placeholder_mesh(), instances, instance_count);
+			return;
+		}
 		for (auto const& mesh : meshes) {
-			mesh.raw_draw(shader);
+			queue.submit_instanced(shader, mesh, instances, instance_count, lod);
 		}
 	}
 
 
+
 	 
 	
 
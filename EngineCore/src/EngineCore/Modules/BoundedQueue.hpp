@@ -0,0 +1,65 @@
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <optional>
+
+namespace EngineCore {
+
+	// Multi-producer queue with a fixed capacity: push() blocks producers while the queue is full,
+	// try_pop() never blocks, so the consumer can drain it from the frame loop.
+	template<typename T>
+	class BoundedQueue {
+	public:
+		explicit BoundedQueue(size_t capacity) : m_capacity(capacity) {}
+
+		BoundedQueue(BoundedQueue const&) = delete;
+		BoundedQueue& operator=(BoundedQueue const&) = delete;
+
+		bool push(T value) {
+			std::unique_lock lock(m_mutex);
+			m_not_full.wait(lock, [this]() { return m_closed || m_items.size() < m_capacity; });
+			if (m_closed) {
+				return false;
+			}
+			m_items.push_back(std::move(value));
+			return true;
+		}
+
+		std::optional<T> try_pop() {
+			std::optional<T> res;
+			{
+				std::lock_guard lock(m_mutex);
+				if (m_items.empty()) {
+					return res;
+				}
+				res.emplace(std::move(m_items.front()));
+				m_items.pop_front();
+			}
+			m_not_full.notify_one();
+			return res;
+		}
+
+		void close() {
+			{
+				std::lock_guard lock(m_mutex);
+				m_closed = true;
+			}
+			m_not_full.notify_all();
+		}
+
+		size_t size() const {
+			std::lock_guard lock(m_mutex);
+			return m_items.size();
+		}
+
+	private:
+		std::deque<T> m_items;
+		size_t m_capacity;
+		bool m_closed = false;
+		mutable std::mutex m_mutex;
+		std::condition_variable m_not_full;
+	};
+
+}
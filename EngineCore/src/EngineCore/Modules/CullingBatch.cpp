@@ -0,0 +1,259 @@
+#include "CullingBatch.hpp"
+#include "EngineCore/Profiler.hpp"
+
+#include <limits>
+#include <bit>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+	#define ENGINE_CULLING_X86
+	#include <immintrin.h>
+	#if defined(_MSC_VER)
+		#include <intrin.h>
+		#define ENGINE_TARGET_SSE
+		#define ENGINE_TARGET_AVX2
+	#else
+		#define ENGINE_TARGET_SSE __attribute__((target("sse2")))
+		#define ENGINE_TARGET_AVX2 __attribute__((target("avx2")))
+	#endif
+#endif
+
+namespace EngineCore {
+
+	static constexpr size_t BATCH_ALIGN = 8;
+	// padding spheres fail every plane test
+	static constexpr float CULLED_RADIUS = -std::numeric_limits<float>::max();
+
+	struct PlanesSoA {
+		float x[Frustum::PlanesCount];
+		float y[Frustum::PlanesCount];
+		float z[Frustum::PlanesCount];
+		float w[Frustum::PlanesCount];
+	};
+
+	static PlanesSoA get_planes(const Frustum& frustum) {
+		PlanesSoA planes;
+		for (int i = 0; i < Frustum::PlanesCount; ++i) {
+			auto const& plane = frustum.get_plane(static_cast<Frustum::Plane>(i));
+			planes.x[i] = plane.x;
+			planes.y[i] = plane.y;
+			planes.z[i] = plane.z;
+			planes.w[i] = plane.w;
+		}
+		return planes;
+	}
+
+	struct SpheresSoA {
+		const float* x;
+		const float* y;
+		const float* z;
+		const float* radius;
+		size_t count;
+	};
+
+	static size_t cull_scalar(const SpheresSoA& spheres, const PlanesSoA& planes, uint32_t* out) {
+		size_t visible = 0;
+		for (size_t i = 0; i < spheres.count; ++i) {
+			bool inside = true;
+			for (int p = 0; p < Frustum::PlanesCount && inside; ++p) {
+				const float distance = planes.x[p] * spheres.x[i] + planes.y[p] * spheres.y[i] + planes.z[p] * spheres.z[i] + planes.w[p];
+				inside = distance + spheres.radius[i] >= 0.f;
+			}
+			out[visible] = static_cast<uint32_t>(i);
+			visible += inside;
+		}
+		return visible;
+	}
+
+#ifdef ENGINE_CULLING_X86
+	ENGINE_TARGET_SSE
+	static size_t cull_sse(const SpheresSoA& spheres, const PlanesSoA& planes, uint32_t* out) {
+		__m128 px[Frustum::PlanesCount], py[Frustum::PlanesCount], pz[Frustum::PlanesCount], pw[Frustum::PlanesCount];
+		for (int p = 0; p < Frustum::PlanesCount; ++p) {
+			px[p] = _mm_set1_ps(planes.x[p]);
+			py[p] = _mm_set1_ps(planes.y[p]);
+			pz[p] = _mm_set1_ps(planes.z[p]);
+			pw[p] = _mm_set1_ps(planes.w[p]);
+		}
+		const __m128 zero = _mm_setzero_ps();
+
+		size_t visible = 0;
+		for (size_t i = 0; i < spheres.count; i += 4) {
+			const __m128 cx = _mm_loadu_ps(spheres.x + i);
+			const __m128 cy = _mm_loadu_ps(spheres.y + i);
+			const __m128 cz = _mm_loadu_ps(spheres.z + i);
+			const __m128 radius = _mm_loadu_ps(spheres.radius + i);
+
+			__m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+			for (int p = 0; p < Frustum::PlanesCount; ++p) {
+				__m128 distance = _mm_add_ps(_mm_mul_ps(px[p], cx), _mm_mul_ps(py[p], cy));
+				distance = _mm_add_ps(distance, _mm_mul_ps(pz[p], cz));
+				distance = _mm_add_ps(_mm_add_ps(distance, pw[p]), radius);
+				inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, zero));
+			}
+
+			unsigned mask = static_cast<unsigned>(_mm_movemask_ps(inside));
+			while (mask) {
+				out[visible++] = static_cast<uint32_t>(i + std::countr_zero(mask));
+				mask &= mask - 1;
+			}
+		}
+		return visible;
+	}
+
+	ENGINE_TARGET_AVX2
+	static size_t cull_avx2(const SpheresSoA& spheres, const PlanesSoA& planes, uint32_t* out) {
+		__m256 px[Frustum::PlanesCount], py[Frustum::PlanesCount], pz[Frustum::PlanesCount], pw[Frustum::PlanesCount];
+		for (int p = 0; p < Frustum::PlanesCount; ++p) {
+			px[p] = _mm256_set1_ps(planes.x[p]);
+			py[p] = _mm256_set1_ps(planes.y[p]);
+			pz[p] = _mm256_set1_ps(planes.z[p]);
+			pw[p] = _mm256_set1_ps(planes.w[p]);
+		}
+		const __m256 zero = _mm256_setzero_ps();
+
+		size_t visible = 0;
+		for (size_t i = 0; i < spheres.count; i += 8) {
+			const __m256 cx = _mm256_loadu_ps(spheres.x + i);
+			const __m256 cy = _mm256_loadu_ps(spheres.y + i);
+			const __m256 cz = _mm256_loadu_ps(spheres.z + i);
+			const __m256 radius = _mm256_loadu_ps(spheres.radius + i);
+
+			__m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+			for (int p = 0; p < Frustum::PlanesCount; ++p) {
+				// no FMA here: results stay bit-identical to the scalar and SSE paths
+				__m256 distance = _mm256_add_ps(_mm256_mul_ps(px[p], cx), _mm256_mul_ps(py[p], cy));
+				distance = _mm256_add_ps(distance, _mm256_mul_ps(pz[p], cz));
+				distance = _mm256_add_ps(_mm256_add_ps(distance, pw[p]), radius);
+				inside = _mm256_and_ps(inside, _mm256_cmp_ps(distance, zero, _CMP_GE_OQ));
+			}
+
+			unsigned mask = static_cast<unsigned>(_mm256_movemask_ps(inside));
+			while (mask) {
+				out[visible++] = static_cast<uint32_t>(i + std::countr_zero(mask));
+				mask &= mask - 1;
+			}
+		}
+		return visible;
+	}
+
+	static CullingBatch::Path detect_path() {
+	#if defined(_MSC_VER)
+		int info[4];
+		__cpuid(info, 0);
+		const int max_leaf = info[0];
+
+		__cpuid(info, 1);
+		const bool sse2 = (info[3] & (1 << 26)) != 0;
+		const bool osxsave = (info[2] & (1 << 27)) != 0;
+		const bool avx = (info[2] & (1 << 28)) != 0;
+
+		bool avx2 = false;
+		if (max_leaf >= 7 && osxsave && avx && (_xgetbv(0) & 0x6) == 0x6) {
+			__cpuidex(info, 7, 0);
+			avx2 = (info[1] & (1 << 5)) != 0;
+		}
+	#else
+		__builtin_cpu_init();
+		const bool sse2 = __builtin_cpu_supports("sse2");
+		const bool avx2 = __builtin_cpu_supports("avx2");
+	#endif
+		if (avx2) {
+			return CullingBatch::Path::AVX2;
+		}
+		if (sse2) {
+			return CullingBatch::Path::SSE;
+		}
+		return CullingBatch::Path::Scalar;
+	}
+#else
+	static CullingBatch::Path detect_path() {
+		return CullingBatch::Path::Scalar;
+	}
+#endif
+
+	CullingBatch::Path CullingBatch::get_best_path() {
+		static const Path path = detect_path();
+		return path;
+	}
+
+	const char* CullingBatch::get_path_name(const Path path) {
+		switch (path) {
+		case Path::SSE: return "SSE";
+		case Path::AVX2: return "AVX2";
+		default: return "Scalar";
+		}
+	}
+
+	void CullingBatch::reserve(const size_t count) {
+		const size_t padded = (count + BATCH_ALIGN - 1) / BATCH_ALIGN * BATCH_ALIGN;
+		m_center_x.reserve(padded);
+		m_center_y.reserve(padded);
+		m_center_z.reserve(padded);
+		m_radius.reserve(padded);
+	}
+
+	void CullingBatch::clear() {
+		m_center_x.clear();
+		m_center_y.clear();
+		m_center_z.clear();
+		m_radius.clear();
+		m_count = 0;
+	}
+
+	void CullingBatch::grow() {
+		const size_t padded = m_radius.size() + BATCH_ALIGN;
+		m_center_x.resize(padded, 0.f);
+		m_center_y.resize(padded, 0.f);
+		m_center_z.resize(padded, 0.f);
+		m_radius.resize(padded, CULLED_RADIUS);
+	}
+
+	uint32_t CullingBatch::push_back(const BoundingSphere& sphere) {
+		if (m_count == m_radius.size()) {
+			grow();
+		}
+		const auto index = static_cast<uint32_t>(m_count++);
+		set(index, sphere);
+		return index;
+	}
+
+	void CullingBatch::set(const uint32_t index, const BoundingSphere& sphere) {
+		m_center_x[index] = sphere.center.x;
+		m_center_y[index] = sphere.center.y;
+		m_center_z[index] = sphere.center.z;
+		m_radius[index] = sphere.radius;
+	}
+
+	BoundingSphere CullingBatch::get(const uint32_t index) const {
+		return { { m_center_x[index], m_center_y[index], m_center_z[index] }, m_radius[index] };
+	}
+
+	size_t CullingBatch::cull(const Frustum& frustum, std::vector<uint32_t>& visible) const {
+		return cull(frustum, visible, get_best_path());
+	}
+
+	size_t CullingBatch::cull(const Frustum& frustum, std::vector<uint32_t>& visible, Path path) const {
+		PROFILE_SCOPE("CullingBatch::cull");
+		if (path > get_best_path()) {
+			path = get_best_path();
+		}
+
+		const PlanesSoA planes = get_planes(frustum);
+		// padding is culled anyway, so the kernels may walk the whole padded range
+		const SpheresSoA spheres{ m_center_x.data(), m_center_y.data(), m_center_z.data(), m_radius.data(),
+			path == Path::Scalar ? m_count : m_radius.size() };
+
+		visible.resize(spheres.count);
+		size_t count = 0;
+		switch (path) {
+	#ifdef ENGINE_CULLING_X86
+		case Path::AVX2: count = cull_avx2(spheres, planes, visible.data()); break;
+		case Path::SSE: count = cull_sse(spheres, planes, visible.data()); break;
+	#endif
+		default: count = cull_scalar(spheres, planes, visible.data()); break;
+		}
+		visible.resize(count);
+		return count;
+	}
+
+}
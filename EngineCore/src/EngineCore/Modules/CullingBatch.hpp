@@ -0,0 +1,48 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include "EngineCore/Bounds.hpp"
+
+namespace EngineCore {
+
+	// Bounding spheres of many instances stored as structure of arrays, so the frustum test
+	// runs over 4 (SSE) or 8 (AVX2) spheres at once. The path is picked at runtime from the CPU features.
+	class CullingBatch {
+	public:
+		enum class Path {
+			Scalar, SSE, AVX2
+		};
+
+		void reserve(size_t count);
+		void clear();
+
+		uint32_t push_back(const BoundingSphere& sphere);
+		void set(uint32_t index, const BoundingSphere& sphere);
+		BoundingSphere get(uint32_t index) const;
+
+		size_t size() const { return m_count; }
+
+		// 'visible' receives indices of the spheres intersecting 'frustum' in ascending order,
+		// returns their count. The frustum must be in the same space as the spheres.
+		size_t cull(const Frustum& frustum, std::vector<uint32_t>& visible) const;
+		// forces a path, unsupported paths fall back to the best one available
+		size_t cull(const Frustum& frustum, std::vector<uint32_t>& visible, Path path) const;
+
+		static Path get_best_path();
+		static const char* get_path_name(Path path);
+
+	private:
+		void grow();
+
+		// padded to a multiple of 8 with spheres that are always culled, so kernels have no tail loop
+		std::vector<float> m_center_x;
+		std::vector<float> m_center_y;
+		std::vector<float> m_center_z;
+		std::vector<float> m_radius;
+		size_t m_count = 0;
+	};
+
+}
@@ -1,10 +1,24 @@
 #include <fstream>
 #include <memory>
+#include <filesystem>
+#include <algorithm>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 #include "FileRead.hpp"
 #include "EngineCore/Logs.hpp"
 
 #include <assimp/Importer.hpp>
+#include <assimp/DefaultIOSystem.h>
 #include <assimp/postprocess.h>
 
 #define STB_IMAGE_IMPLEMENTATION 1
@@ -17,37 +31,107 @@ namespace EngineCore {
 	}
 
 	Image_t::Image_t(unsigned char* img, int w, int h, int c, Image_t::format fmt):
-		image(img), width(w), height(h), channels(c), fmt(fmt)
+		image(img), fmt(fmt), width(w), height(h), channels(c)
 	{}
 
+	Image_t::Image_t(Image_t&& img) noexcept:
+		image(img.image), fmt(img.fmt), width(img.width), height(img.height), channels(img.channels)
+	{
+		img.image = nullptr;
+	}
+
 	Image_t read_image(const char* path) {
-		int width, height, channels;
-		unsigned char* data = stbi_load(path, &width, &height, &channels, 0);
-		LOG_INFO("[IMAGE DATA] size = {}x{}x{} | path = {}", width, height, channels, path);
+		const FileView file(path);
+		if (!file.is_open()) {
+			LOG_CATEGORY_ERROR(Assets, "READ_IMAGE_ERROR: Failed read from path: {}", path);
+			return { nullptr, 0, 0, 0, Image_t::format::PNG };
+		}
+		return read_image(file.bytes(), path);
+	}
+
+	Image_t read_image(std::span<const unsigned char> encoded, const char* name) {
+		int width = 0, height = 0, channels = 0;
+		unsigned char* data = stbi_load_from_memory(encoded.data(), static_cast<int>(encoded.size()), &width, &height, &channels, 0);
+		LOG_CATEGORY_INFO(Assets, "[IMAGE DATA] size = {}x{}x{} | path = {}", width, height, channels, name);
 		if (data == NULL) {
-			LOG_ERROR("READ_IMAGE_ERROR: Failed read from path: {}", path);
+			LOG_CATEGORY_ERROR(Assets, "READ_IMAGE_ERROR: Failed to decode '{}': {}", name, stbi_failure_reason());
 		}
 
 		return { data, width, height, channels, (channels == 3 ? Image_t::format::JPEG : Image_t::format::PNG)};
 	}
 
 	std::string read_file(const std::string& name) {
-		std::ifstream input(name);
-		if (input.is_open()) {
-			std::string res, buf;
-			while (std::getline(input, buf)) {
-				res += buf + '\n';
-			}
-			return std::move(res); 
+		const FileView file(name);
+		if (file.is_open()) {
+			return std::string(file.str());
 		}
 		LOG_CRITICAL("[FILE READ] Failed to read file '{}'", name);
 		return "";
 	};
 
+	FileView::FileView(std::string const& path, const Mode mode) {
+		if (mode == Mode::Map) {
+			m_mapped.emplace(path);
+			if (m_mapped->is_open()) {
+				m_open = true;
+				return;
+			}
+			// empty files can't be mapped, other failures get a second chance with a plain read
+			m_mapped.reset();
+		}
+		m_open = read(path);
+	}
+
+	bool FileView::read(std::string const& path) {
+		std::ifstream input(path, std::ios::binary | std::ios::ate);
+		if (!input.is_open()) {
+			return false;
+		}
+
+		const std::streamsize size = input.tellg();
+		if (size < 0) {
+			return false;
+		}
+		m_buffer.resize(static_cast<size_t>(size));
+		input.seekg(0);
+		return input.read(reinterpret_cast<char*>(m_buffer.data()), size).good();
+	}
+
 	static Assimp::Importer importer;
 
+	// default file access that remembers what was opened
+	class RecordingIOSystem : public Assimp::DefaultIOSystem {
+	public:
+		explicit RecordingIOSystem(std::vector<std::string>& files) : m_files(files) {}
+
+		Assimp::IOStream* Open(const char* file, const char* mode = "rb") override {
+			auto res = Assimp::DefaultIOSystem::Open(file, mode);
+			if (res && std::find(m_files.begin(), m_files.end(), file) == m_files.end()) {
+				m_files.emplace_back(file);
+			}
+			return res;
+		}
+
+	private:
+		std::vector<std::string>& m_files;
+	};
+
 	const aiScene* import_scene(std::string const& path, uint32_t flags) {
+		return import_scene(importer, path, flags);
+	}
+
+	const aiScene* import_scene(Assimp::Importer& importer, std::string const& path, uint32_t flags, std::vector<std::string>* read_files) {
+		std::vector<std::string> opened;
+		if (read_files) {
+			// owned by the importer, SetIOHandler(nullptr) below deletes it and restores the default
+			importer.SetIOHandler(new RecordingIOSystem(opened));
+		}
 		auto scene = importer.ReadFile(path.c_str(), flags);
+		if (read_files) {
+			importer.SetIOHandler(nullptr);
+			std::erase(opened, path);
+			*read_files = std::move(opened);
+		}
 
 		if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
 			LOG_CRITICAL("ASSIMP [IMPORT SCENE ERROR]: {}", importer.GetErrorString());
@@ -57,6 +141,92 @@ namespace EngineCore {
 		return scene;
 	}
 
+#ifdef _WIN32
 
+	MappedFile::MappedFile(std::string const& path) {
+		HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE) {
+			return;
+		}
+
+		LARGE_INTEGER file_size;
+		if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+			CloseHandle(file);
+			return;
+		}
+
+		HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mapping == nullptr) {
+			CloseHandle(file);
+			return;
+		}
+
+		m_data = static_cast<const unsigned char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+		if (m_data == nullptr) {
+			CloseHandle(mapping);
+			CloseHandle(file);
+			return;
+		}
+
+		m_size = static_cast<size_t>(file_size.QuadPart);
+		m_file_handle = file;
+		m_mapping_handle = mapping;
+	}
+
+	MappedFile::~MappedFile() {
+		if (m_data) {
+			UnmapViewOfFile(m_data);
+			CloseHandle(m_mapping_handle);
+			CloseHandle(m_file_handle);
+		}
+	}
+
+#else
+
+	MappedFile::MappedFile(std::string const& path) {
+		int fd = open(path.c_str(), O_RDONLY);
+		if (fd < 0) {
+			return;
+		}
+
+		struct stat st;
+		if (fstat(fd, &st) != 0 || st.st_size == 0) {
+			close(fd);
+			return;
+		}
+
+		void* ptr = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+		close(fd);
+		if (ptr == MAP_FAILED) {
+			return;
+		}
+
+		m_data = static_cast<const unsigned char*>(ptr);
+		m_size = static_cast<size_t>(st.st_size);
+	}
+
+	MappedFile::~MappedFile() {
+		if (m_data) {
+			munmap(const_cast<unsigned char*>(m_data), m_size);
+		}
+	}
+
+#endif
+
+	bool get_file_stamp(std::string const& path, uint64_t& mtime, uint64_t& size) {
+		std::error_code ec;
+		auto time = std::filesystem::last_write_time(path, ec);
+		if (ec) {
+			return false;
+		}
+		auto file_size = std::filesystem::file_size(path, ec);
+		if (ec) {
+			return false;
+		}
+
+		mtime = static_cast<uint64_t>(time.time_since_epoch().count());
+		size = static_cast<uint64_t>(file_size);
+		return true;
+	}
 
-}
\ No newline at end of file
+}
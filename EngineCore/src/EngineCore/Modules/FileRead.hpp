@@ -1,11 +1,21 @@
 #pragma once
 
+#include <span>
 #include <string>
+#include <vector>
+#include <optional>
+#include <string_view>
+#include <cstdint>
 
 #include <assimp/scene.h>
 
+namespace Assimp {
+	class Importer;
+}
+
 namespace EngineCore {
 
+	// copies the whole file, prefer FileView when the contents are only read once
 	std::string read_file(const std::string& name);
 	
 	struct Image_t {
@@ -25,13 +35,72 @@ namespace EngineCore {
 
 		Image_t(Image_t const&) = delete;
 		auto operator=(Image_t const&) = delete;
+		Image_t(Image_t&& img) noexcept;
 		
 
 	};
 
 	Image_t read_image(const char* path);
+	// decodes an encoded image held in memory, 'name' is only used for logging
+	Image_t read_image(std::span<const unsigned char> encoded, const char* name);
 
 	const aiScene* import_scene(std::string const& path, uint32_t flags);
 
+	// scene is owned by 'importer', use a separate importer per loading thread;
+	// 'read_files' gets every other file the import opened, like the material library of an .obj
+	const aiScene* import_scene(Assimp::Importer& importer, std::string const& path, uint32_t flags, std::vector<std::string>* read_files = nullptr);
+
+	class MappedFile {
+	public:
+		MappedFile(std::string const& path);
+		~MappedFile();
+
+		MappedFile(MappedFile const&) = delete;
+		MappedFile& operator=(MappedFile const&) = delete;
+
+		bool is_open() const { return m_data != nullptr; }
+		const unsigned char* data() const { return m_data; }
+		size_t size() const { return m_size; }
+
+	private:
+		const unsigned char* m_data = nullptr;
+		size_t m_size = 0;
+		void* m_file_handle = nullptr;
+		void* m_mapping_handle = nullptr;
+	};
+
+	// Read-only contents of a whole file. The file is mapped when possible, otherwise (or with
+	// Mode::Read) it is read into an owned buffer with a single read. The data is not null-terminated.
+	class FileView {
+	public:
+		enum class Mode {
+			Map, Read
+		};
+
+		FileView(std::string const& path, const Mode mode = Mode::Map);
+
+		FileView(FileView const&) = delete;
+		FileView& operator=(FileView const&) = delete;
+
+		// an empty file is open with size 0
+		bool is_open() const { return m_open; }
+		bool is_mapped() const { return m_mapped.has_value(); }
+
+		const unsigned char* data() const { return m_mapped ? m_mapped->data() : m_buffer.data(); }
+		size_t size() const { return m_mapped ? m_mapped->size() : m_buffer.size(); }
+
+		std::span<const unsigned char> bytes() const { return { data(), size() }; }
+		std::string_view str() const { return { reinterpret_cast<const char*>(data()), size() }; }
+
+	private:
+		bool read(std::string const& path);
+
+		std::optional<MappedFile> m_mapped;
+		std::vector<unsigned char> m_buffer;
+		bool m_open = false;
+	};
+
+	bool get_file_stamp(std::string const& path, uint64_t& mtime, uint64_t& size);
+
 
 }
\ No newline at end of file
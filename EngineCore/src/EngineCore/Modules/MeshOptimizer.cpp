@@ -0,0 +1,478 @@
+#include "MeshOptimizer.hpp"
+#include "EngineCore/Lod.hpp"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <numeric>
+#include <cstring>
+#include <cmath>
+#include <unordered_map>
+
+namespace EngineCore {
+
+	static constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+	// bumped when a pass changes its output for the same options
+	static constexpr uint32_t OPTIMIZER_VERSION = 2;
+	// a level keeping more than this fraction of the previous one's indices is dropped
+	static constexpr float MIN_LOD_SAVING = 0.9f;
+
+	uint32_t MeshOptimizeOptions::get_cache_key() const {
+		const uint32_t flags = (deduplicate ? 1u : 0u)
+			| (vertex_cache ? 2u : 0u)
+			| (overdraw ? 4u : 0u)
+			| (vertex_fetch ? 8u : 0u);
+		const uint32_t fields[] = {
+			OPTIMIZER_VERSION,
+			flags,
+			static_cast<uint32_t>(std::lround(overdraw_threshold * 1000.f)),
+			lod_levels,
+			static_cast<uint32_t>(std::lround(lod_reduction * 1000.f)),
+			static_cast<uint32_t>(std::lround(lod_max_error * 1000.f)),
+		};
+
+		uint32_t hash = 2166136261u;
+		for (auto field : fields) {
+			hash = (hash ^ field) * 16777619u;
+		}
+		return hash;
+	}
+
+	void VertexCacheStats::merge(VertexCacheStats const& stats) {
+		triangles += stats.triangles;
+		vertices += stats.vertices;
+		misses += stats.misses;
+	}
+
+	void MeshOptimizeReport::merge(MeshOptimizeReport const& report) {
+		input.merge(report.input);
+		deduplicated.merge(report.deduplicated);
+		vertex_cache.merge(report.vertex_cache);
+		overdraw.merge(report.overdraw);
+		vertex_fetch.merge(report.vertex_fetch);
+	}
+
+	// FIFO cache of 'size' entries: a vertex is a hit while fewer than 'size' misses happened since its own
+	class FifoCache {
+	public:
+		FifoCache(const size_t vertex_count, const uint32_t size)
+			: m_stamps(vertex_count, 0)
+			, m_time(size + 1)
+			, m_size(size)
+		{}
+
+		bool is_new(const uint32_t vertex) const { return m_stamps[vertex] == 0; }
+
+		// true on a miss
+		bool access(const uint32_t vertex) {
+			if (m_time - m_stamps[vertex] > m_size) {
+				m_stamps[vertex] = m_time++;
+				return true;
+			}
+			return false;
+		}
+
+		void flush() { m_time += m_size + 1; }
+
+	private:
+		std::vector<uint32_t> m_stamps;
+		uint32_t m_time;
+		uint32_t m_size;
+	};
+
+	VertexCacheStats analyze_vertex_cache(std::span<const uint32_t> indices, const size_t vertex_count, const uint32_t cache_size) {
+		VertexCacheStats res;
+		res.triangles = indices.size() / 3;
+
+		FifoCache cache(vertex_count, cache_size);
+		for (auto index : indices) {
+			if (cache.is_new(index)) {
+				++res.vertices;
+			}
+			if (cache.access(index)) {
+				++res.misses;
+			}
+		}
+		return res;
+	}
+
+	struct VertexHash {
+		size_t operator()(Vertex const& vertex) const {
+			// FNV-1a over the raw bytes, Vertex has no padding
+			const auto bytes = reinterpret_cast<const unsigned char*>(&vertex);
+			uint64_t hash = 14695981039346656037ull;
+			for (size_t i = 0; i < sizeof(Vertex); ++i) {
+				hash = (hash ^ bytes[i]) * 1099511628211ull;
+			}
+			return static_cast<size_t>(hash);
+		}
+	};
+
+	struct VertexEqual {
+		bool operator()(Vertex const& a, Vertex const& b) const {
+			return std::memcmp(&a, &b, sizeof(Vertex)) == 0;
+		}
+	};
+
+	void deduplicate_vertices(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices) {
+		std::unordered_map<Vertex, uint32_t, VertexHash, VertexEqual> unique;
+		unique.reserve(vertices.size());
+
+		std::vector<uint32_t> remap(vertices.size());
+		std::vector<Vertex> res;
+		res.reserve(vertices.size());
+		for (size_t i = 0; i < vertices.size(); ++i) {
+			auto [it, inserted] = unique.try_emplace(vertices[i], static_cast<uint32_t>(res.size()));
+			if (inserted) {
+				res.push_back(vertices[i]);
+			}
+			remap[i] = it->second;
+		}
+
+		for (auto& index : indices) {
+			index = remap[index];
+		}
+		vertices = std::move(res);
+	}
+
+	// Tom Forsyth, "Linear-Speed Vertex Cache Optimisation": greedy triangle order by a score
+	// that favours vertices recently used and vertices with few triangles left
+	static constexpr size_t FORSYTH_CACHE_SIZE = 32;
+	static constexpr float FORSYTH_DECAY_POWER = 1.5f;
+	static constexpr float FORSYTH_LAST_TRIANGLE_SCORE = 0.75f;
+	static constexpr float FORSYTH_VALENCE_SCALE = 2.f;
+	static constexpr float FORSYTH_VALENCE_POWER = 0.5f;
+
+	static float forsyth_score(const int cache_position, const uint32_t live_triangles) {
+		if (live_triangles == 0) {
+			return -1.f;
+		}
+
+		float score = 0.f;
+		if (cache_position >= 0) {
+			if (cache_position < 3) {
+				score = FORSYTH_LAST_TRIANGLE_SCORE;
+			}
+			else {
+				const float scaler = 1.f / (FORSYTH_CACHE_SIZE - 3);
+				score = std::pow(1.f - (cache_position - 3) * scaler, FORSYTH_DECAY_POWER);
+			}
+		}
+		return score + FORSYTH_VALENCE_SCALE * std::pow(static_cast<float>(live_triangles), -FORSYTH_VALENCE_POWER);
+	}
+
+	void optimize_vertex_cache(std::vector<uint32_t>& indices, const size_t vertex_count) {
+		const size_t triangle_count = indices.size() / 3;
+		if (triangle_count == 0 || indices.size() % 3 != 0) {
+			return;
+		}
+
+		// triangles of every vertex, live ones are kept in front of each range
+		std::vector<uint32_t> live(vertex_count, 0);
+		for (auto index : indices) {
+			++live[index];
+		}
+		std::vector<uint32_t> offsets(vertex_count + 1, 0);
+		std::inclusive_scan(live.begin(), live.end(), offsets.begin() + 1);
+		std::vector<uint32_t> adjacency(indices.size());
+		{
+			std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+			for (size_t t = 0; t < triangle_count; ++t) {
+				for (size_t k = 0; k < 3; ++k) {
+					adjacency[fill[indices[t * 3 + k]]++] = static_cast<uint32_t>(t);
+				}
+			}
+		}
+
+		std::vector<float> vertex_scores(vertex_count);
+		for (size_t v = 0; v < vertex_count; ++v) {
+			vertex_scores[v] = forsyth_score(-1, live[v]);
+		}
+
+		std::vector<bool> emitted(triangle_count, false);
+		std::vector<uint32_t> res;
+		res.reserve(indices.size());
+
+		std::vector<uint32_t> cache, next_cache;
+		cache.reserve(FORSYTH_CACHE_SIZE + 3);
+		next_cache.reserve(FORSYTH_CACHE_SIZE + 3);
+
+		// start at the triangle with the fewest neighbours, the valence term dominates an empty cache
+		uint32_t best = 0;
+		float best_score = -1.f;
+		for (size_t t = 0; t < triangle_count; ++t) {
+			const float score = vertex_scores[indices[t * 3]] + vertex_scores[indices[t * 3 + 1]] + vertex_scores[indices[t * 3 + 2]];
+			if (score > best_score) {
+				best_score = score;
+				best = static_cast<uint32_t>(t);
+			}
+		}
+
+		size_t cursor = 0;
+
+		while (best != INVALID_INDEX) {
+			emitted[best] = true;
+			const uint32_t* triangle = &indices[best * 3];
+			for (size_t k = 0; k < 3; ++k) {
+				const uint32_t v = triangle[k];
+				res.push_back(v);
+
+				// move 'best' out of the live part of the vertex range
+				uint32_t* first = &adjacency[offsets[v]];
+				uint32_t* last = first + live[v];
+				std::iter_swap(std::find(first, last, best), last - 1);
+				--live[v];
+			}
+
+			next_cache.assign(triangle, triangle + 3);
+			for (auto v : cache) {
+				if (v != triangle[0] && v != triangle[1] && v != triangle[2]) {
+					next_cache.push_back(v);
+				}
+			}
+
+			// evicted vertices lose their cache score, the rest get their new position
+			for (size_t i = 0; i < next_cache.size(); ++i) {
+				const uint32_t v = next_cache[i];
+				const int position = i < FORSYTH_CACHE_SIZE ? static_cast<int>(i) : -1;
+				vertex_scores[v] = forsyth_score(position, live[v]);
+			}
+			if (next_cache.size() > FORSYTH_CACHE_SIZE) {
+				next_cache.resize(FORSYTH_CACHE_SIZE);
+			}
+			std::swap(cache, next_cache);
+
+			best = INVALID_INDEX;
+			best_score = -1.f;
+			for (auto v : cache) {
+				for (uint32_t i = offsets[v]; i < offsets[v] + live[v]; ++i) {
+					const uint32_t t = adjacency[i];
+					const float score = vertex_scores[indices[t * 3]] + vertex_scores[indices[t * 3 + 1]] + vertex_scores[indices[t * 3 + 2]];
+					if (score > best_score) {
+						best_score = score;
+						best = t;
+					}
+				}
+			}
+
+			// nothing left around the cache: continue with the first triangle not drawn yet
+			if (best == INVALID_INDEX) {
+				while (cursor < triangle_count && emitted[cursor]) {
+					++cursor;
+				}
+				if (cursor < triangle_count) {
+					best = static_cast<uint32_t>(cursor);
+				}
+			}
+		}
+
+		indices = std::move(res);
+	}
+
+	// Sander, Nehab, Barczak, "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw":
+	// the cache optimized order is cut into clusters that keep its ACMR within 'threshold',
+	// then clusters facing away from the mesh center are drawn first
+	void optimize_overdraw(std::vector<uint32_t>& indices, std::span<const Vertex> vertices, const float threshold) {
+		const size_t triangle_count = indices.size() / 3;
+		if (triangle_count < 2 || indices.size() % 3 != 0) {
+			return;
+		}
+
+		auto triangle_misses = [&](FifoCache& cache, const size_t t) {
+			return static_cast<uint32_t>(cache.access(indices[t * 3]))
+				+ static_cast<uint32_t>(cache.access(indices[t * 3 + 1]))
+				+ static_cast<uint32_t>(cache.access(indices[t * 3 + 2]));
+		};
+
+		// hard boundaries: the cache is flushed there anyway, every vertex of the triangle misses
+		std::vector<size_t> hard{ 0 };
+		{
+			FifoCache cache(vertices.size(), ANALYZE_CACHE_SIZE);
+			triangle_misses(cache, 0);
+			for (size_t t = 1; t < triangle_count; ++t) {
+				if (triangle_misses(cache, t) == 3) {
+					hard.push_back(t);
+				}
+			}
+			hard.push_back(triangle_count);
+		}
+
+		// soft boundaries: split a hard cluster as soon as its running ACMR is good enough
+		std::vector<size_t> clusters;
+		FifoCache cache(vertices.size(), ANALYZE_CACHE_SIZE);
+		for (size_t h = 0; h + 1 < hard.size(); ++h) {
+			const size_t start = hard[h];
+			const size_t end = hard[h + 1];
+
+			cache.flush();
+			uint32_t cluster_misses = 0;
+			for (size_t t = start; t < end; ++t) {
+				cluster_misses += triangle_misses(cache, t);
+			}
+			const float limit = threshold * static_cast<float>(cluster_misses) / static_cast<float>(end - start);
+
+			cache.flush();
+			clusters.push_back(start);
+			uint32_t misses = 0;
+			uint32_t count = 0;
+			for (size_t t = start; t < end; ++t) {
+				misses += triangle_misses(cache, t);
+				++count;
+				if (t + 1 < end && static_cast<float>(misses) / count <= limit) {
+					clusters.push_back(t + 1);
+					cache.flush();
+					misses = 0;
+					count = 0;
+				}
+			}
+		}
+		clusters.push_back(triangle_count);
+
+		// area weighted centroid and normal of every cluster, and of the whole mesh
+		const size_t cluster_count = clusters.size() - 1;
+		std::vector<glm::vec3> centroids(cluster_count, glm::vec3(0.f));
+		std::vector<glm::vec3> normals(cluster_count, glm::vec3(0.f));
+		std::vector<float> areas(cluster_count, 0.f);
+		glm::vec3 mesh_centroid(0.f);
+		float mesh_area = 0.f;
+
+		for (size_t c = 0; c < cluster_count; ++c) {
+			for (size_t t = clusters[c]; t < clusters[c + 1]; ++t) {
+				const glm::vec3& a = vertices[indices[t * 3]].position;
+				const glm::vec3& b = vertices[indices[t * 3 + 1]].position;
+				const glm::vec3& d = vertices[indices[t * 3 + 2]].position;
+
+				const glm::vec3 normal = glm::cross(b - a, d - a);
+				const float area = glm::length(normal);
+				const glm::vec3 center = (a + b + d) / 3.f;
+
+				centroids[c] += center * area;
+				normals[c] += normal;
+				areas[c] += area;
+			}
+			mesh_centroid += centroids[c];
+			mesh_area += areas[c];
+		}
+		if (mesh_area > 0.f) {
+			mesh_centroid /= mesh_area;
+		}
+
+		std::vector<float> keys(cluster_count, 0.f);
+		for (size_t c = 0; c < cluster_count; ++c) {
+			const float normal_length = glm::length(normals[c]);
+			if (areas[c] > 0.f && normal_length > 0.f) {
+				keys[c] = glm::dot(centroids[c] / areas[c] - mesh_centroid, normals[c] / normal_length);
+			}
+		}
+
+		std::vector<uint32_t> order(cluster_count);
+		std::iota(order.begin(), order.end(), 0u);
+		std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return keys[a] > keys[b]; });
+
+		std::vector<uint32_t> res;
+		res.reserve(indices.size());
+		for (auto c : order) {
+			res.insert(res.end(), indices.begin() + clusters[c] * 3, indices.begin() + clusters[c + 1] * 3);
+		}
+		indices = std::move(res);
+	}
+
+	void optimize_vertex_fetch(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices) {
+		std::vector<uint32_t> remap(vertices.size(), INVALID_INDEX);
+		uint32_t next = 0;
+		for (auto& index : indices) {
+			if (remap[index] == INVALID_INDEX) {
+				remap[index] = next++;
+			}
+			index = remap[index];
+		}
+
+		// vertices no triangle uses are dropped
+		std::vector<Vertex> res(next);
+		for (size_t i = 0; i < vertices.size(); ++i) {
+			if (remap[i] != INVALID_INDEX) {
+				res[remap[i]] = vertices[i];
+			}
+		}
+		vertices = std::move(res);
+	}
+
+	MeshOptimizeReport optimize_mesh(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, MeshOptimizeOptions const& options) {
+		MeshOptimizeReport report;
+		report.input = analyze_vertex_cache(indices, vertices.size());
+
+		if (options.deduplicate) {
+			deduplicate_vertices(vertices, indices);
+			report.deduplicated = analyze_vertex_cache(indices, vertices.size());
+		}
+		else {
+			report.deduplicated = report.input;
+		}
+
+		if (options.vertex_cache) {
+			optimize_vertex_cache(indices, vertices.size());
+			report.vertex_cache = analyze_vertex_cache(indices, vertices.size());
+		}
+		else {
+			report.vertex_cache = report.deduplicated;
+		}
+
+		if (options.overdraw) {
+			optimize_overdraw(indices, vertices, options.overdraw_threshold);
+			report.overdraw = analyze_vertex_cache(indices, vertices.size());
+		}
+		else {
+			report.overdraw = report.vertex_cache;
+		}
+
+		if (options.vertex_fetch) {
+			optimize_vertex_fetch(vertices, indices);
+			report.vertex_fetch = analyze_vertex_cache(indices, vertices.size());
+		}
+		else {
+			report.vertex_fetch = report.overdraw;
+		}
+
+		return report;
+	}
+
+	std::vector<MeshLod> build_lods(std::span<const Vertex> vertices, std::vector<uint32_t>& indices, MeshOptimizeOptions const& options) {
+		std::vector<MeshLod> res{ { 0, static_cast<uint32_t>(indices.size()), 0.f } };
+		if (vertices.empty() || indices.empty()) {
+			return res;
+		}
+
+		glm::vec3 min = vertices[0].position, max = vertices[0].position;
+		for (auto const& vertex : vertices) {
+			min = glm::min(min, vertex.position);
+			max = glm::max(max, vertex.position);
+		}
+		const float max_error = options.lod_max_error * glm::length(max - min) * 0.5f;
+
+		// every level is simplified from the previous one, errors add up along the chain
+		std::vector<uint32_t> level(indices.begin(), indices.end());
+		const uint32_t levels = std::min(options.lod_levels, MAX_LOD_LEVELS);
+		for (uint32_t i = 1; i < levels; ++i) {
+			const float budget = max_error - res.back().error;
+			if (budget <= 0.f) {
+				break;
+			}
+
+			const size_t target = static_cast<size_t>(static_cast<float>(level.size()) * options.lod_reduction) / 3 * 3;
+			float error = 0.f;
+			auto simplified = simplify_mesh(vertices, level, target, budget, error);
+			if (simplified.empty() || static_cast<float>(simplified.size()) > static_cast<float>(level.size()) * MIN_LOD_SAVING) {
+				break;
+			}
+			if (options.vertex_cache) {
+				optimize_vertex_cache(simplified, vertices.size());
+			}
+
+			res.push_back({ static_cast<uint32_t>(indices.size()), static_cast<uint32_t>(simplified.size()), res.back().error + error });
+			indices.insert(indices.end(), simplified.begin(), simplified.end());
+			level = std::move(simplified);
+		}
+		return res;
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <span>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include "EngineCore/Rendering/OpenGL/VertexBuffer.hpp"
+#include "EngineCore/Modules/MeshSimplifier.hpp"
+
+namespace EngineCore {
+
+	// Post-import passes over a triangle list, run in this order:
+	// identical vertices are merged, triangles are reordered for the post-transform vertex cache,
+	// then clusters of them are reordered to draw outward facing surfaces first, and at last
+	// vertices are renumbered in the order the index buffer fetches them.
+	struct MeshOptimizeOptions {
+		bool deduplicate = true;
+		bool vertex_cache = true;
+		bool overdraw = true;
+		bool vertex_fetch = true;
+		// overdraw clusters may be this much worse in ACMR than the cache optimized order
+		float overdraw_threshold = 1.05f;
+
+		// levels of detail built by build_lods, the full mesh included; at most MAX_LOD_LEVELS
+		uint32_t lod_levels = 4;
+		// index count of a level relative to the previous one
+		float lod_reduction = 0.5f;
+		// largest error of the coarsest level, relative to the bounding radius of the mesh
+		float lod_max_error = 0.1f;
+
+		// changes whenever the output would, part of the ModelCache key
+		uint32_t get_cache_key() const;
+	};
+
+	// misses of a FIFO cache simulation; raw counts, so stats of several meshes can be summed
+	struct VertexCacheStats {
+		size_t triangles = 0;
+		size_t vertices = 0;
+		size_t misses = 0;
+
+		// average cache miss ratio: transformed vertices per triangle, 0.5 at best
+		float get_acmr() const { return triangles ? static_cast<float>(misses) / triangles : 0.f; }
+		// average transform to vertex ratio: 1.0 means every vertex is transformed once
+		float get_atvr() const { return vertices ? static_cast<float>(misses) / vertices : 0.f; }
+
+		void merge(VertexCacheStats const& stats);
+	};
+
+	// stats after every pass, a disabled pass repeats the previous entry
+	struct MeshOptimizeReport {
+		VertexCacheStats input;
+		VertexCacheStats deduplicated;
+		VertexCacheStats vertex_cache;
+		VertexCacheStats overdraw;
+		VertexCacheStats vertex_fetch;
+
+		void merge(MeshOptimizeReport const& report);
+	};
+
+	static constexpr uint32_t ANALYZE_CACHE_SIZE = 16;
+
+	VertexCacheStats analyze_vertex_cache(std::span<const uint32_t> indices, const size_t vertex_count, const uint32_t cache_size = ANALYZE_CACHE_SIZE);
+
+	MeshOptimizeReport optimize_mesh(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, MeshOptimizeOptions const& options);
+
+	// single passes, 'indices' is a triangle list
+	void deduplicate_vertices(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices);
+	void optimize_vertex_cache(std::vector<uint32_t>& indices, const size_t vertex_count);
+	void optimize_overdraw(std::vector<uint32_t>& indices, std::span<const Vertex> vertices, const float threshold);
+	void optimize_vertex_fetch(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices);
+
+	// appends simplified levels to 'indices', each reordered for the vertex cache; the first entry is
+	// the input list. Stops early once a level saves too little within the error limit.
+	std::vector<MeshLod> build_lods(std::span<const Vertex> vertices, std::vector<uint32_t>& indices, MeshOptimizeOptions const& options);
+
+}
\ No newline at end of file
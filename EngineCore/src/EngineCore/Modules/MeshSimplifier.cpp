@@ -0,0 +1,321 @@
+#include "MeshSimplifier.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <cstring>
+#include <cmath>
+#include <unordered_map>
+
+namespace EngineCore {
+
+	// border edges get a plane through them, perpendicular to their triangle, this much heavier than area
+	static constexpr double BORDER_WEIGHT = 10.0;
+	// cosine of the largest turn a triangle around the moved vertex may take
+	static constexpr float MIN_NORMAL_DOT = 0.5f;
+
+	// symmetric 4x4 plane quadric; 'weight' is the summed area, so evaluate() is a mean squared distance
+	struct Quadric {
+		double a2 = 0, b2 = 0, c2 = 0, ab = 0, ac = 0, bc = 0, ad = 0, bd = 0, cd = 0, d2 = 0;
+		double weight = 0;
+
+		static Quadric from_plane(const glm::vec3& normal, const float distance, const double weight) {
+			const double a = normal.x, b = normal.y, c = normal.z, d = distance;
+			Quadric res;
+			res.a2 = weight * a * a; res.b2 = weight * b * b; res.c2 = weight * c * c;
+			res.ab = weight * a * b; res.ac = weight * a * c; res.bc = weight * b * c;
+			res.ad = weight * a * d; res.bd = weight * b * d; res.cd = weight * c * d;
+			res.d2 = weight * d * d;
+			res.weight = weight;
+			return res;
+		}
+
+		void add(Quadric const& other) {
+			a2 += other.a2; b2 += other.b2; c2 += other.c2;
+			ab += other.ab; ac += other.ac; bc += other.bc;
+			ad += other.ad; bd += other.bd; cd += other.cd;
+			d2 += other.d2;
+			weight += other.weight;
+		}
+
+		double evaluate(const glm::vec3& point) const {
+			const double x = point.x, y = point.y, z = point.z;
+			const double res = a2 * x * x + b2 * y * y + c2 * z * z
+				+ 2.0 * (ab * x * y + ac * x * z + bc * y * z)
+				+ 2.0 * (ad * x + bd * y + cd * z)
+				+ d2;
+			return weight > 0.0 ? std::abs(res) / weight : 0.0;
+		}
+	};
+
+	struct PositionHash {
+		size_t operator()(glm::vec3 const& position) const {
+			uint32_t bits[3];
+			std::memcpy(bits, &position, sizeof(bits));
+			uint64_t hash = 14695981039346656037ull;
+			for (auto word : bits) {
+				hash = (hash ^ word) * 1099511628211ull;
+			}
+			return static_cast<size_t>(hash);
+		}
+	};
+
+	struct PositionEqual {
+		bool operator()(glm::vec3 const& a, glm::vec3 const& b) const {
+			return std::memcmp(&a, &b, sizeof(glm::vec3)) == 0;
+		}
+	};
+
+	static uint64_t edge_key(const uint32_t a, const uint32_t b) {
+		return a < b ? (uint64_t(a) << 32 | b) : (uint64_t(b) << 32 | a);
+	}
+
+	static float attribute_distance(Vertex const& a, Vertex const& b) {
+		const glm::vec3 normal = a.normal - b.normal;
+		const glm::vec2 texture_position = a.texture_position - b.texture_position;
+		return glm::dot(normal, normal) + glm::dot(texture_position, texture_position);
+	}
+
+	std::vector<uint32_t> simplify_mesh(
+		std::span<const Vertex> vertices,
+		std::span<const uint32_t> indices,
+		const size_t target_index_count,
+		const float max_error,
+		float& error
+	) {
+		error = 0.f;
+		std::vector<uint32_t> res(indices.begin(), indices.end());
+		if (res.size() <= target_index_count || vertices.empty()) {
+			return res;
+		}
+		const auto vertex_count = static_cast<uint32_t>(vertices.size());
+
+		// the first vertex at a position stands for all of them: it owns the quadric and takes part in collapses
+		std::vector<uint32_t> position_of(vertex_count);
+		{
+			std::unordered_map<glm::vec3, uint32_t, PositionHash, PositionEqual> first;
+			first.reserve(vertex_count);
+			for (uint32_t i = 0; i < vertex_count; ++i) {
+				position_of[i] = first.try_emplace(vertices[i].position, i).first->second;
+			}
+		}
+
+		// vertices sharing each position, so a collapsed vertex can pick the closest one at the target
+		std::vector<uint32_t> wedge_offsets(vertex_count + 1, 0);
+		std::vector<uint32_t> wedges(vertex_count);
+		for (uint32_t i = 0; i < vertex_count; ++i) {
+			++wedge_offsets[position_of[i] + 1];
+		}
+		std::partial_sum(wedge_offsets.begin(), wedge_offsets.end(), wedge_offsets.begin());
+		{
+			std::vector<uint32_t> cursor(wedge_offsets.begin(), wedge_offsets.end() - 1);
+			for (uint32_t i = 0; i < vertex_count; ++i) {
+				wedges[cursor[position_of[i]]++] = i;
+			}
+		}
+
+		auto position = [&](const uint32_t vertex) -> const glm::vec3& { return vertices[vertex].position; };
+
+		std::unordered_map<uint64_t, uint32_t> edge_uses;
+		auto count_edges = [&]() {
+			edge_uses.clear();
+			for (size_t i = 0; i < res.size(); i += 3) {
+				for (size_t k = 0; k < 3; ++k) {
+					const uint32_t a = position_of[res[i + k]];
+					const uint32_t b = position_of[res[i + (k + 1) % 3]];
+					if (a != b) {
+						++edge_uses[edge_key(a, b)];
+					}
+				}
+			}
+		};
+
+		std::vector<Quadric> quadrics(vertex_count);
+		count_edges();
+		for (size_t i = 0; i < res.size(); i += 3) {
+			const uint32_t corners[3] = { position_of[res[i]], position_of[res[i + 1]], position_of[res[i + 2]] };
+			const glm::vec3 cross = glm::cross(position(corners[1]) - position(corners[0]), position(corners[2]) - position(corners[0]));
+			const float length = glm::length(cross);
+			if (length == 0.f) {
+				continue;
+			}
+			const glm::vec3 normal = cross / length;
+
+			const auto plane = Quadric::from_plane(normal, -glm::dot(normal, position(corners[0])), 0.5 * length);
+			for (auto corner : corners) {
+				quadrics[corner].add(plane);
+			}
+
+			for (size_t k = 0; k < 3; ++k) {
+				const uint32_t a = corners[k], b = corners[(k + 1) % 3];
+				if (a == b || edge_uses[edge_key(a, b)] != 1) {
+					continue;
+				}
+				const glm::vec3 edge = position(b) - position(a);
+				const glm::vec3 border_cross = glm::cross(edge, normal);
+				const float border_length = glm::length(border_cross);
+				if (border_length == 0.f) {
+					continue;
+				}
+				const glm::vec3 border_normal = border_cross / border_length;
+				const auto border = Quadric::from_plane(border_normal, -glm::dot(border_normal, position(a)), BORDER_WEIGHT * glm::dot(edge, edge));
+				quadrics[a].add(border);
+				quadrics[b].add(border);
+			}
+		}
+
+		struct Collapse {
+			uint32_t from;
+			uint32_t to;
+			double cost;
+		};
+
+		const double max_cost = static_cast<double>(max_error) * max_error;
+		double max_collapse_cost = 0.0;
+
+		std::vector<uint32_t> collapse(vertex_count);
+		std::vector<unsigned char> locked(vertex_count);
+		std::vector<unsigned char> border(vertex_count);
+		std::vector<uint32_t> adjacency_offsets(vertex_count + 1);
+		std::vector<uint32_t> adjacency;
+		std::vector<Collapse> candidates;
+
+		// a triangle around 'from' that keeps its area has to keep facing roughly the same way
+		auto flips = [&](const uint32_t from, const uint32_t to) {
+			for (uint32_t j = adjacency_offsets[from]; j < adjacency_offsets[from + 1]; ++j) {
+				const size_t triangle = adjacency[j] * size_t(3);
+				uint32_t corners[3] = { position_of[res[triangle]], position_of[res[triangle + 1]], position_of[res[triangle + 2]] };
+				if (corners[0] == to || corners[1] == to || corners[2] == to) {
+					continue;
+				}
+				const glm::vec3 before = glm::cross(position(corners[1]) - position(corners[0]), position(corners[2]) - position(corners[0]));
+				for (auto& corner : corners) {
+					corner = corner == from ? to : corner;
+				}
+				const glm::vec3 after = glm::cross(position(corners[1]) - position(corners[0]), position(corners[2]) - position(corners[0]));
+
+				const float length = glm::length(before) * glm::length(after);
+				if (length == 0.f || glm::dot(before, after) < MIN_NORMAL_DOT * length) {
+					return true;
+				}
+			}
+			return false;
+		};
+
+		const size_t target_triangles = target_index_count / 3;
+		while (res.size() / 3 > target_triangles) {
+			const size_t triangle_count = res.size() / 3;
+
+			// edges used by one triangle are open borders, by more than two non-manifold
+			count_edges();
+			std::fill(border.begin(), border.end(), 0);
+			for (auto const& [key, uses] : edge_uses) {
+				if (uses != 2) {
+					border[key >> 32] = 1;
+					border[key & 0xFFFFFFFF] = 1;
+				}
+			}
+
+			std::fill(adjacency_offsets.begin(), adjacency_offsets.end(), 0);
+			for (auto index : res) {
+				++adjacency_offsets[position_of[index] + 1];
+			}
+			std::partial_sum(adjacency_offsets.begin(), adjacency_offsets.end(), adjacency_offsets.begin());
+			adjacency.resize(res.size());
+			{
+				std::vector<uint32_t> cursor(adjacency_offsets.begin(), adjacency_offsets.end() - 1);
+				for (size_t i = 0; i < res.size(); ++i) {
+					adjacency[cursor[position_of[res[i]]]++] = static_cast<uint32_t>(i / 3);
+				}
+			}
+
+			candidates.clear();
+			for (auto const& [key, uses] : edge_uses) {
+				if (uses > 2) {
+					continue;
+				}
+				const auto a = static_cast<uint32_t>(key >> 32);
+				const auto b = static_cast<uint32_t>(key & 0xFFFFFFFF);
+				for (auto [from, to] : { std::pair{ a, b }, std::pair{ b, a } }) {
+					// a border vertex may only slide along its border, or the hole would grow
+					if (border[from] && uses != 1) {
+						continue;
+					}
+					Quadric quadric = quadrics[from];
+					quadric.add(quadrics[to]);
+					candidates.push_back({ from, to, quadric.evaluate(position(to)) });
+				}
+			}
+			std::sort(candidates.begin(), candidates.end(),
+				[](Collapse const& a, Collapse const& b) { return a.cost < b.cost; });
+
+			std::iota(collapse.begin(), collapse.end(), 0u);
+			std::fill(locked.begin(), locked.end(), 0);
+
+			// cheapest first over the whole mesh; everything around a moved vertex is locked
+			// for the rest of the pass, so the flip test of later collapses stays valid
+			const size_t to_remove = triangle_count - target_triangles;
+			size_t removed = 0;
+			size_t collapses = 0;
+			for (auto const& candidate : candidates) {
+				if (removed >= to_remove || candidate.cost > max_cost) {
+					break;
+				}
+				if (locked[candidate.from] || locked[candidate.to] || flips(candidate.from, candidate.to)) {
+					continue;
+				}
+
+				collapse[candidate.from] = candidate.to;
+				quadrics[candidate.to].add(quadrics[candidate.from]);
+				max_collapse_cost = std::max(max_collapse_cost, candidate.cost);
+
+				for (uint32_t j = adjacency_offsets[candidate.from]; j < adjacency_offsets[candidate.from + 1]; ++j) {
+					const size_t triangle = adjacency[j] * size_t(3);
+					for (size_t k = 0; k < 3; ++k) {
+						locked[position_of[res[triangle + k]]] = 1;
+					}
+				}
+				locked[candidate.to] = 1;
+
+				removed += border[candidate.from] ? 1 : 2;
+				++collapses;
+			}
+
+			if (collapses == 0) {
+				break;
+			}
+
+			for (auto& index : res) {
+				const uint32_t to = collapse[position_of[index]];
+				if (to == position_of[index]) {
+					continue;
+				}
+				uint32_t best = to;
+				float best_distance = attribute_distance(vertices[index], vertices[to]);
+				for (uint32_t j = wedge_offsets[to]; j < wedge_offsets[to + 1]; ++j) {
+					const float distance = attribute_distance(vertices[index], vertices[wedges[j]]);
+					if (distance < best_distance) {
+						best = wedges[j];
+						best_distance = distance;
+					}
+				}
+				index = best;
+			}
+
+			size_t write = 0;
+			for (size_t i = 0; i < res.size(); i += 3) {
+				const uint32_t a = position_of[res[i]], b = position_of[res[i + 1]], c = position_of[res[i + 2]];
+				if (a == b || b == c || a == c) {
+					continue;
+				}
+				res[write++] = res[i];
+				res[write++] = res[i + 1];
+				res[write++] = res[i + 2];
+			}
+			res.resize(write);
+		}
+
+		error = static_cast<float>(std::sqrt(max_collapse_cost));
+		return res;
+	}
+
+}
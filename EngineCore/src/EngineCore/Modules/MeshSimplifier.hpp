@@ -0,0 +1,32 @@
+#pragma once
+
+#include <span>
+#include <vector>
+#include <cstdint>
+
+#include "EngineCore/Rendering/OpenGL/VertexBuffer.hpp"
+
+namespace EngineCore {
+
+	// One level of detail: a range of the mesh index list, all levels share the vertices
+	struct MeshLod {
+		uint32_t first_index = 0;
+		uint32_t index_count = 0;
+		// rms distance to the surface of the full mesh, in model space
+		float error = 0.f;
+	};
+
+	// Quadric error metric edge collapse (Garland & Heckbert). Vertices only move onto other
+	// vertices of the mesh, so the result indexes 'vertices' as they are. Vertices at the same
+	// position (uv or normal seams) collapse together, open borders only collapse along themselves.
+	// Stops at 'target_index_count' or when the next collapse would exceed 'max_error';
+	// 'error' receives the largest error of the collapses done.
+	std::vector<uint32_t> simplify_mesh(
+		std::span<const Vertex> vertices,
+		std::span<const uint32_t> indices,
+		const size_t target_index_count,
+		const float max_error,
+		float& error
+	);
+
+}
@@ -0,0 +1,244 @@
+#include "ModelCache.hpp"
+#include "EngineCore/Logs.hpp"
+
+#include <fstream>
+#include <cstring>
+#include <cstdio>
+
+namespace EngineCore {
+
+	static constexpr char CACHE_MAGIC[4] = { 'S', '3', 'D', 'C' };
+	static constexpr uint32_t CACHE_VERSION = 4;
+
+	struct CacheHeader {
+		char magic[4];
+		uint32_t version;
+		uint64_t source_mtime;
+		uint64_t source_size;
+		uint32_t import_flags;
+		uint32_t optimize_key;
+		uint32_t vertex_size;
+		uint32_t mesh_count;
+		uint32_t source_path_length;
+		uint32_t dependency_count;
+	};
+
+	// followed by the padded path
+	struct CacheDependencyHeader {
+		uint64_t mtime;
+		uint64_t size;
+		uint32_t path_length;
+		uint32_t pad;
+	};
+
+	struct CacheMeshHeader {
+		uint32_t vertex_count;
+		uint32_t index_count;
+		uint32_t texture_count;
+		uint32_t lod_count;
+	};
+
+	struct CacheTextureHeader {
+		uint32_t type;
+		uint32_t path_length;
+	};
+
+	constexpr size_t align4(const size_t size) {
+		return (size + 3) & ~size_t(3);
+	}
+
+	std::string ModelCache::cache_path(std::string const& source) {
+		return source + ".cooked";
+	}
+
+	static void write_padded_string(std::ofstream& out, std::string const& str) {
+		static constexpr char zeros[4] = {};
+		out.write(str.data(), str.size());
+		out.write(zeros, align4(str.size()) - str.size());
+	}
+
+	bool ModelCache::write(std::string const& source, std::vector<std::string> const& dependencies, uint32_t import_flags, uint32_t optimize_key, std::vector<MeshData> const& meshes) {
+		CacheHeader header{};
+		std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+		header.version = CACHE_VERSION;
+		header.import_flags = import_flags;
+		header.optimize_key = optimize_key;
+		header.vertex_size = sizeof(Vertex);
+		header.mesh_count = static_cast<uint32_t>(meshes.size());
+		header.source_path_length = static_cast<uint32_t>(source.size());
+		header.dependency_count = static_cast<uint32_t>(dependencies.size());
+
+		if (!get_file_stamp(source, header.source_mtime, header.source_size)) {
+			LOG_ERROR("[MODEL CACHE] Can't stat source '{}'", source);
+			return false;
+		}
+
+		std::vector<CacheDependencyHeader> dependency_headers(dependencies.size());
+		for (size_t i = 0; i < dependencies.size(); ++i) {
+			auto& dependency_header = dependency_headers[i];
+			dependency_header.path_length = static_cast<uint32_t>(dependencies[i].size());
+			if (!get_file_stamp(dependencies[i], dependency_header.mtime, dependency_header.size)) {
+				LOG_ERROR("[MODEL CACHE] Can't stat '{}' read by '{}'", dependencies[i], source);
+				return false;
+			}
+		}
+
+		auto path = cache_path(source);
+		std::ofstream out(path, std::ios::binary | std::ios::trunc);
+		if (!out.is_open()) {
+			LOG_ERROR("[MODEL CACHE] Can't open '{}' for writing", path);
+			return false;
+		}
+
+		out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		write_padded_string(out, source);
+		for (size_t i = 0; i < dependencies.size(); ++i) {
+			out.write(reinterpret_cast<const char*>(&dependency_headers[i]), sizeof(CacheDependencyHeader));
+			write_padded_string(out, dependencies[i]);
+		}
+
+		for (auto const& mesh : meshes) {
+			CacheMeshHeader mesh_header{
+				static_cast<uint32_t>(mesh.vertices.size()),
+				static_cast<uint32_t>(mesh.indices.size()),
+				static_cast<uint32_t>(mesh.textures.size()),
+				static_cast<uint32_t>(mesh.lods.size())
+			};
+			out.write(reinterpret_cast<const char*>(&mesh_header), sizeof(mesh_header));
+
+			for (auto const& texture : mesh.textures) {
+				CacheTextureHeader texture_header{
+					static_cast<uint32_t>(texture.type),
+					static_cast<uint32_t>(texture.path.size())
+				};
+				out.write(reinterpret_cast<const char*>(&texture_header), sizeof(texture_header));
+				write_padded_string(out, texture.path);
+			}
+
+			out.write(reinterpret_cast<const char*>(mesh.vertices.data()), mesh.vertices.size() * sizeof(Vertex));
+			out.write(reinterpret_cast<const char*>(mesh.indices.data()), mesh.indices.size() * sizeof(GLuint));
+			out.write(reinterpret_cast<const char*>(mesh.lods.data()), mesh.lods.size() * sizeof(MeshLod));
+		}
+
+		if (!out.good()) {
+			LOG_ERROR("[MODEL CACHE] Failed to write '{}'", path);
+			out.close();
+			std::remove(path.c_str());
+			return false;
+		}
+
+		LOG_INFO("[MODEL CACHE] Cooked '{}' -> '{}'", source, path);
+		return true;
+	}
+
+	std::unique_ptr<ModelCache> ModelCache::open(std::string const& source, uint32_t import_flags, uint32_t optimize_key) {
+		std::unique_ptr<ModelCache> cache(new ModelCache(cache_path(source)));
+		if (!cache->m_file.is_open() || !cache->parse(source, import_flags, optimize_key)) {
+			return nullptr;
+		}
+		return cache;
+	}
+
+	bool ModelCache::parse(std::string const& source, uint32_t import_flags, uint32_t optimize_key) {
+		const unsigned char* cur = m_file.data();
+		const unsigned char* end = cur + m_file.size();
+
+		auto take = [&](size_t size) -> const unsigned char* {
+			if (static_cast<size_t>(end - cur) < size) {
+				return nullptr;
+			}
+			auto res = cur;
+			cur += size;
+			return res;
+		};
+
+		CacheHeader header;
+		auto raw_header = take(sizeof(header));
+		if (!raw_header) {
+			return false;
+		}
+		std::memcpy(&header, raw_header, sizeof(header));
+
+		uint64_t mtime = 0, size = 0;
+		if (std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0
+			|| header.version != CACHE_VERSION
+			|| header.import_flags != import_flags
+			|| header.optimize_key != optimize_key
+			|| header.vertex_size != sizeof(Vertex)
+			|| !get_file_stamp(source, mtime, size)
+			|| header.source_mtime != mtime
+			|| header.source_size != size) {
+			LOG_INFO("[MODEL CACHE] '{}' is stale", cache_path(source));
+			return false;
+		}
+
+		auto raw_path = take(align4(header.source_path_length));
+		if (!raw_path || std::string(reinterpret_cast<const char*>(raw_path), header.source_path_length) != source) {
+			return false;
+		}
+
+		for (uint32_t i = 0; i < header.dependency_count; ++i) {
+			CacheDependencyHeader dependency_header;
+			auto raw_dependency_header = take(sizeof(dependency_header));
+			if (!raw_dependency_header) {
+				return false;
+			}
+			std::memcpy(&dependency_header, raw_dependency_header, sizeof(dependency_header));
+
+			auto raw_dependency_path = take(align4(dependency_header.path_length));
+			if (!raw_dependency_path) {
+				return false;
+			}
+			const std::string dependency(reinterpret_cast<const char*>(raw_dependency_path), dependency_header.path_length);
+			if (!get_file_stamp(dependency, mtime, size) || dependency_header.mtime != mtime || dependency_header.size != size) {
+				LOG_INFO("[MODEL CACHE] '{}' is stale, '{}' changed", cache_path(source), dependency);
+				return false;
+			}
+		}
+
+		m_meshes.reserve(header.mesh_count);
+		for (uint32_t i = 0; i < header.mesh_count; ++i) {
+			CacheMeshHeader mesh_header;
+			auto raw_mesh_header = take(sizeof(mesh_header));
+			if (!raw_mesh_header) {
+				return false;
+			}
+			std::memcpy(&mesh_header, raw_mesh_header, sizeof(mesh_header));
+
+			MeshView view;
+			for (uint32_t j = 0; j < mesh_header.texture_count; ++j) {
+				CacheTextureHeader texture_header;
+				auto raw_texture_header = take(sizeof(texture_header));
+				if (!raw_texture_header) {
+					return false;
+				}
+				std::memcpy(&texture_header, raw_texture_header, sizeof(texture_header));
+
+				auto raw_texture_path = take(align4(texture_header.path_length));
+				if (!raw_texture_path) {
+					return false;
+				}
+				view.textures.push_back({
+					std::string(reinterpret_cast<const char*>(raw_texture_path), texture_header.path_length),
+					static_cast<Texture2D::type>(texture_header.type)
+				});
+			}
+
+			auto raw_vertices = take(static_cast<size_t>(mesh_header.vertex_count) * sizeof(Vertex));
+			auto raw_indices = take(static_cast<size_t>(mesh_header.index_count) * sizeof(GLuint));
+			auto raw_lods = take(static_cast<size_t>(mesh_header.lod_count) * sizeof(MeshLod));
+			if (!raw_vertices || !raw_indices || !raw_lods) {
+				return false;
+			}
+
+			// every block is 4-byte aligned and the mapping is page aligned, so the data can be viewed in place
+			view.vertices = { reinterpret_cast<const Vertex*>(raw_vertices), mesh_header.vertex_count };
+			view.indices = { reinterpret_cast<const GLuint*>(raw_indices), mesh_header.index_count };
+			view.lods = { reinterpret_cast<const MeshLod*>(raw_lods), mesh_header.lod_count };
+			m_meshes.push_back(std::move(view));
+		}
+
+		return true;
+	}
+
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <span>
+
+#include "EngineCore/Modules/FileRead.hpp"
+#include "EngineCore/Rendering/OpenGL/Mesh.hpp"
+
+namespace EngineCore {
+
+	// Binary "cooked" copy of an imported model, stored next to the source as '<source>.cooked'.
+	// The file is keyed by source path, source mtime/size, the mtime/size of every other file the import
+	// read (material libraries name the textures), import flags, mesh optimizer options
+	// (MeshOptimizeOptions::get_cache_key) and format version;
+	// any mismatch makes open() fail and the model is re-imported through Assimp.
+	class ModelCache {
+	public:
+		struct MeshView {
+			std::span<const Vertex> vertices;
+			std::span<const GLuint> indices;
+			std::vector<TextureRef> textures;
+			std::span<const MeshLod> lods;
+		};
+
+		static std::unique_ptr<ModelCache> open(std::string const& source, uint32_t import_flags, uint32_t optimize_key);
+		// 'dependencies' are the other files the import read, see import_scene
+		static bool write(std::string const& source, std::vector<std::string> const& dependencies, uint32_t import_flags, uint32_t optimize_key, std::vector<MeshData> const& meshes);
+		static std::string cache_path(std::string const& source);
+
+		ModelCache(ModelCache const&) = delete;
+		ModelCache& operator=(ModelCache const&) = delete;
+
+		size_t get_mesh_count() const { return m_meshes.size(); }
+		MeshView const& get_mesh(size_t index) const { return m_meshes[index]; }
+
+	private:
+		ModelCache(std::string const& path) : m_file(path) {}
+
+		bool parse(std::string const& source, uint32_t import_flags, uint32_t optimize_key);
+
+		MappedFile m_file;
+		std::vector<MeshView> m_meshes;
+	};
+
+}
@@ -0,0 +1,334 @@
+#include "TextureFile.hpp"
+#include "EngineCore/Logs.hpp"
+
+#include <fstream>
+#include <cstring>
+#include <cstdio>
+#include <algorithm>
+#include <bit>
+
+namespace EngineCore {
+
+	static constexpr uint32_t DDS_MAGIC = 0x20534444; // "DDS "
+
+	static constexpr uint32_t DDSD_CAPS = 0x1;
+	static constexpr uint32_t DDSD_HEIGHT = 0x2;
+	static constexpr uint32_t DDSD_WIDTH = 0x4;
+	static constexpr uint32_t DDSD_PIXELFORMAT = 0x1000;
+	static constexpr uint32_t DDSD_MIPMAPCOUNT = 0x20000;
+	static constexpr uint32_t DDSD_LINEARSIZE = 0x80000;
+
+	static constexpr uint32_t DDPF_FOURCC = 0x4;
+
+	static constexpr uint32_t DDSCAPS_COMPLEX = 0x8;
+	static constexpr uint32_t DDSCAPS_TEXTURE = 0x1000;
+	static constexpr uint32_t DDSCAPS_MIPMAP = 0x400000;
+
+	static constexpr uint32_t DDS_DIMENSION_TEXTURE2D = 3;
+
+	// DXGI_FORMAT values
+	static constexpr uint32_t DXGI_BC1_UNORM = 71;
+	static constexpr uint32_t DXGI_BC3_UNORM = 77;
+	static constexpr uint32_t DXGI_BC5_UNORM = 83;
+	static constexpr uint32_t DXGI_BC7_UNORM = 98;
+
+	static constexpr uint32_t make_fourcc(const char a, const char b, const char c, const char d) {
+		return uint32_t(uint8_t(a)) | (uint32_t(uint8_t(b)) << 8) | (uint32_t(uint8_t(c)) << 16) | (uint32_t(uint8_t(d)) << 24);
+	}
+
+	struct DDSPixelFormat {
+		uint32_t size;
+		uint32_t flags;
+		uint32_t fourcc;
+		uint32_t rgb_bit_count;
+		uint32_t masks[4];
+	};
+
+	struct DDSHeader {
+		uint32_t size;
+		uint32_t flags;
+		uint32_t height;
+		uint32_t width;
+		uint32_t pitch_or_linear_size;
+		uint32_t depth;
+		uint32_t mip_map_count;
+		uint32_t reserved1[11];
+		DDSPixelFormat pixel_format;
+		uint32_t caps[4];
+		uint32_t reserved2;
+	};
+
+	struct DDSHeaderDX10 {
+		uint32_t dxgi_format;
+		uint32_t resource_dimension;
+		uint32_t misc_flag;
+		uint32_t array_size;
+		uint32_t misc_flags2;
+	};
+
+	static_assert(sizeof(DDSHeader) == 124 && sizeof(DDSHeaderDX10) == 20, "DDS headers are fixed size");
+
+	size_t get_block_bytes(const BlockFormat format) {
+		return format == BlockFormat::BC1 ? 8 : 16;
+	}
+
+	const char* get_block_format_name(const BlockFormat format) {
+		switch (format) {
+		case BlockFormat::BC1: return "BC1";
+		case BlockFormat::BC3: return "BC3";
+		case BlockFormat::BC5: return "BC5";
+		case BlockFormat::BC7: return "BC7";
+		}
+		return "?";
+	}
+
+	size_t get_compressed_level_size(const BlockFormat format, const uint32_t width, const uint32_t height) {
+		const size_t blocks_x = std::max<size_t>((width + 3) / 4, 1);
+		const size_t blocks_y = std::max<size_t>((height + 3) / 4, 1);
+		return blocks_x * blocks_y * get_block_bytes(format);
+	}
+
+	void CompressedImage_t::allocate(const BlockFormat block_format, const uint32_t w, const uint32_t h, const uint32_t level_count) {
+		format = block_format;
+		width = w;
+		height = h;
+		levels.resize(level_count);
+
+		size_t offset = 0;
+		for (uint32_t i = 0; i < level_count; ++i) {
+			auto& level = levels[i];
+			level.width = std::max(w >> i, 1u);
+			level.height = std::max(h >> i, 1u);
+			level.offset = offset;
+			level.size = get_compressed_level_size(format, level.width, level.height);
+			offset += level.size;
+		}
+		data.assign(offset, 0);
+	}
+
+	static bool format_from_dds(DDSHeader const& header, const DDSHeaderDX10* dx10, BlockFormat& format) {
+		if (dx10) {
+			switch (dx10->dxgi_format) {
+			case DXGI_BC1_UNORM: format = BlockFormat::BC1; return true;
+			case DXGI_BC3_UNORM: format = BlockFormat::BC3; return true;
+			case DXGI_BC5_UNORM: format = BlockFormat::BC5; return true;
+			case DXGI_BC7_UNORM: format = BlockFormat::BC7; return true;
+			default: return false;
+			}
+		}
+
+		const uint32_t fourcc = header.pixel_format.fourcc;
+		if (fourcc == make_fourcc('D', 'X', 'T', '1')) {
+			format = BlockFormat::BC1;
+		}
+		else if (fourcc == make_fourcc('D', 'X', 'T', '5')) {
+			format = BlockFormat::BC3;
+		}
+		else if (fourcc == make_fourcc('A', 'T', 'I', '2') || fourcc == make_fourcc('B', 'C', '5', 'U')) {
+			format = BlockFormat::BC5;
+		}
+		else {
+			return false;
+		}
+		return true;
+	}
+
+	bool read_dds(std::span<const unsigned char> file, CompressedImage_t& image, const char* name) {
+		const unsigned char* cur = file.data();
+		const unsigned char* end = cur + file.size();
+
+		auto take = [&](size_t size) -> const unsigned char* {
+			if (static_cast<size_t>(end - cur) < size) {
+				return nullptr;
+			}
+			auto res = cur;
+			cur += size;
+			return res;
+		};
+
+		uint32_t magic = 0;
+		DDSHeader header;
+		auto magic_ptr = take(sizeof(magic));
+		auto header_ptr = take(sizeof(header));
+		if (!magic_ptr || !header_ptr) {
+			LOG_ERROR("[DDS] '{}' is truncated", name);
+			return false;
+		}
+		std::memcpy(&magic, magic_ptr, sizeof(magic));
+		std::memcpy(&header, header_ptr, sizeof(header));
+		if (magic != DDS_MAGIC || header.size != sizeof(DDSHeader) || !(header.pixel_format.flags & DDPF_FOURCC)) {
+			LOG_ERROR("[DDS] '{}' is not a block compressed DDS file", name);
+			return false;
+		}
+
+		DDSHeaderDX10 dx10;
+		const bool has_dx10 = header.pixel_format.fourcc == make_fourcc('D', 'X', '1', '0');
+		if (has_dx10) {
+			auto dx10_ptr = take(sizeof(dx10));
+			if (!dx10_ptr) {
+				LOG_ERROR("[DDS] '{}' is truncated", name);
+				return false;
+			}
+			std::memcpy(&dx10, dx10_ptr, sizeof(dx10));
+			if (dx10.resource_dimension != DDS_DIMENSION_TEXTURE2D || dx10.array_size > 1) {
+				LOG_ERROR("[DDS] '{}' is not a single 2D texture", name);
+				return false;
+			}
+		}
+
+		BlockFormat format;
+		if (!format_from_dds(header, has_dx10 ? &dx10 : nullptr, format)) {
+			LOG_ERROR("[DDS] '{}' has an unsupported format", name);
+			return false;
+		}
+
+		if (header.width == 0 || header.height == 0) {
+			LOG_ERROR("[DDS] '{}' is empty", name);
+			return false;
+		}
+
+		const uint32_t max_levels = static_cast<uint32_t>(std::bit_width(std::max(header.width, header.height)));
+		const uint32_t level_count = (header.flags & DDSD_MIPMAPCOUNT) && header.mip_map_count > 0
+			? std::min(header.mip_map_count, max_levels)
+			: 1;
+
+		image.allocate(format, header.width, header.height, level_count);
+		auto data_ptr = take(image.data.size());
+		if (!data_ptr) {
+			LOG_ERROR("[DDS] '{}' is truncated", name);
+			image = {};
+			return false;
+		}
+		std::memcpy(image.data.data(), data_ptr, image.data.size());
+		return true;
+	}
+
+	bool read_dds(std::string const& path, CompressedImage_t& image) {
+		const FileView file(path);
+		if (!file.is_open()) {
+			return false;
+		}
+		return read_dds(file.bytes(), image, path.c_str());
+	}
+
+	bool write_dds(std::string const& path, CompressedImage_t const& image) {
+		if (!image.is_valid()) {
+			return false;
+		}
+
+		DDSHeader header{};
+		header.size = sizeof(DDSHeader);
+		header.flags = DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | DDSD_MIPMAPCOUNT | DDSD_LINEARSIZE;
+		header.height = image.height;
+		header.width = image.width;
+		header.pitch_or_linear_size = static_cast<uint32_t>(image.levels[0].size);
+		header.mip_map_count = static_cast<uint32_t>(image.levels.size());
+		header.pixel_format.size = sizeof(DDSPixelFormat);
+		header.pixel_format.flags = DDPF_FOURCC;
+		header.caps[0] = DDSCAPS_TEXTURE | (image.levels.size() > 1 ? DDSCAPS_COMPLEX | DDSCAPS_MIPMAP : 0);
+
+		DDSHeaderDX10 dx10{};
+		dx10.resource_dimension = DDS_DIMENSION_TEXTURE2D;
+		dx10.array_size = 1;
+
+		bool has_dx10 = false;
+		switch (image.format) {
+		case BlockFormat::BC1: header.pixel_format.fourcc = make_fourcc('D', 'X', 'T', '1'); break;
+		case BlockFormat::BC3: header.pixel_format.fourcc = make_fourcc('D', 'X', 'T', '5'); break;
+		case BlockFormat::BC5: dx10.dxgi_format = DXGI_BC5_UNORM; has_dx10 = true; break;
+		case BlockFormat::BC7: dx10.dxgi_format = DXGI_BC7_UNORM; has_dx10 = true; break;
+		}
+		if (has_dx10) {
+			header.pixel_format.fourcc = make_fourcc('D', 'X', '1', '0');
+		}
+
+		std::ofstream out(path, std::ios::binary | std::ios::trunc);
+		if (!out.is_open()) {
+			LOG_ERROR("[DDS] Can't open '{}' for writing", path);
+			return false;
+		}
+
+		out.write(reinterpret_cast<const char*>(&DDS_MAGIC), sizeof(DDS_MAGIC));
+		out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		if (has_dx10) {
+			out.write(reinterpret_cast<const char*>(&dx10), sizeof(dx10));
+		}
+		out.write(reinterpret_cast<const char*>(image.data.data()), image.data.size());
+
+		if (!out.good()) {
+			LOG_ERROR("[DDS] Failed to write '{}'", path);
+			out.close();
+			std::remove(path.c_str());
+			return false;
+		}
+		return true;
+	}
+
+	bool write_tga(std::string const& path, const uint32_t width, const uint32_t height, std::span<const uint8_t> rgba) {
+		if (width == 0 || height == 0 || width > 0xFFFF || height > 0xFFFF || rgba.size() < size_t(width) * height * 4) {
+			return false;
+		}
+
+		// uncompressed true color, 8 alpha bits, origin in the lower left corner
+		uint8_t header[18] = {};
+		header[2] = 2;
+		header[12] = static_cast<uint8_t>(width & 0xFF);
+		header[13] = static_cast<uint8_t>(width >> 8);
+		header[14] = static_cast<uint8_t>(height & 0xFF);
+		header[15] = static_cast<uint8_t>(height >> 8);
+		header[16] = 32;
+		header[17] = 8;
+
+		// TGA stores BGRA
+		std::vector<uint8_t> pixels(size_t(width) * height * 4);
+		for (size_t i = 0; i < pixels.size(); i += 4) {
+			pixels[i + 0] = rgba[i + 2];
+			pixels[i + 1] = rgba[i + 1];
+			pixels[i + 2] = rgba[i + 0];
+			pixels[i + 3] = rgba[i + 3];
+		}
+
+		std::ofstream out(path, std::ios::binary | std::ios::trunc);
+		if (!out.is_open()) {
+			LOG_ERROR("[TGA] Can't open '{}' for writing", path);
+			return false;
+		}
+		out.write(reinterpret_cast<const char*>(header), sizeof(header));
+		out.write(reinterpret_cast<const char*>(pixels.data()), pixels.size());
+
+		if (!out.good()) {
+			LOG_ERROR("[TGA] Failed to write '{}'", path);
+			out.close();
+			std::remove(path.c_str());
+			return false;
+		}
+		return true;
+	}
+
+	std::string get_cooked_path(std::string const& path) {
+		return path + ".dds";
+	}
+
+	TextureImage load_texture_image(std::string const& path) {
+		const auto cooked_path = get_cooked_path(path);
+
+		uint64_t cooked_mtime = 0, cooked_size = 0;
+		if (get_file_stamp(cooked_path, cooked_mtime, cooked_size)) {
+			uint64_t source_mtime = 0, source_size = 0;
+			const bool has_source = get_file_stamp(path, source_mtime, source_size);
+			if (!has_source || cooked_mtime >= source_mtime) {
+				CompressedImage_t image;
+				if (read_dds(cooked_path, image)) {
+					LOG_INFO("[IMAGE DATA] size = {}x{} {} | {} levels | path = {}",
+						image.width, image.height, get_block_format_name(image.format), image.levels.size(), cooked_path);
+					return image;
+				}
+			}
+			else {
+				LOG_WARN("[IMAGE DATA] '{}' is older than its source, cook it again", cooked_path);
+			}
+		}
+		return read_image(path.c_str());
+	}
+
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <span>
+#include <string>
+#include <vector>
+#include <variant>
+#include <cstdint>
+#include <cstddef>
+
+#include "EngineCore/Modules/FileRead.hpp"
+
+namespace EngineCore {
+
+	// block compressed formats written by TextureCooker, 4x4 pixel blocks
+	enum class BlockFormat : uint32_t {
+		BC1, // RGB, 8 bytes per block
+		BC3, // RGBA, BC1 color + BC4 alpha, 16 bytes
+		BC5, // two BC4 channels (normal map xy), 16 bytes
+		BC7, // RGBA, mode 6 only, 16 bytes
+	};
+
+	size_t get_block_bytes(const BlockFormat format);
+	const char* get_block_format_name(const BlockFormat format);
+
+	// size in bytes of one mip level
+	size_t get_compressed_level_size(const BlockFormat format, const uint32_t width, const uint32_t height);
+
+	// Every mip level of a block compressed texture, levels are stored back to back in 'data'
+	struct CompressedImage_t {
+		struct Level {
+			uint32_t width = 0;
+			uint32_t height = 0;
+			size_t offset = 0;
+			size_t size = 0;
+		};
+
+		BlockFormat format = BlockFormat::BC1;
+		uint32_t width = 0;
+		uint32_t height = 0;
+		std::vector<Level> levels;
+		std::vector<unsigned char> data;
+
+		bool is_valid() const { return !levels.empty(); }
+
+		// lays out 'level_count' levels from width x height down and sizes 'data' for them
+		void allocate(const BlockFormat block_format, const uint32_t w, const uint32_t h, const uint32_t level_count);
+	};
+
+	// DDS container: BC1/BC3 with the legacy DXT1/DXT5 FourCC, BC5/BC7 with the DX10 header;
+	// ATI2/BC5U FourCC files are read as BC5
+	bool read_dds(std::span<const unsigned char> file, CompressedImage_t& image, const char* name);
+	bool read_dds(std::string const& path, CompressedImage_t& image);
+	bool write_dds(std::string const& path, CompressedImage_t const& image);
+
+	// 32 bit uncompressed TGA, 'rgba' holds rows from the bottom up as glReadPixels returns them
+	bool write_tga(std::string const& path, const uint32_t width, const uint32_t height, std::span<const uint8_t> rgba);
+
+	// the cooked texture of 'path' lives next to it, with '.dds' appended
+	std::string get_cooked_path(std::string const& path);
+
+	// pixels as decoded from the source, or the cooked levels when they exist and are not older than the source
+	using TextureImage = std::variant<Image_t, CompressedImage_t>;
+
+	TextureImage load_texture_image(std::string const& path);
+
+}
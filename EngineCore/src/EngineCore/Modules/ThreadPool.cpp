@@ -0,0 +1,52 @@
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+
+namespace EngineCore {
+
+	ThreadPool::ThreadPool(size_t thread_count) {
+		m_threads.reserve(thread_count);
+		for (size_t i = 0; i < thread_count; ++i) {
+			m_threads.emplace_back(&ThreadPool::worker, this);
+		}
+	}
+
+	ThreadPool::~ThreadPool() {
+		{
+			std::lock_guard lock(m_mutex);
+			m_stop = true;
+		}
+		m_condition.notify_all();
+		for (auto& thread : m_threads) {
+			thread.join();
+		}
+	}
+
+	void ThreadPool::worker() {
+		while (true) {
+			std::function<void()> task;
+			{
+				std::unique_lock lock(m_mutex);
+				m_condition.wait(lock, [this]() { return m_stop || !m_tasks.empty(); });
+				if (m_stop && m_tasks.empty()) {
+					return;
+				}
+				task = std::move(m_tasks.front());
+				m_tasks.pop_front();
+			}
+			task();
+		}
+	}
+
+	size_t ThreadPool::default_thread_count() {
+		// leave one core to the thread that owns the GL context
+		size_t hw = std::thread::hardware_concurrency();
+		return std::max<size_t>(hw > 1 ? hw - 1 : 1, 1);
+	}
+
+	ThreadPool& ThreadPool::get() {
+		static ThreadPool pool;
+		return pool;
+	}
+
+}
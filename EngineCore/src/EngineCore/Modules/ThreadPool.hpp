@@ -0,0 +1,54 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <type_traits>
+
+namespace EngineCore {
+
+	class ThreadPool {
+	public:
+		explicit ThreadPool(size_t thread_count = default_thread_count());
+		~ThreadPool();
+
+		ThreadPool(ThreadPool const&) = delete;
+		ThreadPool& operator=(ThreadPool const&) = delete;
+
+		template<typename Func>
+		auto submit(Func&& func) -> std::future<std::invoke_result_t<std::decay_t<Func>>> {
+			using Result = std::invoke_result_t<std::decay_t<Func>>;
+
+			auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Func>(func));
+			auto future = task->get_future();
+			{
+				std::lock_guard lock(m_mutex);
+				m_tasks.emplace_back([task]() { (*task)(); });
+			}
+			m_condition.notify_one();
+			return future;
+		}
+
+		size_t get_thread_count() const { return m_threads.size(); }
+
+		// shared pool used by asset loading
+		static ThreadPool& get();
+
+		static size_t default_thread_count();
+
+	private:
+		void worker();
+
+		std::vector<std::thread> m_threads;
+		std::deque<std::function<void()>> m_tasks;
+		std::mutex m_mutex;
+		std::condition_variable m_condition;
+		bool m_stop = false;
+	};
+
+}
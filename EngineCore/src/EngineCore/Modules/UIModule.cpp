@@ -1,6 +1,10 @@
 #include "UIModule.hpp"
 #include <GLFW/glfw3.h>
 
+#include "EngineCore/Rendering/OpenGL/Renderer_OpenGL.hpp"
+#include "EngineCore/Rendering/OpenGL/GLStateCache.hpp"
+#include "EngineCore/Profiler.hpp"
+
 #include <ImGui/imgui.h>
 #include <ImGui/backends/imgui_impl_opengl3.h>
 #include <ImGui/backends/imgui_impl_glfw.h>
@@ -32,6 +36,8 @@ namespace EngineCore {
 	}
 
 	void UIModule::UI_draw_end() {
+		PROFILE_SCOPE("UIModule::UI_draw_end");
+		PROFILE_GPU_SCOPE("UI");
 		ImGui::Render();
 		ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 		if (ImGui::GetIO().ConfigFlags & ImGuiConfigFlags_ViewportsEnable) {
@@ -40,6 +46,8 @@ namespace EngineCore {
 			ImGui::RenderPlatformWindowsDefault();
 			glfwMakeContextCurrent(backup_cur_context);
 		}
+		// the backend sets and restores GL state with raw calls
+		Renderer_OpenGL::get_state().invalidate();
 	};
 
 	
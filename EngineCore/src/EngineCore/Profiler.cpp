@@ -0,0 +1,252 @@
+#include "EngineCore/Profiler.hpp"
+#include "EngineCore/Logs.hpp"
+
+#include "Rendering/OpenGL/GpuProfiler.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <mutex>
+
+namespace EngineCore {
+
+	std::atomic<bool> Profiler::s_enabled{ true };
+
+	namespace {
+
+		// written by its thread only, read by the render thread in new_frame()
+		struct ThreadRing {
+			explicit ThreadRing(const uint16_t ring_track)
+				: zones(Profiler::RING_CAPACITY), track(ring_track)
+			{}
+
+			std::vector<ProfileZone> zones;
+			std::atomic<uint64_t> write{ 0 };
+			std::atomic<uint64_t> read{ 0 };
+			std::atomic<size_t> dropped{ 0 };
+			const uint16_t track;
+		};
+
+		struct ProfilerState {
+			// guards 'rings' and 'track_names', threads only take it once to register
+			std::mutex mutex;
+			std::vector<std::unique_ptr<ThreadRing>> rings;
+			std::vector<std::string> track_names;
+
+			// render thread only
+			std::deque<ProfileFrame> frames;
+			ProfileFrame current;
+			size_t dropped = 0;
+			std::unique_ptr<GpuProfiler> gpu;
+			uint16_t gpu_track = 0;
+		};
+
+		// never destroyed, pool threads may still record zones during static destruction
+		ProfilerState& get_state() {
+			static ProfilerState* state = new ProfilerState();
+			return *state;
+		}
+
+		thread_local ThreadRing* t_ring = nullptr;
+		thread_local uint16_t t_depth = 0;
+
+		uint16_t add_track(ProfilerState& state, std::string name) {
+			state.track_names.push_back(std::move(name));
+			return static_cast<uint16_t>(state.track_names.size() - 1);
+		}
+
+		ThreadRing& get_thread_ring() {
+			if (t_ring == nullptr) {
+				auto& state = get_state();
+				std::lock_guard lock(state.mutex);
+				const uint16_t track = add_track(state, std::format("thread {}", state.rings.size()));
+				state.rings.push_back(std::make_unique<ThreadRing>(track));
+				t_ring = state.rings.back().get();
+			}
+			return *t_ring;
+		}
+
+		void drain_rings(ProfilerState& state, std::vector<ProfileZone>& zones) {
+			std::lock_guard lock(state.mutex);
+			for (auto& ring : state.rings) {
+				const uint64_t read = ring->read.load(std::memory_order_relaxed);
+				const uint64_t write = ring->write.load(std::memory_order_acquire);
+				for (uint64_t i = read; i < write; ++i) {
+					zones.push_back(ring->zones[i % Profiler::RING_CAPACITY]);
+				}
+				ring->read.store(write, std::memory_order_release);
+				state.dropped += ring->dropped.exchange(0, std::memory_order_relaxed);
+			}
+		}
+
+		void sort_zones(std::vector<ProfileZone>& zones) {
+			std::sort(zones.begin(), zones.end(), [](ProfileZone const& a, ProfileZone const& b) {
+				return a.start_ns != b.start_ns ? a.start_ns < b.start_ns : a.depth < b.depth;
+			});
+		}
+
+		std::string escape_json(const char* str) {
+			std::string res;
+			for (; *str != '\0'; ++str) {
+				if (*str == '"' || *str == '\\') {
+					res += '\\';
+				}
+				res += *str;
+			}
+			return res;
+		}
+
+	}
+
+	void Profiler::set_enabled(const bool enabled) {
+		s_enabled.store(enabled, std::memory_order_relaxed);
+	}
+
+	void Profiler::set_thread_name(const char* name) {
+		auto& ring = get_thread_ring();
+		auto& state = get_state();
+		std::lock_guard lock(state.mutex);
+		state.track_names[ring.track] = name;
+	}
+
+	int64_t Profiler::now_ns() {
+		static const auto epoch = std::chrono::steady_clock::now();
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+	}
+
+	uint16_t Profiler::begin_zone() {
+		return t_depth++;
+	}
+
+	void Profiler::end_zone(const char* name, const int64_t start_ns, const uint16_t depth) {
+		t_depth = depth;
+		auto& ring = get_thread_ring();
+
+		const uint64_t write = ring.write.load(std::memory_order_relaxed);
+		if (write - ring.read.load(std::memory_order_acquire) == RING_CAPACITY) {
+			ring.dropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		ring.zones[write % RING_CAPACITY] = { name, start_ns, now_ns(), depth, ring.track };
+		ring.write.store(write + 1, std::memory_order_release);
+	}
+
+	void Profiler::new_frame() {
+		auto& state = get_state();
+		const int64_t now = now_ns();
+
+		// the very first call only opens a frame
+		if (state.current.number != 0) {
+			state.current.end_ns = now;
+			drain_rings(state, state.current.zones);
+			sort_zones(state.current.zones);
+			state.frames.push_back(std::move(state.current));
+			if (state.frames.size() > HISTORY_FRAMES) {
+				state.frames.pop_front();
+			}
+		}
+
+		if (state.gpu) {
+			uint64_t number = 0;
+			std::vector<ProfileZone> zones;
+			while (state.gpu->collect(number, zones)) {
+				if (state.frames.empty() || number < state.frames.front().number || number > state.frames.back().number) {
+					continue;
+				}
+				auto& frame = state.frames[number - state.frames.front().number];
+				for (auto& zone : zones) {
+					zone.track = state.gpu_track;
+					frame.zones.push_back(zone);
+				}
+				sort_zones(frame.zones);
+			}
+		}
+
+		const uint64_t number = state.frames.empty() ? 1 : state.frames.back().number + 1;
+		state.current = {};
+		state.current.number = number;
+		state.current.start_ns = now;
+		if (state.gpu) {
+			state.gpu->begin_frame(number);
+		}
+	}
+
+	void Profiler::release_gpu() {
+		get_state().gpu = nullptr;
+	}
+
+	bool Profiler::begin_gpu_zone(const char* name) {
+		auto& state = get_state();
+		if (state.current.number == 0) {
+			return false;
+		}
+		if (!state.gpu) {
+			// created on first use, that is on the render thread with its context current
+			state.gpu = std::make_unique<GpuProfiler>();
+			if (!state.gpu->is_supported()) {
+				LOG_WARN("[PROFILER] No GL_TIMESTAMP queries, GPU zones are not recorded");
+			}
+			std::lock_guard lock(state.mutex);
+			state.gpu_track = add_track(state, "GPU");
+			state.gpu->begin_frame(state.current.number);
+		}
+		return state.gpu->begin_zone(name);
+	}
+
+	void Profiler::end_gpu_zone() {
+		auto& state = get_state();
+		if (state.gpu) {
+			state.gpu->end_zone();
+		}
+	}
+
+	std::deque<ProfileFrame> const& Profiler::get_frames() {
+		return get_state().frames;
+	}
+
+	std::vector<std::string> Profiler::get_track_names() {
+		auto& state = get_state();
+		std::lock_guard lock(state.mutex);
+		return state.track_names;
+	}
+
+	size_t Profiler::get_dropped_zone_count() {
+		return get_state().dropped;
+	}
+
+	bool Profiler::write_chrome_trace(std::string const& path) {
+		auto const& frames = get_frames();
+		const auto track_names = get_track_names();
+
+		std::ofstream out(path, std::ios::trunc);
+		if (!out.is_open()) {
+			LOG_ERROR("[PROFILER] Can't open '{}' for writing", path);
+			return false;
+		}
+
+		// timestamps and durations are in microseconds from the first frame
+		const int64_t origin = frames.empty() ? 0 : frames.front().start_ns;
+		out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+		out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"EngineCore\"}}";
+		for (size_t i = 0; i < track_names.size(); ++i) {
+			out << std::format(",\n{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},\"args\":{{\"name\":\"{}\"}}}}",
+				i, escape_json(track_names[i].c_str()));
+		}
+		for (auto const& frame : frames) {
+			for (auto const& zone : frame.zones) {
+				out << std::format(",\n{{\"name\":\"{}\",\"ph\":\"X\",\"pid\":1,\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}}}",
+					escape_json(zone.name), zone.track, (zone.start_ns - origin) / 1000.0, (zone.end_ns - zone.start_ns) / 1000.0);
+			}
+		}
+		out << "\n]}\n";
+
+		if (!out.good()) {
+			LOG_ERROR("[PROFILER] Failed to write '{}'", path);
+			return false;
+		}
+		return true;
+	}
+
+}
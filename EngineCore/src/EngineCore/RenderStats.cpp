@@ -0,0 +1,19 @@
+#include "EngineCore/RenderStats.hpp"
+
+#include <ostream>
+
+namespace EngineCore {
+
+	void write_csv_header(std::ostream& out) {
+		out << "frame,cpu_ms,gpu_ms,draw_calls,draws,indices,triangles,instances,"
+			"program_binds,vertex_array_binds,texture_binds,uniform_uploads,buffer_uploads,buffer_bytes,texture_bytes\n";
+	}
+
+	void write_csv_row(std::ostream& out, RenderFrameStats const& stats, const double cpu_ms, const double gpu_ms) {
+		out << stats.frame << ',' << cpu_ms << ',' << gpu_ms << ','
+			<< stats.draw_calls << ',' << stats.draws << ',' << stats.indices << ',' << stats.get_triangles() << ',' << stats.instances << ','
+			<< stats.program_binds << ',' << stats.vertex_array_binds << ',' << stats.texture_binds << ',' << stats.uniform_uploads << ','
+			<< stats.buffer_uploads << ',' << stats.buffer_bytes << ',' << stats.texture_bytes << '\n';
+	}
+
+}
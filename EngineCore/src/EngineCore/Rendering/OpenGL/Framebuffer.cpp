@@ -0,0 +1,83 @@
+#include "Framebuffer.hpp"
+
+#include <glad/glad.h>
+
+#include <utility>
+
+#include "Renderer_OpenGL.hpp"
+#include "EngineCore/Logs.hpp"
+
+namespace EngineCore {
+
+	Framebuffer::Framebuffer(const uint32_t width, const uint32_t height)
+		: m_width(width), m_height(height)
+	{
+		glCreateRenderbuffers(1, &m_color);
+		glNamedRenderbufferStorage(m_color, GL_RGBA8, m_width, m_height);
+		glCreateRenderbuffers(1, &m_depth);
+		glNamedRenderbufferStorage(m_depth, GL_DEPTH_COMPONENT24, m_width, m_height);
+
+		glCreateFramebuffers(1, &m_id);
+		glNamedFramebufferRenderbuffer(m_id, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_color);
+		glNamedFramebufferRenderbuffer(m_id, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_depth);
+
+		if (!is_complete()) {
+			LOG_ERROR("Framebuffer {}x{} is incomplete", m_width, m_height);
+		}
+	}
+
+	Framebuffer::~Framebuffer() {
+		release();
+	}
+
+	Framebuffer& Framebuffer::operator=(Framebuffer&& framebuffer) noexcept {
+		if (this != &framebuffer) {
+			release();
+			m_id = std::exchange(framebuffer.m_id, 0);
+			m_color = std::exchange(framebuffer.m_color, 0);
+			m_depth = std::exchange(framebuffer.m_depth, 0);
+			m_width = framebuffer.m_width;
+			m_height = framebuffer.m_height;
+		}
+		return *this;
+	}
+
+	Framebuffer::Framebuffer(Framebuffer&& framebuffer) noexcept
+		: m_id(std::exchange(framebuffer.m_id, 0))
+		, m_color(std::exchange(framebuffer.m_color, 0))
+		, m_depth(std::exchange(framebuffer.m_depth, 0))
+		, m_width(framebuffer.m_width)
+		, m_height(framebuffer.m_height)
+	{}
+
+	void Framebuffer::release() {
+		if (m_id != 0) {
+			glDeleteFramebuffers(1, &m_id);
+			glDeleteRenderbuffers(1, &m_color);
+			glDeleteRenderbuffers(1, &m_depth);
+			m_id = m_color = m_depth = 0;
+		}
+	}
+
+	bool Framebuffer::is_complete() const {
+		return glCheckNamedFramebufferStatus(m_id, GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+	}
+
+	void Framebuffer::bind() const {
+		glBindFramebuffer(GL_FRAMEBUFFER, m_id);
+		Renderer_OpenGL::set_viewport(m_width, m_height);
+	}
+
+	void Framebuffer::bind_default() {
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	}
+
+	void Framebuffer::read_pixels(std::vector<uint8_t>& rgba) const {
+		rgba.resize(size_t(m_width) * m_height * 4);
+		glNamedFramebufferReadBuffer(m_id, GL_COLOR_ATTACHMENT0);
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, m_id);
+		glPixelStorei(GL_PACK_ALIGNMENT, 1);
+		glReadPixels(0, 0, m_width, m_height, GL_RGBA, GL_UNSIGNED_BYTE, rgba.data());
+	}
+
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace EngineCore {
+	using uint32_t = unsigned int;
+
+	// RGBA8 color and 24 bit depth renderbuffers, the render target when there is no default framebuffer
+	class Framebuffer {
+	public:
+		Framebuffer(const uint32_t width, const uint32_t height);
+		~Framebuffer();
+
+		Framebuffer(const Framebuffer&) = delete;
+		Framebuffer& operator=(const Framebuffer&) = delete;
+		Framebuffer& operator=(Framebuffer&& framebuffer) noexcept;
+		Framebuffer(Framebuffer&& framebuffer) noexcept;
+
+		bool is_complete() const;
+
+		// binds for drawing and reading and sets the viewport to the whole target
+		void bind() const;
+		static void bind_default();
+
+		// color attachment as RGBA8 rows from the bottom up, waits for the frame to finish
+		void read_pixels(std::vector<uint8_t>& rgba) const;
+
+		uint32_t get_width() const {
+			return m_width;
+		}
+		uint32_t get_height() const {
+			return m_height;
+		}
+
+	private:
+		void release();
+
+		uint32_t m_id = 0;
+		uint32_t m_color = 0;
+		uint32_t m_depth = 0;
+		uint32_t m_width = 0;
+		uint32_t m_height = 0;
+	};
+
+}
@@ -0,0 +1,89 @@
+#include "GLStateCache.hpp"
+
+namespace EngineCore {
+
+	GLStateCache::GLStateCache(GLFunctions const& functions)
+		: m_gl(functions)
+	{}
+
+	template<typename T>
+	bool GLStateCache::update(std::optional<T>& cached, const T& value) {
+		if (cached && *cached == value) {
+			++m_stats.skipped;
+			return false;
+		}
+		cached = value;
+		++m_stats.issued;
+		return true;
+	}
+
+	void GLStateCache::use_program(const uint32_t program) {
+		if (update(m_program, program)) {
+			m_gl.use_program(program);
+		}
+	}
+
+	void GLStateCache::bind_vertex_array(const uint32_t vertex_array) {
+		if (update(m_vertex_array, vertex_array)) {
+			m_gl.bind_vertex_array(vertex_array);
+		}
+	}
+
+	void GLStateCache::bind_texture(const uint32_t unit, const uint32_t texture) {
+		if (unit >= MAX_TEXTURE_UNITS) {
+			++m_stats.issued;
+			m_gl.bind_texture_unit(unit, texture);
+			return;
+		}
+		if (update(m_textures[unit], texture)) {
+			m_gl.bind_texture_unit(unit, texture);
+		}
+	}
+
+	void GLStateCache::set_depth_test(const bool enabled) {
+		if (update(m_depth_test, enabled)) {
+			m_gl.set_depth_test(enabled);
+		}
+	}
+
+	void GLStateCache::set_clear_color(const float color[4]) {
+		if (update(m_clear_color, std::array<float, 4>{ color[0], color[1], color[2], color[3] })) {
+			m_gl.set_clear_color(color[0], color[1], color[2], color[3]);
+		}
+	}
+
+	void GLStateCache::invalidate() {
+		m_program.reset();
+		m_vertex_array.reset();
+		for (auto& texture : m_textures) {
+			texture.reset();
+		}
+		m_depth_test.reset();
+		m_clear_color.reset();
+	}
+
+	void GLStateCache::on_program_deleted(const uint32_t program) {
+		// a deleted program stays current until another one is used, its name may be reused after that
+		if (program != 0 && m_program == program) {
+			m_program.reset();
+		}
+	}
+
+	void GLStateCache::on_vertex_array_deleted(const uint32_t vertex_array) {
+		if (vertex_array != 0 && m_vertex_array == vertex_array) {
+			m_vertex_array = 0;
+		}
+	}
+
+	void GLStateCache::on_texture_deleted(const uint32_t texture) {
+		if (texture == 0) {
+			return;
+		}
+		for (auto& bound : m_textures) {
+			if (bound == texture) {
+				bound = 0;
+			}
+		}
+	}
+
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <array>
+#include <optional>
+#include <cstdint>
+
+#include "EngineCore/RenderStats.hpp"
+
+namespace EngineCore {
+
+	// GL entry points the cache forwards to. Renderer_OpenGL fills it with glad calls,
+	// tests can pass plain functions that record the calls instead.
+	struct GLFunctions {
+		void (*use_program)(uint32_t program);
+		void (*bind_vertex_array)(uint32_t vertex_array);
+		void (*bind_texture_unit)(uint32_t unit, uint32_t texture);
+		void (*set_depth_test)(bool enabled);
+		void (*set_clear_color)(float r, float g, float b, float a);
+	};
+
+	// Shadow copy of the context state the engine changes every frame. A call that would
+	// set the value the context already has is dropped. Unknown state (after construction
+	// or invalidate()) is always forwarded.
+	class GLStateCache {
+	public:
+		static constexpr uint32_t MAX_TEXTURE_UNITS = 32;
+
+		explicit GLStateCache(GLFunctions const& functions);
+
+		void use_program(const uint32_t program);
+		void bind_vertex_array(const uint32_t vertex_array);
+		void bind_texture(const uint32_t unit, const uint32_t texture);
+		void set_depth_test(const bool enabled);
+		void set_clear_color(const float color[4]);
+
+		// state was changed behind the cache, e.g. by the ImGui backend
+		void invalidate();
+
+		// deleting a bound object changes the binding, GL side rules are mirrored here
+		void on_program_deleted(const uint32_t program);
+		void on_vertex_array_deleted(const uint32_t vertex_array);
+		void on_texture_deleted(const uint32_t texture);
+
+		const GLStateStats& get_stats() const { return m_stats; }
+		void reset_stats() { m_stats = {}; }
+
+	private:
+		template<typename T>
+		bool update(std::optional<T>& cached, const T& value);
+
+		GLFunctions m_gl;
+
+		std::optional<uint32_t> m_program;
+		std::optional<uint32_t> m_vertex_array;
+		std::array<std::optional<uint32_t>, MAX_TEXTURE_UNITS> m_textures;
+		std::optional<bool> m_depth_test;
+		std::optional<std::array<float, 4>> m_clear_color;
+
+		GLStateStats m_stats;
+	};
+
+}
@@ -0,0 +1,125 @@
+#include "GpuProfiler.hpp"
+
+#include <glad/glad.h>
+
+namespace EngineCore {
+
+	GpuProfiler::GpuProfiler() {
+		GLint counter_bits = 0;
+		glGetQueryiv(GL_TIMESTAMP, GL_QUERY_COUNTER_BITS, &counter_bits);
+		m_supported = counter_bits > 0;
+		if (m_supported) {
+			m_queries.resize(FRAMES_IN_FLIGHT * MAX_ZONES_PER_FRAME * 2);
+			glCreateQueries(GL_TIMESTAMP, static_cast<GLsizei>(m_queries.size()), m_queries.data());
+		}
+	}
+
+	GpuProfiler::~GpuProfiler() {
+		if (!m_queries.empty()) {
+			glDeleteQueries(static_cast<GLsizei>(m_queries.size()), m_queries.data());
+		}
+	}
+
+	uint32_t GpuProfiler::get_query(const uint32_t slot, const size_t zone, const bool end) const {
+		return m_queries[(slot * MAX_ZONES_PER_FRAME + zone) * 2 + (end ? 1 : 0)];
+	}
+
+	void GpuProfiler::begin_frame(const uint64_t number) {
+		if (!m_supported) {
+			return;
+		}
+		// zones left open by the previous frame end with it
+		while (!m_open.empty()) {
+			end_zone();
+		}
+		if (m_frame_open) {
+			m_frames[m_current].pending = !m_frames[m_current].zones.empty();
+			m_current = (m_current + 1) % FRAMES_IN_FLIGHT;
+		}
+
+		Frame& frame = m_frames[m_current];
+		if (frame.pending) {
+			read_frame(m_current, true);
+		}
+
+		GLint64 gpu_now = 0;
+		glGetInteger64v(GL_TIMESTAMP, &gpu_now);
+		frame.number = number;
+		frame.clock_offset_ns = Profiler::now_ns() - gpu_now;
+		frame.zones.clear();
+		m_frame_open = true;
+	}
+
+	bool GpuProfiler::begin_zone(const char* name) {
+		if (!m_frame_open) {
+			return false;
+		}
+		Frame& frame = m_frames[m_current];
+		if (frame.zones.size() == MAX_ZONES_PER_FRAME) {
+			return false;
+		}
+
+		glQueryCounter(get_query(m_current, frame.zones.size(), false), GL_TIMESTAMP);
+		m_open.push_back(frame.zones.size());
+		frame.zones.push_back({ name, static_cast<uint16_t>(m_open.size() - 1) });
+		return true;
+	}
+
+	void GpuProfiler::end_zone() {
+		if (m_open.empty()) {
+			return;
+		}
+		glQueryCounter(get_query(m_current, m_open.back(), true), GL_TIMESTAMP);
+		m_open.pop_back();
+	}
+
+	bool GpuProfiler::read_frame(const uint32_t slot, const bool wait) {
+		Frame& frame = m_frames[slot];
+		// queries finish in order, the last end timestamp is the last one written
+		if (!wait) {
+			GLint available = GL_FALSE;
+			glGetQueryObjectiv(get_query(slot, frame.zones.size() - 1, true), GL_QUERY_RESULT_AVAILABLE, &available);
+			if (available == GL_FALSE) {
+				return false;
+			}
+		}
+
+		std::vector<ProfileZone> zones;
+		zones.reserve(frame.zones.size());
+		for (size_t i = 0; i < frame.zones.size(); ++i) {
+			GLuint64 start = 0, end = 0;
+			glGetQueryObjectui64v(get_query(slot, i, false), GL_QUERY_RESULT, &start);
+			glGetQueryObjectui64v(get_query(slot, i, true), GL_QUERY_RESULT, &end);
+
+			ProfileZone zone;
+			zone.name = frame.zones[i].name;
+			zone.start_ns = static_cast<int64_t>(start) + frame.clock_offset_ns;
+			zone.end_ns = static_cast<int64_t>(end) + frame.clock_offset_ns;
+			zone.depth = frame.zones[i].depth;
+			zones.push_back(zone);
+		}
+		m_ready.emplace_back(frame.number, std::move(zones));
+		frame.pending = false;
+		return true;
+	}
+
+	bool GpuProfiler::collect(uint64_t& number, std::vector<ProfileZone>& zones) {
+		if (m_ready.empty()) {
+			// the slots after the current one hold the oldest frames
+			for (uint32_t i = 1; i <= FRAMES_IN_FLIGHT; ++i) {
+				const uint32_t slot = (m_current + i) % FRAMES_IN_FLIGHT;
+				if (m_frames[slot].pending && !read_frame(slot, false)) {
+					break;
+				}
+			}
+		}
+		if (m_ready.empty()) {
+			return false;
+		}
+		number = m_ready.front().first;
+		zones = std::move(m_ready.front().second);
+		m_ready.pop_front();
+		return true;
+	}
+
+}
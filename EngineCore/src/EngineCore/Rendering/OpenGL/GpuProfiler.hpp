@@ -0,0 +1,69 @@
+#pragma once
+
+#include <array>
+#include <deque>
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+#include "EngineCore/Profiler.hpp"
+
+namespace EngineCore {
+	using uint32_t = unsigned int;
+
+	// Profiler GPU zones: a GL_TIMESTAMP query at both ends of every zone, a ring of frames that are
+	// read back once their last query is available. Zones move onto the Profiler clock with the
+	// GPU time sampled when their frame began.
+	class GpuProfiler {
+	public:
+		static constexpr uint32_t FRAMES_IN_FLIGHT = static_cast<uint32_t>(Profiler::GPU_FRAMES_IN_FLIGHT);
+		static constexpr uint32_t MAX_ZONES_PER_FRAME = 64;
+
+		GpuProfiler();
+		~GpuProfiler();
+
+		GpuProfiler(const GpuProfiler&) = delete;
+		GpuProfiler& operator=(const GpuProfiler&) = delete;
+
+		// false when the context has no timestamp counter bits, no zone is recorded then
+		bool is_supported() const {
+			return m_supported;
+		}
+
+		// waits for the frame that used the slot before when it is still not read back
+		void begin_frame(const uint64_t number);
+		// false when the frame is out of zones
+		bool begin_zone(const char* name);
+		void end_zone();
+
+		// one finished frame per call, in frame order
+		bool collect(uint64_t& number, std::vector<ProfileZone>& zones);
+
+	private:
+		struct Zone {
+			const char* name;
+			uint16_t depth;
+		};
+
+		struct Frame {
+			uint64_t number = 0;
+			int64_t clock_offset_ns = 0;
+			std::vector<Zone> zones;
+			bool pending = false;
+		};
+
+		uint32_t get_query(const uint32_t slot, const size_t zone, const bool end) const;
+		bool read_frame(const uint32_t slot, const bool wait);
+
+		std::vector<uint32_t> m_queries;
+		std::array<Frame, FRAMES_IN_FLIGHT> m_frames;
+		uint32_t m_current = 0;
+		bool m_frame_open = false;
+		// zones begun and not ended yet, innermost last
+		std::vector<size_t> m_open;
+		bool m_supported = false;
+
+		std::deque<std::pair<uint64_t, std::vector<ProfileZone>>> m_ready;
+	};
+
+}
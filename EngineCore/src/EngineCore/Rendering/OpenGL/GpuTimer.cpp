@@ -0,0 +1,77 @@
+#include "GpuTimer.hpp"
+
+#include <glad/glad.h>
+
+namespace EngineCore {
+
+	GpuTimer::GpuTimer() {
+		GLint counter_bits = 0;
+		glGetQueryiv(GL_TIME_ELAPSED, GL_QUERY_COUNTER_BITS, &counter_bits);
+		m_supported = counter_bits > 0;
+		if (m_supported) {
+			glCreateQueries(GL_TIME_ELAPSED, MAX_IN_FLIGHT, m_queries.data());
+		}
+	}
+
+	GpuTimer::~GpuTimer() {
+		if (m_supported) {
+			glDeleteQueries(MAX_IN_FLIGHT, m_queries.data());
+		}
+	}
+
+	void GpuTimer::begin(const uint64_t tag) {
+		if (!m_supported || m_active) {
+			return;
+		}
+		if (m_issued - m_read == MAX_IN_FLIGHT) {
+			read_oldest(true);
+		}
+
+		const size_t slot = m_issued % MAX_IN_FLIGHT;
+		m_tags[slot] = tag;
+		glBeginQuery(GL_TIME_ELAPSED, m_queries[slot]);
+		m_active = true;
+	}
+
+	void GpuTimer::end() {
+		if (!m_active) {
+			return;
+		}
+		glEndQuery(GL_TIME_ELAPSED);
+		m_active = false;
+		++m_issued;
+	}
+
+	bool GpuTimer::read_oldest(const bool wait) {
+		const size_t slot = m_read % MAX_IN_FLIGHT;
+		if (!wait) {
+			GLint available = GL_FALSE;
+			glGetQueryObjectiv(m_queries[slot], GL_QUERY_RESULT_AVAILABLE, &available);
+			if (available == GL_FALSE) {
+				return false;
+			}
+		}
+
+		GLuint64 elapsed_ns = 0;
+		glGetQueryObjectui64v(m_queries[slot], GL_QUERY_RESULT, &elapsed_ns);
+		m_results.push_back({ m_tags[slot], static_cast<double>(elapsed_ns) / 1e6 });
+		++m_read;
+		return true;
+	}
+
+	bool GpuTimer::pop_result(Result& result) {
+		if (m_results_read == m_results.size()) {
+			m_results.clear();
+			m_results_read = 0;
+
+			// queries finish in order, the first unavailable one ends the scan
+			while (m_read < m_issued && read_oldest(false)) {}
+		}
+		if (m_results_read == m_results.size()) {
+			return false;
+		}
+		result = m_results[m_results_read++];
+		return true;
+	}
+
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace EngineCore {
+	using uint32_t = unsigned int;
+
+	// GL_TIME_ELAPSED queries kept in a ring, a measurement is read once the GPU finished it,
+	// usually a few frames later, so timing a frame never waits on the GPU
+	class GpuTimer {
+	public:
+		static constexpr uint32_t MAX_IN_FLIGHT = 6;
+
+		struct Result {
+			// value passed to begin()
+			uint64_t tag = 0;
+			double ms = 0.0;
+		};
+
+		GpuTimer();
+		~GpuTimer();
+
+		GpuTimer(const GpuTimer&) = delete;
+		GpuTimer& operator=(const GpuTimer&) = delete;
+
+		// false when the context has no timer query counter bits, begin() and end() do nothing then
+		bool is_supported() const {
+			return m_supported;
+		}
+
+		// one measurement at a time, when the ring is full the oldest one is waited for
+		void begin(const uint64_t tag);
+		void end();
+
+		// finished measurements in begin() order
+		bool pop_result(Result& result);
+
+	private:
+		bool read_oldest(const bool wait);
+
+		std::array<uint32_t, MAX_IN_FLIGHT> m_queries{};
+		std::array<uint64_t, MAX_IN_FLIGHT> m_tags{};
+		// queries begun and read so far, their difference is the number in flight
+		uint64_t m_issued = 0;
+		uint64_t m_read = 0;
+		bool m_active = false;
+		bool m_supported = false;
+
+		std::vector<Result> m_results;
+		size_t m_results_read = 0;
+	};
+
+}
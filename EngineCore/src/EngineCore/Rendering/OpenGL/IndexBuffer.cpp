@@ -1,4 +1,5 @@
 #include "IndexBuffer.hpp"
+#include "Renderer_OpenGL.hpp"
 #include "EngineCore/Logs.hpp" 
 
 #include <glad/glad.h>
@@ -17,11 +18,28 @@ namespace EngineCore {
 		return GL_STREAM_DRAW;
 	}
 
-	IndexBuffer::IndexBuffer(const std::vector<GLuint>& data, const VertexBuffer::EUsage usage)
+	size_t index_type_size(const IndexType type) {
+		return type == IndexType::UInt16 ? sizeof(GLushort) : sizeof(GLuint);
+	}
+
+	uint32_t index_type_to_GLenum(const IndexType type) {
+		return type == IndexType::UInt16 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+	}
+
+	IndexBuffer::IndexBuffer(std::span<const GLuint> data, const VertexBuffer::EUsage usage)
 		: m_count(data.size()) {
-		glGenBuffers(1, &m_id);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_id);
-		glBufferData(GL_ELEMENT_ARRAY_BUFFER, data.size() * sizeof(GLuint), data.data(), usage_to_GLenum(usage));
+		// no bind here: GL_ELEMENT_ARRAY_BUFFER is state of whatever vertex array is bound
+		glCreateBuffers(1, &m_id);
+		glNamedBufferData(m_id, data.size_bytes(), data.data(), usage_to_GLenum(usage));
+		Renderer_OpenGL::count_buffer_upload(data.size_bytes());
+	}
+
+	IndexBuffer::IndexBuffer(std::span<const uint16_t> data, const VertexBuffer::EUsage usage)
+		: m_count(data.size())
+		, m_type(IndexType::UInt16) {
+		glCreateBuffers(1, &m_id);
+		glNamedBufferData(m_id, data.size_bytes(), data.data(), usage_to_GLenum(usage));
+		Renderer_OpenGL::count_buffer_upload(data.size_bytes());
 	}
 
 
@@ -32,6 +50,7 @@ namespace EngineCore {
 	IndexBuffer& IndexBuffer::operator=(IndexBuffer&& index_buf) noexcept {
 		m_id = index_buf.m_id;
 		m_count = index_buf.m_count;
+		m_type = index_buf.m_type;
 		index_buf.m_id = 0;
 		index_buf.m_count = 0;
 		return *this;
@@ -40,6 +59,7 @@ namespace EngineCore {
 	IndexBuffer::IndexBuffer(IndexBuffer&& index_buf) noexcept {
 		m_id = index_buf.m_id;
 		m_count = index_buf.m_count;
+		m_type = index_buf.m_type;
 		index_buf.m_id = 0;
 		index_buf.m_count = 0;
 	}
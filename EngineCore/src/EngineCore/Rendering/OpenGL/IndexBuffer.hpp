@@ -5,9 +5,21 @@ namespace EngineCore {
 
 	using GLuint = unsigned int;
 
+	enum class IndexType {
+		UInt16,
+		UInt32,
+	};
+
+	// meshes with at most this many vertices get 16 bit indices
+	static constexpr size_t MAX_UINT16_INDEXED_VERTICES = size_t(1) << 16;
+
+	size_t index_type_size(const IndexType type);
+	uint32_t index_type_to_GLenum(const IndexType type);
+
 	class IndexBuffer {
 	public:
-		IndexBuffer(const std::vector<GLuint>& data, const VertexBuffer::EUsage usage = VertexBuffer::EUsage::Static);
+		IndexBuffer(std::span<const GLuint> data, const VertexBuffer::EUsage usage = VertexBuffer::EUsage::Static);
+		IndexBuffer(std::span<const uint16_t> data, const VertexBuffer::EUsage usage = VertexBuffer::EUsage::Static);
 		IndexBuffer() = default;
 		~IndexBuffer();
 
@@ -19,10 +31,13 @@ namespace EngineCore {
 		void bind() const;
 		static void unbind();
 		size_t get_count() const { return m_count; };
+		uint32_t get_handle() const { return m_id; }
+		IndexType get_index_type() const { return m_type; }
 
 	private:
 		uint32_t m_id = 0;
 		size_t m_count = 0;
+		IndexType m_type = IndexType::UInt32;
 	};
 
 }
\ No newline at end of file
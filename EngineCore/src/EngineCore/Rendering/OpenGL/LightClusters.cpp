@@ -0,0 +1,203 @@
+#include "LightClusters.hpp"
+#include "EngineCore/Profiler.hpp"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace EngineCore {
+
+	// header layout shared with the fragment shaders: uvec4 dims (x, y, z, enabled), vec4 params
+	static constexpr size_t GRID_HEADER_WORDS = 8;
+
+	LightClusters::LightClusters(const uint32_t tiles_x, const uint32_t tiles_y, const uint32_t slices_z)
+		: m_tiles_x(tiles_x)
+		, m_tiles_y(tiles_y)
+		, m_slices_z(slices_z)
+	{}
+
+	float LightClusters::light_radius(const float intensity, const float linear, const float quadro, const float cutoff) {
+		// intensity / (1 + d * (linear + quadro * d)) = cutoff
+		const float c = 1.f - intensity / cutoff;
+		if (c >= 0.f) {
+			return 0.f;
+		}
+		if (quadro > 0.f) {
+			return (-linear + std::sqrt(linear * linear - 4.f * quadro * c)) / (2.f * quadro);
+		}
+		if (linear > 0.f) {
+			return -c / linear;
+		}
+		return std::numeric_limits<float>::infinity();
+	}
+
+	void LightClusters::rebuild_cluster_bounds(const Camera& camera) {
+		m_near = camera.get_near_plane();
+		m_far = camera.get_far_plane();
+		m_fov = camera.get_field_of_view();
+		m_viewport_width = camera.get_viewport_width();
+		m_viewport_height = camera.get_viewport_height();
+
+		const float aspect = (m_viewport_height != 0 ? m_viewport_width / m_viewport_height : 1.f / 2.f);
+		const float tan_half_y = std::tan(m_fov / 2.f);
+		const float tan_half_x = tan_half_y * aspect;
+
+		m_cluster_bounds.resize(static_cast<size_t>(m_tiles_x) * m_tiles_y * m_slices_z);
+
+		for (uint32_t z = 0; z < m_slices_z; ++z) {
+			const float depth_near = m_near * std::pow(m_far / m_near, static_cast<float>(z) / m_slices_z);
+			const float depth_far = m_near * std::pow(m_far / m_near, static_cast<float>(z + 1) / m_slices_z);
+
+			for (uint32_t y = 0; y < m_tiles_y; ++y) {
+				const float ndc_y0 = -1.f + 2.f * y / m_tiles_y;
+				const float ndc_y1 = -1.f + 2.f * (y + 1) / m_tiles_y;
+
+				for (uint32_t x = 0; x < m_tiles_x; ++x) {
+					const float ndc_x0 = -1.f + 2.f * x / m_tiles_x;
+					const float ndc_x1 = -1.f + 2.f * (x + 1) / m_tiles_x;
+
+					ClusterAABB box{ glm::vec3(std::numeric_limits<float>::max()), glm::vec3(std::numeric_limits<float>::lowest()) };
+					for (const float depth : { depth_near, depth_far }) {
+						for (const float ndc_x : { ndc_x0, ndc_x1 }) {
+							for (const float ndc_y : { ndc_y0, ndc_y1 }) {
+								const glm::vec3 corner(ndc_x * tan_half_x * depth, ndc_y * tan_half_y * depth, -depth);
+								box.min = glm::min(box.min, corner);
+								box.max = glm::max(box.max, corner);
+							}
+						}
+					}
+					m_cluster_bounds[cluster_index(x, y, z)] = box;
+				}
+			}
+		}
+	}
+
+	void LightClusters::update(const glm::mat4& view_matrix, const Camera& camera, std::span<const Light> lights, const bool enabled) {
+		PROFILE_SCOPE("LightClusters::update");
+		const auto start = std::chrono::steady_clock::now();
+		const bool clustered = enabled && camera.get_projection_mode() == Camera::ProjectionMode::Perspective;
+		const size_t clusters_count = static_cast<size_t>(m_tiles_x) * m_tiles_y * m_slices_z;
+
+		if (clustered && (m_near != camera.get_near_plane() || m_far != camera.get_far_plane()
+			|| m_fov != camera.get_field_of_view()
+			|| m_viewport_width != camera.get_viewport_width() || m_viewport_height != camera.get_viewport_height())) {
+			rebuild_cluster_bounds(camera);
+		}
+
+		m_pairs.clear();
+		m_light_indices.clear();
+		m_cluster_data.assign(GRID_HEADER_WORDS + clusters_count * 2, 0);
+
+		const float log_ratio = std::log(m_far / m_near);
+		const float slice_scale = m_slices_z / log_ratio;
+		const float slice_bias = -static_cast<float>(m_slices_z) * std::log(m_near) / log_ratio;
+
+		if (clustered) {
+			const float aspect = (m_viewport_height != 0 ? m_viewport_width / m_viewport_height : 1.f / 2.f);
+			const float tan_half_y = std::tan(m_fov / 2.f);
+			const float tan_half_x = tan_half_y * aspect;
+
+			auto slice_of = [&](const float depth) -> uint32_t {
+				const float slice = std::floor(std::log(depth) * slice_scale + slice_bias);
+				return static_cast<uint32_t>(std::clamp(slice, 0.f, static_cast<float>(m_slices_z - 1)));
+			};
+
+			auto tile_of = [](const float ndc, const uint32_t tiles) -> uint32_t {
+				const float tile = std::floor((ndc + 1.f) * 0.5f * tiles);
+				return static_cast<uint32_t>(std::clamp(tile, 0.f, static_cast<float>(tiles - 1)));
+			};
+
+			for (uint32_t i = 0; i < lights.size(); ++i) {
+				const glm::vec3 center = glm::vec3(view_matrix * glm::vec4(lights[i].position, 1.f));
+				const float depth = -center.z;
+				const float radius = std::min(lights[i].radius, 4.f * m_far + glm::length(center));
+
+				if (radius <= 0.f || depth + radius < m_near || depth - radius > m_far) {
+					continue;
+				}
+
+				const float depth_min = std::max(depth - radius, m_near);
+				const float depth_max = std::min(depth + radius, m_far);
+
+				// x/depth and y/depth are monotonic in each argument, so the extremes over the sphere's
+				// bounding box are reached at its corners
+				float ratio_x[2] = { std::numeric_limits<float>::max(), std::numeric_limits<float>::lowest() };
+				float ratio_y[2] = { std::numeric_limits<float>::max(), std::numeric_limits<float>::lowest() };
+				for (const float d : { depth_min, depth + radius }) {
+					for (const float sign : { -1.f, 1.f }) {
+						ratio_x[0] = std::min(ratio_x[0], (center.x + sign * radius) / d);
+						ratio_x[1] = std::max(ratio_x[1], (center.x + sign * radius) / d);
+						ratio_y[0] = std::min(ratio_y[0], (center.y + sign * radius) / d);
+						ratio_y[1] = std::max(ratio_y[1], (center.y + sign * radius) / d);
+					}
+				}
+
+				const uint32_t x0 = tile_of(ratio_x[0] / tan_half_x, m_tiles_x), x1 = tile_of(ratio_x[1] / tan_half_x, m_tiles_x);
+				const uint32_t y0 = tile_of(ratio_y[0] / tan_half_y, m_tiles_y), y1 = tile_of(ratio_y[1] / tan_half_y, m_tiles_y);
+				const uint32_t z0 = slice_of(depth_min), z1 = slice_of(depth_max);
+				const float radius_sq = radius * radius;
+
+				for (uint32_t z = z0; z <= z1; ++z) {
+					for (uint32_t y = y0; y <= y1; ++y) {
+						for (uint32_t x = x0; x <= x1; ++x) {
+							const uint32_t index = cluster_index(x, y, z);
+							auto const& box = m_cluster_bounds[index];
+							const glm::vec3 closest = glm::clamp(center, box.min, box.max);
+							const glm::vec3 delta = closest - center;
+							if (glm::dot(delta, delta) <= radius_sq) {
+								m_pairs.emplace_back(index, i);
+							}
+						}
+					}
+				}
+			}
+
+			// counting sort of (cluster, light) pairs into per-cluster ranges
+			uint32_t* clusters = m_cluster_data.data() + GRID_HEADER_WORDS;
+			for (auto const& [cluster, light] : m_pairs) {
+				++clusters[cluster * 2 + 1];
+			}
+			uint32_t offset = 0;
+			for (size_t c = 0; c < clusters_count; ++c) {
+				clusters[c * 2] = offset;
+				offset += clusters[c * 2 + 1];
+				clusters[c * 2 + 1] = 0;
+			}
+			m_light_indices.resize(m_pairs.size());
+			for (auto const& [cluster, light] : m_pairs) {
+				m_light_indices[clusters[cluster * 2] + clusters[cluster * 2 + 1]++] = light;
+			}
+		}
+
+		m_binning_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		const float params[4] = {
+			m_viewport_width / m_tiles_x,
+			m_viewport_height / m_tiles_y,
+			slice_scale,
+			slice_bias,
+		};
+		m_cluster_data[0] = m_tiles_x;
+		m_cluster_data[1] = m_tiles_y;
+		m_cluster_data[2] = m_slices_z;
+		m_cluster_data[3] = clustered ? 1 : 0;
+		std::memcpy(m_cluster_data.data() + 4, params, sizeof(params));
+
+		if (m_light_indices.empty()) {
+			m_light_indices.push_back(0);
+		}
+
+		m_grid_buffer.set_data(m_cluster_data.data(), m_cluster_data.size() * sizeof(uint32_t));
+		m_indices_buffer.set_data(m_light_indices.data(), m_light_indices.size() * sizeof(uint32_t));
+	}
+
+	void LightClusters::bind() const {
+		m_grid_buffer.bind();
+		m_indices_buffer.bind();
+	}
+
+}
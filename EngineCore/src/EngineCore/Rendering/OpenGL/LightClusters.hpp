@@ -0,0 +1,66 @@
+#pragma once
+
+#include <vector>
+#include <span>
+#include <glm/glm.hpp>
+
+#include "EngineCore/Camera.hpp"
+#include "EngineCore/Rendering/OpenGL/ShaderStorageBuffer.hpp"
+
+namespace EngineCore {
+
+	// Clustered forward lighting: point lights are binned on the CPU into a view-space froxel grid
+	// (screen tiles x exponential depth slices). Fragment shaders look up their cluster and only
+	// iterate the lights that touch it.
+	class LightClusters {
+	public:
+		struct Light {
+			glm::vec3 position;
+			float radius;
+		};
+
+		LightClusters(const uint32_t tiles_x = 16, const uint32_t tiles_y = 9, const uint32_t slices_z = 24);
+
+		// light radius at which attenuation drops below 'cutoff', infinite when the light never fades
+		static float light_radius(const float intensity, const float linear, const float quadro, const float cutoff = 1.f / 256.f);
+
+		// bins world-space lights and uploads the grid, disabled clustering makes shaders loop over every light
+		void update(const glm::mat4& view_matrix, const Camera& camera, std::span<const Light> lights, const bool enabled = true);
+		void bind() const;
+
+		double get_binning_ms() const { return m_binning_ms; }
+		size_t get_light_indices_count() const { return m_light_indices.size(); }
+
+	private:
+		struct ClusterAABB {
+			glm::vec3 min;
+			glm::vec3 max;
+		};
+
+		void rebuild_cluster_bounds(const Camera& camera);
+		uint32_t cluster_index(const uint32_t x, const uint32_t y, const uint32_t z) const {
+			return x + m_tiles_x * (y + m_tiles_y * z);
+		}
+
+		uint32_t m_tiles_x;
+		uint32_t m_tiles_y;
+		uint32_t m_slices_z;
+
+		float m_near = 0.f;
+		float m_far = 0.f;
+		float m_fov = 0.f;
+		float m_viewport_width = 0.f;
+		float m_viewport_height = 0.f;
+
+		std::vector<ClusterAABB> m_cluster_bounds;
+		std::vector<std::pair<uint32_t, uint32_t>> m_pairs;
+		std::vector<uint32_t> m_cluster_data;
+		std::vector<uint32_t> m_light_indices;
+
+		ShaderStorageBuffer m_grid_buffer{ StorageBinding::LightClusterGrid, ShaderStorageBuffer::EUsage::Stream };
+		ShaderStorageBuffer m_indices_buffer{ StorageBinding::LightClusterIndices, ShaderStorageBuffer::EUsage::Stream };
+
+		double m_binning_ms = 0.0;
+	};
+
+}
@@ -0,0 +1,294 @@
+#include "MaterialTable.hpp"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+
+#include "Renderer_OpenGL.hpp"
+#include "GLStateCache.hpp"
+#include "EngineCore/Logs.hpp"
+
+namespace EngineCore {
+
+	static constexpr uint32_t INITIAL_LAYERS = 4;
+
+	static size_t level_size(const uint32_t size, const uint32_t level) {
+		return std::max<size_t>(size >> level, 1);
+	}
+
+	MaterialTable::Material::~Material() {
+		release();
+	}
+
+	MaterialTable::Material::Material(Material&& material) noexcept
+		: m_table(material.m_table)
+		, m_id(material.m_id)
+	{
+		material.m_table = nullptr;
+	}
+
+	MaterialTable::Material& MaterialTable::Material::operator=(Material&& material) noexcept {
+		if (this != &material) {
+			release();
+			m_table = material.m_table;
+			m_id = material.m_id;
+			material.m_table = nullptr;
+		}
+		return *this;
+	}
+
+	void MaterialTable::Material::release() {
+		if (m_table) {
+			m_table->release(m_id);
+			m_table = nullptr;
+		}
+	}
+
+	MaterialTable& MaterialTable::get() {
+		// same lifetime as MeshPool: created on the render thread, never destroyed
+		static MaterialTable* table = new MaterialTable();
+		return *table;
+	}
+
+	bool MaterialTable::is_resident(std::string const& path, Texture2D::type type) const {
+		const auto key = TextureCache::make_key(path, type);
+		std::lock_guard lock(m_slots_mutex);
+		return m_slots.contains(key);
+	}
+
+	MaterialTable::Material MaterialTable::acquire(std::vector<TextureSource> const& textures) {
+		const TextureSource* sources[2] = { nullptr, nullptr };
+		for (auto const& texture : textures) {
+			if (!sources[0] && texture.type == Texture2D::type::diffuse) {
+				sources[0] = &texture;
+			}
+			if (!sources[1] && texture.type == Texture2D::type::specular) {
+				sources[1] = &texture;
+			}
+		}
+
+		MaterialKey key;
+		for (size_t i = 0; i < key.size(); ++i) {
+			if (sources[i]) {
+				key[i] = TextureCache::make_key(sources[i]->path, sources[i]->type);
+			}
+		}
+
+		Material res;
+		res.m_table = this;
+
+		if (auto it = m_ids.find(key); it != m_ids.end()) {
+			res.m_id = it->second;
+			++m_entries[res.m_id].references;
+			return res;
+		}
+
+		if (!m_free_ids.empty()) {
+			res.m_id = m_free_ids.back();
+			m_free_ids.pop_back();
+		}
+		else {
+			res.m_id = static_cast<uint32_t>(m_entries.size());
+			m_entries.emplace_back();
+			m_materials.emplace_back();
+		}
+
+		MaterialData data{ { -1, 0, -1, 0 }, DEFAULT_SHININESS };
+		MaterialEntry entry{ key, 1, true };
+		for (size_t i = 0; i < key.size(); ++i) {
+			if (sources[i]) {
+				const auto slot = acquire_slot(key[i], sources[i]->texture.get());
+				data.textures[i * 2] = slot.array;
+				data.textures[i * 2 + 1] = slot.layer;
+				// no slot to release later; the material samples white there and is not shared,
+				// so the next mesh that brings the texture gets a material of its own
+				if (slot.references == 0) {
+					entry.slots[i].clear();
+					entry.shared = false;
+				}
+			}
+		}
+
+		if (entry.shared) {
+			m_ids.emplace(std::move(key), res.m_id);
+		}
+		m_entries[res.m_id] = std::move(entry);
+		m_materials[res.m_id] = data;
+		m_dirty = true;
+		return res;
+	}
+
+	void MaterialTable::release(const uint32_t id) {
+		auto& entry = m_entries[id];
+		if (--entry.references > 0) {
+			return;
+		}
+
+		for (auto const& key : entry.slots) {
+			if (!key.empty()) {
+				release_slot(key);
+			}
+		}
+		if (entry.shared) {
+			m_ids.erase(entry.slots);
+		}
+		entry.slots = {};
+		m_free_ids.push_back(id);
+	}
+
+	MaterialTable::TextureSlot MaterialTable::acquire_slot(std::string const& key, Texture2D const* texture) {
+		std::lock_guard lock(m_slots_mutex);
+		auto [it, inserted] = m_slots.try_emplace(key);
+		auto& slot = it->second;
+		++slot.references;
+		if (!inserted) {
+			return slot;
+		}
+
+		if (!texture) {
+			// not kept, is_resident() has to stay false so the next mesh brings the texture
+			LOG_ERROR("MaterialTable: '{}' is in no layer and no texture was given, it will sample white", key);
+			m_slots.erase(it);
+			return {};
+		}
+
+		slot.array = find_array(*texture);
+		if (slot.array < 0) {
+			LOG_ERROR("MaterialTable: no texture array left for a {}x{} texture, it will sample white", texture->get_width(), texture->get_height());
+			return slot;
+		}
+
+		auto& array = m_arrays[slot.array];
+		if (!array.free_layers.empty()) {
+			slot.layer = array.free_layers.back();
+			array.free_layers.pop_back();
+		}
+		else {
+			slot.layer = static_cast<int32_t>(array.used++);
+		}
+
+		for (uint32_t level = 0; level < array.mip_levels; ++level) {
+			glCopyImageSubData(
+				texture->get_id(), GL_TEXTURE_2D, static_cast<GLint>(level), 0, 0, 0,
+				array.id, GL_TEXTURE_2D_ARRAY, static_cast<GLint>(level), 0, 0, slot.layer,
+				static_cast<GLsizei>(level_size(array.width, level)), static_cast<GLsizei>(level_size(array.height, level)), 1
+			);
+		}
+		return slot;
+	}
+
+	void MaterialTable::release_slot(std::string const& key) {
+		std::lock_guard lock(m_slots_mutex);
+		auto it = m_slots.find(key);
+		if (it == m_slots.end() || --it->second.references > 0) {
+			return;
+		}
+		if (it->second.array >= 0) {
+			m_arrays[it->second.array].free_layers.push_back(it->second.layer);
+		}
+		m_slots.erase(it);
+	}
+
+	int32_t MaterialTable::find_array(Texture2D const& texture) {
+		if (m_max_layers == 0) {
+			GLint max_layers = 0;
+			glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &max_layers);
+			m_max_layers = static_cast<uint32_t>(std::max(max_layers, 1));
+		}
+
+		for (size_t i = 0; i < m_arrays.size(); ++i) {
+			auto& array = m_arrays[i];
+			if (array.width != texture.get_width() || array.height != texture.get_height()
+				|| array.format != texture.get_format() || array.mip_levels != texture.get_mip_levels()) {
+				continue;
+			}
+			if (!array.free_layers.empty() || array.used < array.capacity) {
+				return static_cast<int32_t>(i);
+			}
+			if (array.capacity < m_max_layers) {
+				grow_array(array, std::min(array.capacity * 2, m_max_layers));
+				return static_cast<int32_t>(i);
+			}
+		}
+
+		if (m_arrays.size() >= MAX_TEXTURE_ARRAYS) {
+			return -1;
+		}
+
+		TextureArray array;
+		array.width = texture.get_width();
+		array.height = texture.get_height();
+		array.format = texture.get_format();
+		array.mip_levels = texture.get_mip_levels();
+		grow_array(array, std::min(INITIAL_LAYERS, m_max_layers));
+		m_arrays.push_back(std::move(array));
+		return static_cast<int32_t>(m_arrays.size() - 1);
+	}
+
+	// layers keep their index, so slots already written to the materials buffer stay valid
+	void MaterialTable::grow_array(TextureArray& array, const uint32_t capacity) {
+		GLuint id = 0;
+		glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &id);
+		glTextureStorage3D(id, static_cast<GLsizei>(array.mip_levels), array.format,
+			static_cast<GLsizei>(array.width), static_cast<GLsizei>(array.height), static_cast<GLsizei>(capacity));
+
+		glTextureParameteri(id, GL_TEXTURE_WRAP_S, GL_REPEAT);
+		glTextureParameteri(id, GL_TEXTURE_WRAP_T, GL_REPEAT);
+		glTextureParameteri(id, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+		glTextureParameteri(id, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+		if (array.id != 0) {
+			if (array.used > 0) {
+				for (uint32_t level = 0; level < array.mip_levels; ++level) {
+					glCopyImageSubData(
+						array.id, GL_TEXTURE_2D_ARRAY, static_cast<GLint>(level), 0, 0, 0,
+						id, GL_TEXTURE_2D_ARRAY, static_cast<GLint>(level), 0, 0, 0,
+						static_cast<GLsizei>(level_size(array.width, level)), static_cast<GLsizei>(level_size(array.height, level)),
+						static_cast<GLsizei>(array.used)
+					);
+				}
+			}
+			Renderer_OpenGL::get_state().on_texture_deleted(array.id);
+			glDeleteTextures(1, &array.id);
+		}
+
+		array.id = id;
+		array.capacity = capacity;
+	}
+
+	void MaterialTable::bind() {
+		if (m_dirty) {
+			if (m_materials.empty()) {
+				const MaterialData white{ { -1, 0, -1, 0 }, DEFAULT_SHININESS };
+				m_buffer.set_data(&white, sizeof(white));
+			}
+			else {
+				m_buffer.set_data(m_materials.data(), m_materials.size() * sizeof(MaterialData));
+			}
+			m_dirty = false;
+		}
+		m_buffer.bind();
+
+		auto& state = Renderer_OpenGL::get_state();
+		for (size_t i = 0; i < m_arrays.size(); ++i) {
+			state.bind_texture(static_cast<uint32_t>(i), m_arrays[i].id);
+		}
+	}
+
+	MaterialStats MaterialTable::get_stats() const {
+		MaterialStats res;
+		res.materials = m_entries.size() - m_free_ids.size();
+		res.texture_arrays = m_arrays.size();
+		for (auto const& array : m_arrays) {
+			res.layers_used += array.used - array.free_layers.size();
+			res.layers_allocated += array.capacity;
+
+			for (uint32_t level = 0; level < array.mip_levels; ++level) {
+				res.gpu_bytes += Texture2D::get_level_size(array.format,
+					static_cast<uint32_t>(level_size(array.width, level)), static_cast<uint32_t>(level_size(array.height, level))) * array.capacity;
+			}
+		}
+		return res;
+	}
+
+}
\ No newline at end of file
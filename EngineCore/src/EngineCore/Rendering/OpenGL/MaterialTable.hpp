@@ -0,0 +1,136 @@
+#pragma once
+
+#include <map>
+#include <array>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+
+#include "EngineCore/RenderStats.hpp"
+#include "EngineCore/Rendering/OpenGL/TextureCache.hpp"
+#include "EngineCore/Rendering/OpenGL/ShaderStorageBuffer.hpp"
+
+namespace EngineCore {
+
+	// Textures of every material are copied into GL_TEXTURE_2D_ARRAY layers, one array per
+	// size and format, and the arrays stay bound to texture units [0, MAX_TEXTURE_ARRAYS).
+	// Materials are entries of the StorageBinding::Materials buffer that name an array and a
+	// layer for each slot, so a draw selects its material by index and never binds textures.
+	// Layers are keyed by TextureCache path and type; the source texture is only needed for the copy.
+	class MaterialTable {
+	public:
+		// must match the size of 'material_arrays' and the SAMPLE_ARRAY cases in the shaders
+		static constexpr uint32_t MAX_TEXTURE_ARRAYS = 16;
+		static constexpr float DEFAULT_SHININESS = 32.f;
+
+		// matches 'MaterialData' in the shaders: x/y = diffuse array/layer, z/w = specular array/layer,
+		// an array of -1 samples white
+		struct MaterialData {
+			int32_t textures[4];
+			float shininess;
+			float pad[3];
+		};
+
+		// 'path' as given to TextureCache; 'texture' may be empty when is_resident() is true for it
+		struct TextureSource {
+			std::string path;
+			Texture2D::type type;
+			TextureCache::TextureHandle texture;
+		};
+
+		class Material {
+		public:
+			Material() = default;
+			~Material();
+
+			Material(Material const&) = delete;
+			Material& operator=(Material const&) = delete;
+			Material(Material&& material) noexcept;
+			Material& operator=(Material&& material) noexcept;
+
+			bool is_valid() const { return m_table != nullptr; }
+			// index into the materials buffer
+			uint32_t get_id() const { return m_id; }
+
+		private:
+			friend class MaterialTable;
+
+			void release();
+
+			MaterialTable* m_table = nullptr;
+			uint32_t m_id = 0;
+		};
+
+		static MaterialTable& get();
+
+		MaterialTable(MaterialTable const&) = delete;
+		MaterialTable& operator=(MaterialTable const&) = delete;
+
+		// thread safe: whether a layer already holds the texture at 'path'
+		bool is_resident(std::string const& path, Texture2D::type type) const;
+
+		// meshes with the same textures share one entry; the first diffuse and specular textures are used.
+		// Textures are copied into their layers here, the table keeps no reference to them
+		Material acquire(std::vector<TextureSource> const& textures);
+
+		// uploads changed entries, binds the buffer and every array to its unit
+		void bind();
+
+		MaterialStats get_stats() const;
+
+	private:
+		struct TextureArray {
+			uint32_t id = 0;
+			uint32_t width = 0;
+			uint32_t height = 0;
+			uint32_t format = 0;
+			uint32_t mip_levels = 0;
+			uint32_t capacity = 0;
+			uint32_t used = 0;
+			std::vector<int32_t> free_layers;
+		};
+
+		struct TextureSlot {
+			int32_t array = -1;
+			int32_t layer = 0;
+			uint32_t references = 0;
+		};
+
+		// TextureCache keys of the diffuse and specular slots, empty for none
+		using MaterialKey = std::array<std::string, 2>;
+
+		struct MaterialEntry {
+			// the slots this entry holds a reference to
+			MaterialKey slots;
+			uint32_t references = 0;
+			// found through m_ids, false when a slot could not be filled
+			bool shared = true;
+		};
+
+		MaterialTable() = default;
+
+		// a slot with no references when there is no layer for 'key' and no texture to fill one
+		TextureSlot acquire_slot(std::string const& key, Texture2D const* texture);
+		void release_slot(std::string const& key);
+		int32_t find_array(Texture2D const& texture);
+		void grow_array(TextureArray& array, const uint32_t capacity);
+		void release(const uint32_t id);
+
+		std::vector<TextureArray> m_arrays;
+		std::unordered_map<std::string, TextureSlot> m_slots;
+		// written on the render thread only, locked there for is_resident()
+		mutable std::mutex m_slots_mutex;
+
+		std::map<MaterialKey, uint32_t> m_ids;
+		std::vector<MaterialEntry> m_entries;
+		std::vector<MaterialData> m_materials;
+		std::vector<uint32_t> m_free_ids;
+
+		ShaderStorageBuffer m_buffer{ StorageBinding::Materials };
+		bool m_dirty = true;
+		uint32_t m_max_layers = 0;
+	};
+
+}
\ No newline at end of file
@@ -5,7 +5,6 @@
 
 #include <vector>
 #include <string>
-#include <format>
 #include <memory>
 
 #include "EngineCore/Rendering/OpenGL/VertexArray.hpp"
@@ -15,68 +14,49 @@
 #include "EngineCore/Rendering/OpenGL/ShaderProgram.hpp"
 #include "EngineCore/Rendering/OpenGL/Renderer_OpenGL.hpp"
 
-namespace EngineCore {
-
-	Mesh::Mesh(
-		std::vector<Vertex> const& vertices,
-		std::vector<Texture2D>& textures,
-		std::vector<GLuint> indices,
-		BufferLayout layout,
-		VertexBuffer::EUsage usage
-	):
-		vertices(vertices),
-		textures(std::move(textures)),
-		pVBO(std::make_unique<VertexBuffer>(vertices, layout, usage)),
-		pVAO(std::make_unique<VertexArray>()),
-		pIBO(std::make_unique<IndexBuffer>(indices, usage))
-	{
-		pVAO->add_vertex_buffer(*pVBO);
-		pVAO->set_index_buffer(*pIBO);
-	}
+#include <assimp/scene.h>
 
+namespace EngineCore {
 
-	std::pair<std::string, size_t> texture_type_to_string(Texture2D::type val, size_t index_array[3]) {
-		switch (val) {
-		case Texture2D::type::ambient: {
-			return { "ambient", index_array[0]++};
+	static AABB compute_bounds(std::span<const Vertex> vertices) {
+		if (vertices.empty()) {
+			return {};
 		}
-		case Texture2D::type::diffuse: {
-			return { "diffuse", index_array[1]++};
+
+		AABB box{ vertices[0].position, vertices[0].position };
+		for (auto const& vertex : vertices) {
+			box.min = glm::min(box.min, vertex.position);
+			box.max = glm::max(box.max, vertex.position);
 		}
-		case Texture2D::type::specular: {
-			return { "specular", index_array[2]++};
+		return box;
+	}
+
+	void Mesh::set_lods(std::span<const MeshLod> lods, const size_t index_count) {
+		if (lods.empty()) {
+			this->lods = { { 0, static_cast<uint32_t>(index_count), 0.f } };
 		}
+		else {
+			this->lods.assign(lods.begin(), lods.end());
 		}
-		LOG_ERROR("texture_type_to_string[MESH.cpp]: Unknown texture type");
-		return { "none", -1 };
 	}
 
-	void Mesh::draw(ShaderProgram const& shader) const {
-		shader.bind();
-
-		size_t index_array[3] = { 0, 0, 0 };
-		int cur_index = 0;
-
-		for (auto const& texture : textures) {
-			auto [name, index] = texture_type_to_string(texture.get_type(), index_array);
-			shader.set_int(std::format("material.{}{}", name, index).c_str(), cur_index);
-			texture.bind(cur_index++);
+	static void load_material_textures(
+		aiMaterial* mat, aiTextureType assimp_type, Texture2D::type type, std::vector<TextureRef>& textures
+	) {
+		for (unsigned int i = 0; i < (mat->GetTextureCount(assimp_type)); ++i) {
+			aiString str;
+			mat->GetTexture(assimp_type, i, &str);
+			textures.push_back({ str.C_Str(), type });
 		}
-
-		// LOG_INFO("MESH_TEXURES_DATA: ambient = {} | diffuse = {} | specular = {}", index_array[0], index_array[1], index_array[2]);
-
-		Renderer_OpenGL::draw(*pVAO);
-	}
-	
-	void Mesh::raw_draw(ShaderProgram const& shader) const {
-		Renderer_OpenGL::draw(*pVAO);
 	}
 
-	Mesh::Mesh(aiMesh* mesh, const aiScene* scene, const char* directory) {
-		std::vector<GLuint> indices;
+	MeshData import_mesh(aiMesh* mesh, const aiScene* scene) {
+		MeshData data;
+		data.vertices.resize(mesh->mNumVertices);
+		data.indices.reserve(static_cast<size_t>(mesh->mNumFaces) * 3);
 
 		for (uint32_t i = 0; i < mesh->mNumVertices; ++i) {
-			Vertex vert;
+			Vertex& vert = data.vertices[i];
 
 			vert.position.x = mesh->mVertices[i].x;
 			vert.position.y = mesh->mVertices[i].y;
@@ -98,44 +78,36 @@ namespace EngineCore {
 			else {
 				vert.texture_position = glm::vec2(0.0f);
 			}
-
-			vertices.push_back(vert);
 		}
 
 		for (uint32_t i = 0; i < mesh->mNumFaces; ++i) {
 			aiFace face = mesh->mFaces[i];
 			for (uint32_t j = 0; j < face.mNumIndices; ++j) {
-				indices.push_back(face.mIndices[j]);
+				data.indices.push_back(face.mIndices[j]);
 			}
 		}
 
 		if (mesh->mMaterialIndex >= 0) {
 			aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
-			load_material_textures(material, aiTextureType_DIFFUSE, Texture2D::type::diffuse, directory);
-			load_material_textures(material, aiTextureType_SPECULAR, Texture2D::type::specular, directory);
+			load_material_textures(material, aiTextureType_DIFFUSE, Texture2D::type::diffuse, data.textures);
+			load_material_textures(material, aiTextureType_SPECULAR, Texture2D::type::specular, data.textures);
 		}
 
-		BufferLayout layout = StandartPNT_layout;
-		auto usage = VertexBuffer::EUsage::Dynamic;
-
-		pVBO = std::make_unique<VertexBuffer>(vertices, layout, usage);
-		pVAO = std::make_unique<VertexArray>();
-		pIBO = std::make_unique<IndexBuffer>(indices, usage);
-		pVAO->add_vertex_buffer(*pVBO);
-		pVAO->set_index_buffer(*pIBO);
+		return data;
 	}
 
-	void Mesh::load_material_textures(
-		aiMaterial* mat, aiTextureType assimp_type, Texture2D::type type, std::string const &directory
-	) {
-		for (unsigned int i = 0; i < (mat->GetTextureCount(assimp_type)); ++i) {
-			aiString str;
-			mat->GetTexture(assimp_type, i, &str);
-			textures.emplace_back(Texture2D(read_image((directory + str.C_Str()).c_str()), type));
-		}
+	Mesh::Mesh(
+		std::span<const Vertex> vertices,
+		std::span<const GLuint> indices,
+		std::vector<MaterialTable::TextureSource> const& textures,
+		std::span<const MeshLod> lods
+	):
+		bounds(compute_bounds(vertices)),
+		allocation(MeshPool::get().allocate(vertices, indices, bounds))
+	{
+		set_lods(lods, indices.size());
+		material = MaterialTable::get().acquire(textures);
 	}
 
-	
-
 
 }
\ No newline at end of file
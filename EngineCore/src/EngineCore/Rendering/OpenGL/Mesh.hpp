@@ -3,13 +3,21 @@
 #include <glad/glad.h>
 #include <vector>
 #include <memory>
+#include <span>
+#include <string>
+#include <algorithm>
 
 #include "EngineCore/Rendering/OpenGL/VertexArray.hpp"
 #include "EngineCore/Rendering/OpenGL/VertexBuffer.hpp"
 #include "EngineCore/Rendering/OpenGL/IndexBuffer.hpp"
 #include "EngineCore/Rendering/OpenGL/Texture2D.hpp"
+#include "EngineCore/Rendering/OpenGL/TextureCache.hpp"
 #include "EngineCore/Rendering/OpenGL/ShaderProgram.hpp"
 #include "EngineCore/Rendering/OpenGL/Renderer_OpenGL.hpp"
+#include "EngineCore/Rendering/OpenGL/MeshPool.hpp"
+#include "EngineCore/Rendering/OpenGL/MaterialTable.hpp"
+#include "EngineCore/Modules/MeshSimplifier.hpp"
+#include "EngineCore/Bounds.hpp"
 
 struct aiMesh;
 struct aiScene;
@@ -20,39 +28,62 @@ enum aiTextureType;
 
 namespace EngineCore {
 
+	struct TextureRef {
+		std::string path;
+		Texture2D::type type;
+	};
+
+	// CPU side of a mesh: everything needed to create the GL objects.
+	// 'indices' holds every level of detail one after another, 'lods' has their ranges (empty = one level)
+	struct MeshData {
+		std::vector<Vertex> vertices;
+		std::vector<GLuint> indices;
+		std::vector<TextureRef> textures;
+		std::vector<MeshLod> lods;
+	};
+
+	MeshData import_mesh(aiMesh* mesh, const aiScene* scene);
+
+	// Geometry is suballocated from MeshPool and textures live in MaterialTable arrays,
+	// a mesh only keeps its ranges and its material entry
 	class Mesh {
 	public:
+		// 'textures' are copied into MaterialTable layers and not kept, 'lods' are ranges of 'indices' like in MeshData
 		Mesh(
-			std::vector<Vertex> const& vertices,
-			std::vector<Texture2D>& textures,
-			std::vector<GLuint> indices,
-			BufferLayout layout,
-			VertexBuffer::EUsage usage
+			std::span<const Vertex> vertices,
+			std::span<const GLuint> indices,
+			std::vector<MaterialTable::TextureSource> const& textures,
+			std::span<const MeshLod> lods = {}
 		);
 
-		Mesh(aiMesh* mesh, const aiScene* scene, const char* directory);
-
 		Mesh& operator=(Mesh const&) = delete;
 		Mesh(Mesh const&) = delete;
 		Mesh& operator=(Mesh&&) = default;
 		Mesh(Mesh&&) = default;
 
-		void draw(ShaderProgram const& shader) const;
-
-		void raw_draw(ShaderProgram const& shader) const;
+		const AABB& get_bounds() const { return bounds; }
+
+		// index into the materials buffer, meshes with the same textures share it
+		uint32_t get_material_id() const { return material.get_id(); }
+		const VertexArray& get_vertex_array() const { return MeshPool::get().get_vertex_array(get_index_type()); }
+		IndexType get_index_type() const { return allocation.get_index_type(); }
+		uint32_t get_vertex_count() const { return allocation.get_vertex_count(); }
+		// levels past the last one draw the last one
+		uint32_t get_lod_count() const { return static_cast<uint32_t>(lods.size()); }
+		MeshLod const& get_lod(const uint32_t lod) const { return lods[std::min<size_t>(lod, lods.size() - 1)]; }
+		uint32_t get_index_count(const uint32_t lod = 0) const { return get_lod(lod).index_count; }
+		uint32_t get_first_index(const uint32_t lod = 0) const { return allocation.get_first_index() + get_lod(lod).first_index; }
+		// indices of all levels
+		uint32_t get_allocated_index_count() const { return allocation.get_index_count(); }
+		uint32_t get_base_vertex() const { return allocation.get_base_vertex(); }
 
 	private:
+		void set_lods(std::span<const MeshLod> lods, const size_t index_count);
 
-		void load_material_textures(
-			aiMaterial* mat, aiTextureType assimp_type, Texture2D::type type, std::string const& directory
-		);
-
-		std::vector<Vertex> vertices;
-		std::vector<Texture2D> textures;
-
-		std::unique_ptr<VertexBuffer> pVBO;
-		std::unique_ptr<VertexArray> pVAO;
-		std::unique_ptr<IndexBuffer> pIBO;
+		std::vector<MeshLod> lods;
+		AABB bounds;
+		MaterialTable::Material material;
+		MeshPool::Allocation allocation;
 	};
 
 
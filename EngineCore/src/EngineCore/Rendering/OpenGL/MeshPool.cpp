@@ -0,0 +1,240 @@
+#include "MeshPool.hpp"
+
+#include <glad/glad.h>
+
+#include "Renderer_OpenGL.hpp"
+
+#include <vector>
+#include <numeric>
+#include <algorithm>
+#include <iterator>
+
+namespace EngineCore {
+
+	static constexpr GLuint VERTEX_BINDING = 0;
+	static constexpr GLuint DRAW_ID_BINDING = 1;
+
+	// copies the live part of 'buffer' into a bigger one, the old name is deleted
+	static GLuint grow_buffer(const GLuint buffer, const size_t old_size, const size_t new_size) {
+		GLuint res = 0;
+		glCreateBuffers(1, &res);
+		glNamedBufferData(res, static_cast<GLsizeiptr>(new_size), nullptr, GL_STATIC_DRAW);
+		if (buffer != 0) {
+			if (old_size > 0) {
+				glCopyNamedBufferSubData(buffer, res, 0, 0, static_cast<GLsizeiptr>(old_size));
+			}
+			glDeleteBuffers(1, &buffer);
+		}
+		return res;
+	}
+
+	std::optional<size_t> MeshPool::RangeAllocator::allocate(const size_t count) {
+		if (count == 0) {
+			return 0;
+		}
+		for (auto it = m_free.begin(); it != m_free.end(); ++it) {
+			if (it->second < count) {
+				continue;
+			}
+			const size_t offset = it->first;
+			const size_t rest = it->second - count;
+			m_free.erase(it);
+			if (rest > 0) {
+				m_free.emplace(offset + count, rest);
+			}
+			m_used += count;
+			return offset;
+		}
+		return std::nullopt;
+	}
+
+	void MeshPool::RangeAllocator::free(const size_t offset, const size_t count) {
+		if (count == 0) {
+			return;
+		}
+		m_used -= count;
+		insert_free(offset, count);
+	}
+
+	void MeshPool::RangeAllocator::grow(const size_t capacity) {
+		if (capacity <= m_capacity) {
+			return;
+		}
+		insert_free(m_capacity, capacity - m_capacity);
+		m_capacity = capacity;
+	}
+
+	void MeshPool::RangeAllocator::insert_free(size_t offset, size_t count) {
+		auto next = m_free.lower_bound(offset);
+		if (next != m_free.end() && offset + count == next->first) {
+			count += next->second;
+			next = m_free.erase(next);
+		}
+		if (next != m_free.begin()) {
+			auto prev = std::prev(next);
+			if (prev->first + prev->second == offset) {
+				prev->second += count;
+				return;
+			}
+		}
+		m_free.emplace(offset, count);
+	}
+
+	MeshPool::Allocation::~Allocation() {
+		release();
+	}
+
+	MeshPool::Allocation::Allocation(Allocation&& allocation) noexcept
+		: m_pool(allocation.m_pool)
+		, m_base_vertex(allocation.m_base_vertex)
+		, m_vertex_count(allocation.m_vertex_count)
+		, m_first_index(allocation.m_first_index)
+		, m_index_count(allocation.m_index_count)
+		, m_index_type(allocation.m_index_type)
+	{
+		allocation.m_pool = nullptr;
+	}
+
+	MeshPool::Allocation& MeshPool::Allocation::operator=(Allocation&& allocation) noexcept {
+		if (this != &allocation) {
+			release();
+			m_pool = allocation.m_pool;
+			m_base_vertex = allocation.m_base_vertex;
+			m_vertex_count = allocation.m_vertex_count;
+			m_first_index = allocation.m_first_index;
+			m_index_count = allocation.m_index_count;
+			m_index_type = allocation.m_index_type;
+			allocation.m_pool = nullptr;
+		}
+		return *this;
+	}
+
+	void MeshPool::Allocation::release() {
+		if (m_pool) {
+			m_pool->free(*this);
+			m_pool = nullptr;
+		}
+	}
+
+	MeshPool& MeshPool::get() {
+		// created on first use from the render thread and intentionally never destroyed,
+		// so its buffers do not outlive the GL context during static destruction
+		static MeshPool* pool = new MeshPool(size_t(1) << 16, size_t(1) << 18);
+		return *pool;
+	}
+
+	MeshPool::MeshPool(const size_t vertex_capacity, const size_t index_capacity) {
+		// both vertex arrays read the same vertex and draw id buffers, only the element buffer differs
+		for (auto const& pool : m_index_pools) {
+			const auto vao = pool.vertex_array.get_id();
+
+			GLuint location = 0;
+			for (const auto& cur : PackedPNT_layout.get_elements()) {
+				glEnableVertexArrayAttrib(vao, location);
+				glVertexArrayAttribFormat(vao, location, static_cast<GLint>(cur.components_cnt), cur.component_type,
+					cur.normalized ? GL_TRUE : GL_FALSE, static_cast<GLuint>(cur.offset));
+				glVertexArrayAttribBinding(vao, location, VERTEX_BINDING);
+				++location;
+			}
+
+			glEnableVertexArrayAttrib(vao, DRAW_ID_LOCATION);
+			glVertexArrayAttribIFormat(vao, DRAW_ID_LOCATION, 1, GL_UNSIGNED_INT, 0);
+			glVertexArrayAttribBinding(vao, DRAW_ID_LOCATION, DRAW_ID_BINDING);
+			glVertexArrayBindingDivisor(vao, DRAW_ID_BINDING, 1);
+		}
+
+		grow_vertices(vertex_capacity);
+		grow_indices(IndexType::UInt16, index_capacity);
+		grow_indices(IndexType::UInt32, index_capacity / 4);
+		reserve_draw_ids(1024);
+	}
+
+	void MeshPool::grow_vertices(const size_t capacity) {
+		m_vertex_buffer = grow_buffer(m_vertex_buffer, m_vertices.get_capacity() * sizeof(PackedVertex), capacity * sizeof(PackedVertex));
+		m_vertices.grow(capacity);
+		for (auto const& pool : m_index_pools) {
+			glVertexArrayVertexBuffer(pool.vertex_array.get_id(), VERTEX_BINDING, m_vertex_buffer, 0, static_cast<GLsizei>(PackedPNT_layout.get_stride()));
+		}
+	}
+
+	void MeshPool::grow_indices(const IndexType index_type, const size_t capacity) {
+		auto& pool = get_index_pool(index_type);
+		const size_t index_size = index_type_size(index_type);
+		pool.buffer = grow_buffer(pool.buffer, pool.ranges.get_capacity() * index_size, capacity * index_size);
+		pool.ranges.grow(capacity);
+		glVertexArrayElementBuffer(pool.vertex_array.get_id(), pool.buffer);
+	}
+
+	void MeshPool::reserve_draw_ids(const size_t count) {
+		if (count <= m_draw_id_count) {
+			return;
+		}
+		const size_t capacity = std::max(count, m_draw_id_count * 2);
+
+		std::vector<GLuint> ids(capacity);
+		std::iota(ids.begin(), ids.end(), 0u);
+
+		if (m_draw_id_buffer != 0) {
+			glDeleteBuffers(1, &m_draw_id_buffer);
+		}
+		glCreateBuffers(1, &m_draw_id_buffer);
+		glNamedBufferData(m_draw_id_buffer, static_cast<GLsizeiptr>(ids.size() * sizeof(GLuint)), ids.data(), GL_STATIC_DRAW);
+		Renderer_OpenGL::count_buffer_upload(ids.size() * sizeof(GLuint));
+		for (auto const& pool : m_index_pools) {
+			glVertexArrayVertexBuffer(pool.vertex_array.get_id(), DRAW_ID_BINDING, m_draw_id_buffer, 0, sizeof(GLuint));
+		}
+		m_draw_id_count = capacity;
+	}
+
+	MeshPool::Allocation MeshPool::allocate(std::span<const Vertex> vertices, std::span<const uint32_t> indices, AABB const& bounds) {
+		const IndexType index_type = vertices.size() <= MAX_UINT16_INDEXED_VERTICES ? IndexType::UInt16 : IndexType::UInt32;
+		auto& pool = get_index_pool(index_type);
+
+		auto base_vertex = m_vertices.allocate(vertices.size());
+		if (!base_vertex) {
+			grow_vertices(std::max(m_vertices.get_capacity() * 2, m_vertices.get_capacity() + vertices.size()));
+			base_vertex = m_vertices.allocate(vertices.size());
+		}
+
+		auto first_index = pool.ranges.allocate(indices.size());
+		if (!first_index) {
+			grow_indices(index_type, std::max(pool.ranges.get_capacity() * 2, pool.ranges.get_capacity() + indices.size()));
+			first_index = pool.ranges.allocate(indices.size());
+		}
+
+		const glm::vec3 extent = bounds.max - bounds.min;
+		std::vector<PackedVertex> packed;
+		packed.reserve(vertices.size());
+		for (auto const& vertex : vertices) {
+			packed.push_back(pack_vertex(vertex, bounds.min, extent));
+		}
+		glNamedBufferSubData(m_vertex_buffer, static_cast<GLintptr>(*base_vertex * sizeof(PackedVertex)), static_cast<GLsizeiptr>(packed.size() * sizeof(PackedVertex)), packed.data());
+		Renderer_OpenGL::count_buffer_upload(packed.size() * sizeof(PackedVertex));
+
+		const auto index_offset = static_cast<GLintptr>(*first_index * index_type_size(index_type));
+		if (index_type == IndexType::UInt16) {
+			const std::vector<uint16_t> narrow(indices.begin(), indices.end());
+			glNamedBufferSubData(pool.buffer, index_offset, static_cast<GLsizeiptr>(narrow.size() * sizeof(uint16_t)), narrow.data());
+			Renderer_OpenGL::count_buffer_upload(narrow.size() * sizeof(uint16_t));
+		}
+		else {
+			glNamedBufferSubData(pool.buffer, index_offset, static_cast<GLsizeiptr>(indices.size_bytes()), indices.data());
+			Renderer_OpenGL::count_buffer_upload(indices.size_bytes());
+		}
+
+		Allocation res;
+		res.m_pool = this;
+		res.m_base_vertex = static_cast<uint32_t>(*base_vertex);
+		res.m_vertex_count = static_cast<uint32_t>(vertices.size());
+		res.m_first_index = static_cast<uint32_t>(*first_index);
+		res.m_index_count = static_cast<uint32_t>(indices.size());
+		res.m_index_type = index_type;
+		return res;
+	}
+
+	void MeshPool::free(Allocation const& allocation) {
+		m_vertices.free(allocation.m_base_vertex, allocation.m_vertex_count);
+		get_index_pool(allocation.m_index_type).ranges.free(allocation.m_first_index, allocation.m_index_count);
+	}
+
+}
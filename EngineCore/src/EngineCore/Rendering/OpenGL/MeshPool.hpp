@@ -0,0 +1,118 @@
+#pragma once
+
+#include <map>
+#include <span>
+#include <array>
+#include <optional>
+#include <cstddef>
+
+#include "EngineCore/Bounds.hpp"
+#include "EngineCore/Rendering/OpenGL/VertexArray.hpp"
+#include "EngineCore/Rendering/OpenGL/VertexBuffer.hpp"
+#include "EngineCore/Rendering/OpenGL/IndexBuffer.hpp"
+
+namespace EngineCore {
+
+	// Vertices and indices of every mesh are suballocated from a few shared buffers, so meshes are
+	// drawn without rebinding and consecutive draws can be merged into one glMultiDrawElementsIndirect.
+	// Vertices are stored as PackedVertex (PackedPNT_layout); indices go to a 16 or 32 bit buffer,
+	// each behind its own vertex array, since one multi-draw reads a single index type.
+	class MeshPool {
+	public:
+		// per-draw id attribute with divisor 1: a draw with baseInstance = N reads N
+		static constexpr uint32_t DRAW_ID_LOCATION = 3;
+
+		class Allocation {
+		public:
+			Allocation() = default;
+			~Allocation();
+
+			Allocation(Allocation const&) = delete;
+			Allocation& operator=(Allocation const&) = delete;
+			Allocation(Allocation&& allocation) noexcept;
+			Allocation& operator=(Allocation&& allocation) noexcept;
+
+			bool is_valid() const { return m_pool != nullptr; }
+
+			uint32_t get_base_vertex() const { return m_base_vertex; }
+			uint32_t get_vertex_count() const { return m_vertex_count; }
+			uint32_t get_first_index() const { return m_first_index; }
+			uint32_t get_index_count() const { return m_index_count; }
+			IndexType get_index_type() const { return m_index_type; }
+
+		private:
+			friend class MeshPool;
+
+			void release();
+
+			MeshPool* m_pool = nullptr;
+			uint32_t m_base_vertex = 0;
+			uint32_t m_vertex_count = 0;
+			uint32_t m_first_index = 0;
+			uint32_t m_index_count = 0;
+			IndexType m_index_type = IndexType::UInt32;
+		};
+
+		static MeshPool& get();
+
+		MeshPool(MeshPool const&) = delete;
+		MeshPool& operator=(MeshPool const&) = delete;
+
+		// indices stay relative to the mesh, draws add the base vertex; positions are quantized
+		// inside 'bounds', which the draw has to pass to the shader to get them back
+		Allocation allocate(std::span<const Vertex> vertices, std::span<const uint32_t> indices, AABB const& bounds);
+
+		const VertexArray& get_vertex_array(const IndexType index_type) const { return get_index_pool(index_type).vertex_array; }
+
+		// grows the draw id buffer so baseInstance + instanceCount up to 'count' stays inside it
+		void reserve_draw_ids(const size_t count);
+
+		size_t get_vertex_capacity() const { return m_vertices.get_capacity(); }
+		size_t get_used_vertices() const { return m_vertices.get_used(); }
+		size_t get_index_capacity(const IndexType index_type) const { return get_index_pool(index_type).ranges.get_capacity(); }
+		size_t get_used_indices(const IndexType index_type) const { return get_index_pool(index_type).ranges.get_used(); }
+
+	private:
+		// first-fit free list over [0, capacity), neighbours are merged on free
+		class RangeAllocator {
+		public:
+			std::optional<size_t> allocate(const size_t count);
+			void free(const size_t offset, const size_t count);
+			void grow(const size_t capacity);
+
+			size_t get_capacity() const { return m_capacity; }
+			size_t get_used() const { return m_used; }
+
+		private:
+			void insert_free(size_t offset, size_t count);
+
+			std::map<size_t, size_t> m_free;
+			size_t m_capacity = 0;
+			size_t m_used = 0;
+		};
+
+		struct IndexPool {
+			VertexArray vertex_array;
+			uint32_t buffer = 0;
+			RangeAllocator ranges;
+		};
+
+		MeshPool(const size_t vertex_capacity, const size_t index_capacity);
+
+		IndexPool& get_index_pool(const IndexType index_type) { return m_index_pools[static_cast<size_t>(index_type)]; }
+		IndexPool const& get_index_pool(const IndexType index_type) const { return m_index_pools[static_cast<size_t>(index_type)]; }
+
+		void free(Allocation const& allocation);
+		void grow_vertices(const size_t capacity);
+		void grow_indices(const IndexType index_type, const size_t capacity);
+
+		uint32_t m_vertex_buffer = 0;
+		uint32_t m_draw_id_buffer = 0;
+		size_t m_draw_id_count = 0;
+
+		RangeAllocator m_vertices;
+		// indexed by IndexType
+		std::array<IndexPool, 2> m_index_pools;
+	};
+
+}
@@ -0,0 +1,187 @@
+#include "RenderQueue.hpp"
+#include "EngineCore/Profiler.hpp"
+
+#include <algorithm>
+
+#include "EngineCore/Rendering/OpenGL/Mesh.hpp"
+#include "EngineCore/Rendering/OpenGL/MeshPool.hpp"
+#include "EngineCore/Rendering/OpenGL/MaterialTable.hpp"
+#include "EngineCore/Rendering/OpenGL/VertexArray.hpp"
+#include "EngineCore/Rendering/OpenGL/Renderer_OpenGL.hpp"
+
+namespace EngineCore {
+
+	// key layout, high to low: program 12 bits | material 16 bits | vertex array 20 bits | depth 16 bits
+	static constexpr uint64_t PROGRAM_BITS = 12;
+	static constexpr uint64_t MATERIAL_BITS = 16;
+	static constexpr uint64_t VERTEX_ARRAY_BITS = 20;
+	static constexpr uint64_t DEPTH_BITS = 16;
+
+	static constexpr uint64_t field(const uint64_t value, const uint64_t bits) {
+		return value & ((uint64_t(1) << bits) - 1);
+	}
+
+	void RenderQueue::begin(const glm::mat4& view_matrix, const glm::mat4& projection_matrix, const float max_depth) {
+		m_commands.clear();
+		m_view_matrix = view_matrix;
+		m_view_projection_matrix = projection_matrix * view_matrix;
+		m_max_depth = max_depth > 0.f ? max_depth : 1.f;
+	}
+
+	uint64_t RenderQueue::make_key(ShaderProgram const& program, Mesh const& mesh, const float depth) const {
+		// front to back inside one state bucket, so early depth test rejects more
+		const float normalized = std::clamp(depth / m_max_depth, 0.f, 1.f);
+		const auto depth_bits = static_cast<uint64_t>(normalized * static_cast<float>((1 << DEPTH_BITS) - 1));
+
+		return field(program.get_id(), PROGRAM_BITS) << (MATERIAL_BITS + VERTEX_ARRAY_BITS + DEPTH_BITS)
+			| field(mesh.get_material_id(), MATERIAL_BITS) << (VERTEX_ARRAY_BITS + DEPTH_BITS)
+			| field(mesh.get_vertex_array().get_id(), VERTEX_ARRAY_BITS) << DEPTH_BITS
+			| depth_bits;
+	}
+
+	void RenderQueue::submit(ShaderProgram const& program, Mesh const& mesh, const glm::mat4& module, const uint32_t lod) {
+		const glm::vec4 center_eye = m_view_matrix * module * glm::vec4(mesh.get_bounds().get_center(), 1.f);
+		m_commands.push_back({ make_key(program, mesh, -center_eye.z), &program, &mesh, module, nullptr, 1, lod });
+	}
+
+	void RenderQueue::submit_instanced(ShaderProgram const& program, Mesh const& mesh, ShaderStorageBuffer const& instances, const uint32_t instance_count, const uint32_t lod) {
+		if (instance_count == 0) {
+			return;
+		}
+		m_commands.push_back({ make_key(program, mesh, 0.f), &program, &mesh, glm::mat4(1.f), &instances, instance_count, lod });
+	}
+
+	// draw entries and indirect commands in execution order: draw N reads entry N of both,
+	// an instanced draw starts its draw ids at N so the shader finds the entry as draw_id - gl_InstanceID
+	void RenderQueue::upload_draw_data() {
+		PROFILE_SCOPE("RenderQueue::upload_draw_data");
+		m_draw_entries.clear();
+		m_indirect_commands.clear();
+
+		size_t max_draw_id = 0;
+		for (auto const& command : m_commands) {
+			auto const& mesh = *command.mesh;
+			const auto index = static_cast<uint32_t>(m_draw_entries.size());
+			m_indirect_commands.push_back({
+				mesh.get_index_count(command.lod), command.instance_count, mesh.get_first_index(command.lod), mesh.get_base_vertex(), index
+			});
+
+			const uint32_t lod = std::min(command.lod, mesh.get_lod_count() - 1);
+			m_stats.triangles += size_t(mesh.get_index_count(lod)) / 3 * command.instance_count;
+			m_stats.full_detail_triangles += size_t(mesh.get_index_count()) / 3 * command.instance_count;
+			m_stats.lod_instances[std::min(lod, MAX_LOD_LEVELS - 1)] += command.instance_count;
+			auto const& bounds = mesh.get_bounds();
+			m_draw_entries.push_back({
+				command.module, glm::vec4(bounds.min, 0.f), glm::vec4(bounds.max - bounds.min, 0.f), mesh.get_material_id()
+			});
+			max_draw_id = std::max<size_t>(max_draw_id, index + command.instance_count);
+		}
+
+		MeshPool::get().reserve_draw_ids(max_draw_id);
+
+		m_draw_data.set_data(m_draw_entries.data(), m_draw_entries.size() * sizeof(DrawEntry));
+		m_draw_data.bind();
+
+		m_indirect_range = m_indirect_buffer.write(m_indirect_commands.data(), m_indirect_commands.size() * sizeof(IndirectCommand), sizeof(uint32_t));
+	}
+
+	void RenderQueue::execute(const bool sorted, const bool multi_draw) {
+		PROFILE_SCOPE("RenderQueue::execute");
+		if (sorted) {
+			std::stable_sort(m_commands.begin(), m_commands.end(),
+				[](DrawCommand const& a, DrawCommand const& b) { return a.key < b.key; });
+		}
+
+		m_stats = {};
+		m_stats.commands = m_commands.size();
+		if (m_commands.empty()) {
+			return;
+		}
+		upload_draw_data();
+
+		// materials are picked per draw from the buffer, they don't break a run;
+		// the vertex array also decides the index type
+		auto can_merge = [](DrawCommand const& first, DrawCommand const& next) {
+			return next.instances == nullptr
+				&& next.program == first.program
+				&& next.mesh->get_vertex_array().get_id() == first.mesh->get_vertex_array().get_id();
+		};
+
+		// texture arrays are bound once for the whole queue, whatever the program
+		MaterialTable::get().bind();
+		++m_stats.material_binds;
+		// binds a per-material path would have skipped: the material of the previous command repeats
+		for (size_t i = 1; i < m_commands.size(); ++i) {
+			if (m_commands[i].mesh->get_material_id() == m_commands[i - 1].mesh->get_material_id()) {
+				++m_stats.material_binds_saved;
+			}
+		}
+
+		// nothing is assumed about the state left by code outside the queue
+		const ShaderProgram* bound_program = nullptr;
+		uint32_t bound_vertex_array = 0;
+		const ShaderStorageBuffer* bound_instances = nullptr;
+
+		for (size_t i = 0; i < m_commands.size();) {
+			auto const& command = m_commands[i];
+
+			if (command.program != bound_program) {
+				command.program->bind();
+				bound_program = command.program;
+				++m_stats.program_binds;
+			}
+			else {
+				++m_stats.program_binds_saved;
+			}
+
+			auto const& mesh = *command.mesh;
+			auto const& vertex_array = mesh.get_vertex_array();
+			if (vertex_array.get_id() != bound_vertex_array) {
+				vertex_array.bind();
+				bound_vertex_array = vertex_array.get_id();
+				++m_stats.vertex_array_binds;
+			}
+			else {
+				++m_stats.vertex_array_binds_saved;
+			}
+
+			if (command.instances) {
+				if (command.instances != bound_instances) {
+					command.instances->bind();
+					bound_instances = command.instances;
+				}
+				Renderer_OpenGL::draw_elements(mesh.get_index_type(), mesh.get_index_count(command.lod), mesh.get_first_index(command.lod), mesh.get_base_vertex(), command.instance_count, static_cast<uint32_t>(i));
+				++i;
+				continue;
+			}
+
+			size_t run = 1;
+			if (multi_draw) {
+				while (i + run < m_commands.size() && can_merge(command, m_commands[i + run])) {
+					++run;
+				}
+			}
+
+			if (run > 1) {
+				size_t indices_count = 0;
+				size_t instance_count = 0;
+				for (size_t j = i; j < i + run; ++j) {
+					indices_count += size_t(m_indirect_commands[j].count) * m_indirect_commands[j].instance_count;
+					instance_count += m_indirect_commands[j].instance_count;
+				}
+				Renderer_OpenGL::multi_draw_indirect(mesh.get_index_type(), m_indirect_range.buffer, m_indirect_range.offset, i, run, indices_count, instance_count);
+				++m_stats.multi_draw_batches;
+				m_stats.multi_draw_commands += run;
+				// merged commands reuse the state of the first one
+				m_stats.program_binds_saved += run - 1;
+				m_stats.vertex_array_binds_saved += run - 1;
+			}
+			else {
+				Renderer_OpenGL::draw_elements(mesh.get_index_type(), mesh.get_index_count(command.lod), mesh.get_first_index(command.lod), mesh.get_base_vertex(), 1, static_cast<uint32_t>(i));
+			}
+
+			i += run;
+		}
+	}
+
+}
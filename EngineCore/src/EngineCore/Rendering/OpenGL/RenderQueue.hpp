@@ -0,0 +1,94 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+#include "EngineCore/RenderStats.hpp"
+#include "EngineCore/Rendering/OpenGL/ShaderProgram.hpp"
+#include "EngineCore/Rendering/OpenGL/ShaderStorageBuffer.hpp"
+#include "EngineCore/Rendering/OpenGL/StreamBuffer.hpp"
+
+namespace EngineCore {
+
+	class Mesh;
+
+	// Deferred submission: the frame loop records draw commands, execute() sorts them by
+	// program -> material -> vertex array -> depth and skips binds of state that is already set.
+	// Model transforms, mesh bounds (to dequantize PackedVertex positions) and material indices
+	// go to StorageBinding::DrawData, the vertex shader picks
+	// its entry by the MeshPool draw id, so runs of commands with the same program become one
+	// multi-draw call even when their materials differ.
+	class RenderQueue {
+	public:
+		struct DrawCommand {
+			uint64_t key;
+			const ShaderProgram* program;
+			const Mesh* mesh;
+			glm::mat4 module;
+			// per-instance data for instanced commands, bound to its own StorageBinding
+			const ShaderStorageBuffer* instances;
+			uint32_t instance_count;
+			uint32_t lod;
+		};
+
+		RenderQueue() = default;
+
+		RenderQueue(RenderQueue const&) = delete;
+		RenderQueue& operator=(RenderQueue const&) = delete;
+
+		// 'max_depth' is the far plane, depth beyond it shares the last sort bucket
+		void begin(const glm::mat4& view_matrix, const glm::mat4& projection_matrix, const float max_depth);
+
+		// 'lod' past the last level of the mesh draws the last one
+		void submit(ShaderProgram const& program, Mesh const& mesh, const glm::mat4& module, const uint32_t lod = 0);
+		void submit_instanced(ShaderProgram const& program, Mesh const& mesh, ShaderStorageBuffer const& instances, const uint32_t instance_count, const uint32_t lod = 0);
+
+		// 'sorted' = false keeps submission order, 'multi_draw' = false issues one draw per command
+		void execute(const bool sorted = true, const bool multi_draw = true);
+
+		const glm::mat4& get_view_projection_matrix() const { return m_view_projection_matrix; }
+		const RenderQueueStats& get_stats() const { return m_stats; }
+		size_t size() const { return m_commands.size(); }
+
+	private:
+		// matches 'DrawEntry' in the shaders
+		struct DrawEntry {
+			glm::mat4 module;
+			// position = position_offset + packed position * position_scale
+			glm::vec4 position_offset;
+			glm::vec4 position_scale;
+			uint32_t material;
+			uint32_t pad[3];
+		};
+
+		// matches DrawElementsIndirectCommand
+		struct IndirectCommand {
+			uint32_t count;
+			uint32_t instance_count;
+			uint32_t first_index;
+			uint32_t base_vertex;
+			uint32_t base_instance;
+		};
+
+		uint64_t make_key(ShaderProgram const& program, Mesh const& mesh, const float depth) const;
+		void upload_draw_data();
+
+		std::vector<DrawCommand> m_commands;
+
+		std::vector<DrawEntry> m_draw_entries;
+		std::vector<IndirectCommand> m_indirect_commands;
+		// both are rewritten every frame, the rings keep the CPU off buffers the GPU still reads
+		ShaderStorageBuffer m_draw_data{ StorageBinding::DrawData, ShaderStorageBuffer::EUsage::Stream };
+		StreamBuffer m_indirect_buffer;
+		StreamBuffer::Range m_indirect_range;
+
+		glm::mat4 m_view_matrix{ 1.f };
+		glm::mat4 m_view_projection_matrix{ 1.f };
+		float m_max_depth = 1.f;
+
+		RenderQueueStats m_stats;
+	};
+
+}
@@ -3,12 +3,33 @@
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
+#include <cstdint>
+
 #include "VertexArray.hpp"
+#include "GLStateCache.hpp"
 #include "EngineCore/Logs.hpp"
 
 
 namespace EngineCore {
 	
+	static uint64_t frame_index = 0;
+	static RenderFrameStats frame_stats;
+
+	static GLFunctions make_gl_functions() {
+		GLFunctions functions;
+		functions.use_program = [](uint32_t program) { glUseProgram(program); ++frame_stats.program_binds; };
+		functions.bind_vertex_array = [](uint32_t vertex_array) { glBindVertexArray(vertex_array); ++frame_stats.vertex_array_binds; };
+		functions.bind_texture_unit = [](uint32_t unit, uint32_t texture) { glBindTextureUnit(unit, texture); ++frame_stats.texture_binds; };
+		functions.set_depth_test = [](bool enabled) { enabled ? glEnable(GL_DEPTH_TEST) : glDisable(GL_DEPTH_TEST); };
+		functions.set_clear_color = [](float r, float g, float b, float a) { glClearColor(r, g, b, a); };
+		return functions;
+	}
+
+	GLStateCache& Renderer_OpenGL::get_state() {
+		// trivially destructible, stays valid for GL objects released during static destruction
+		static GLStateCache state(make_gl_functions());
+		return state;
+	}
 
 	const char* get_source_description(GLenum source) {
 		switch (source) {
@@ -19,7 +40,7 @@ namespace EngineCore {
 		case GL_DEBUG_SOURCE_APPLICATION: return "APPLICATION";
 		case GL_DEBUG_SOURCE_OTHER: return "OTHER";
 		}
-		LOG_ERROR("[UNKNOWN OPENGL ERROR SOURCE]: {}", source);
+		LOG_CATEGORY_ERROR(OpenGL, "[UNKNOWN OPENGL ERROR SOURCE]: {}", source);
 		return "-1";
 	}
 
@@ -35,42 +56,42 @@ namespace EngineCore {
 		case GL_DEBUG_TYPE_POP_GROUP: return "POP_GROUP";
 		case GL_DEBUG_TYPE_OTHER: return "OTHER";
 		}
-		LOG_ERROR("[UNKNOWN OPENGL ERROR TYPE]: {}", type);
+		LOG_CATEGORY_ERROR(OpenGL, "[UNKNOWN OPENGL ERROR TYPE]: {}", type);
 		return "-1";
 	}
 
 	void OpenGL_Debug(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, const GLchar* message, const void*) {
 		switch (severity) {
 		case GL_DEBUG_SEVERITY_HIGH:
-			LOG_ERROR("OpenGL Error: [{0}:{1}]({2}): {3}",
+			LOG_CATEGORY_ERROR(OpenGL, "OpenGL Error: [{0}:{1}]({2}): {3}",
 				get_source_description(source),
 				get_type_description(type),
 				id,
 				message);
 			break;
 		case GL_DEBUG_SEVERITY_MEDIUM:
-			LOG_WARN("OpenGL Warning: [{0}:{1}]({2}): {3}",
+			LOG_CATEGORY_WARN(OpenGL, "OpenGL Warning: [{0}:{1}]({2}): {3}",
 				get_source_description(source),
 				get_type_description(type),
 				id,
 				message);
 			break;
 		case GL_DEBUG_SEVERITY_LOW:
-			LOG_INFO("OpenGL Info: [{0}:{1}]({2}): {3}",
+			LOG_CATEGORY_INFO(OpenGL, "OpenGL Info: [{0}:{1}]({2}): {3}",
 				get_source_description(source),
 				get_type_description(type),
 				id,
 				message);
 			break;
 		case GL_DEBUG_SEVERITY_NOTIFICATION:
-			LOG_INFO("OpenGL Notificaton: [{0}:{1}]({2}): {3}",
+			LOG_CATEGORY_INFO(OpenGL, "OpenGL Notificaton: [{0}:{1}]({2}): {3}",
 				get_source_description(source),
 				get_type_description(type),
 				id,
 				message);
 			break;
 		default:
-			LOG_ERROR("OpenGL Error: [{0}:{1}] ({2}) : {3}",
+			LOG_CATEGORY_ERROR(OpenGL, "OpenGL Error: [{0}:{1}] ({2}) : {3}",
 				get_source_description(source),
 				get_type_description(type),
 				id,
@@ -105,11 +126,83 @@ namespace EngineCore {
 
 	void Renderer_OpenGL::draw(const VertexArray& vertex_arr) {
 		vertex_arr.bind();
-		glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(vertex_arr.get_indicies_count()), GL_UNSIGNED_INT, nullptr);
+		glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(vertex_arr.get_indicies_count()), index_type_to_GLenum(vertex_arr.get_index_type()), nullptr);
+		++frame_stats.draw_calls;
+		++frame_stats.draws;
+		++frame_stats.instances;
+		frame_stats.indices += vertex_arr.get_indicies_count();
+	}
+
+	void Renderer_OpenGL::draw_elements(const IndexType index_type, const uint32_t indices_count, const uint32_t first_index, const uint32_t base_vertex, const uint32_t instance_count, const uint32_t base_instance) {
+		if (instance_count == 0) {
+			return;
+		}
+		glDrawElementsInstancedBaseVertexBaseInstance(
+			GL_TRIANGLES,
+			static_cast<GLsizei>(indices_count),
+			index_type_to_GLenum(index_type),
+			reinterpret_cast<const void*>(static_cast<uintptr_t>(first_index) * index_type_size(index_type)),
+			static_cast<GLsizei>(instance_count),
+			static_cast<GLint>(base_vertex),
+			base_instance
+		);
+		++frame_stats.draw_calls;
+		++frame_stats.draws;
+		frame_stats.instances += instance_count;
+		frame_stats.indices += size_t(indices_count) * instance_count;
+	}
+
+	void Renderer_OpenGL::multi_draw_indirect(const IndexType index_type, const uint32_t commands, const size_t commands_offset, const size_t first_command, const size_t command_count,
+		const size_t indices_count, const size_t instance_count) {
+		if (command_count == 0) {
+			return;
+		}
+		// layout of DrawElementsIndirectCommand
+		static constexpr size_t COMMAND_SIZE = 5 * sizeof(GLuint);
+
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commands);
+		glMultiDrawElementsIndirect(
+			GL_TRIANGLES,
+			index_type_to_GLenum(index_type),
+			reinterpret_cast<const void*>(commands_offset + first_command * COMMAND_SIZE),
+			static_cast<GLsizei>(command_count),
+			0
+		);
+		++frame_stats.draw_calls;
+		frame_stats.draws += command_count;
+		frame_stats.instances += instance_count;
+		frame_stats.indices += indices_count;
+	}
+
+	void Renderer_OpenGL::begin_frame() {
+		++frame_index;
+		frame_stats = {};
+		frame_stats.frame = frame_index;
+	}
+
+	uint64_t Renderer_OpenGL::get_frame_index() {
+		return frame_index;
+	}
+
+	RenderFrameStats const& Renderer_OpenGL::get_frame_stats() {
+		return frame_stats;
+	}
+
+	void Renderer_OpenGL::count_uniform_upload() {
+		++frame_stats.uniform_uploads;
+	}
+
+	void Renderer_OpenGL::count_buffer_upload(const size_t bytes) {
+		++frame_stats.buffer_uploads;
+		frame_stats.buffer_bytes += bytes;
+	}
+
+	void Renderer_OpenGL::count_texture_upload(const size_t bytes) {
+		frame_stats.texture_bytes += bytes;
 	}
 
 	void Renderer_OpenGL::set_clear_color(const float color[4]) {
-		glClearColor(color[0], color[1], color[2], color[3]);
+		get_state().set_clear_color(color);
 	}
 
 	void Renderer_OpenGL::clear() {
@@ -133,11 +226,11 @@ namespace EngineCore {
 	}
 
 	void Renderer_OpenGL::enable_depth_testing() {
-		glEnable(GL_DEPTH_TEST);
+		get_state().set_depth_test(true);
 	}
 
 	void Renderer_OpenGL::disable_depth_testing() {
-		glDisable(GL_DEPTH_TEST);
+		get_state().set_depth_test(false);
 	};
 
 }
\ No newline at end of file
@@ -1,16 +1,30 @@
 #pragma once 
 
+#include <cstddef>
+#include <cstdint>
+
+#include "EngineCore/RenderStats.hpp"
+
 struct GLFWwindow;
 
 namespace EngineCore {
 	using uint32_t = unsigned int;
 	class VertexArray;
+	class GLStateCache;
+	enum class IndexType;
 
 	class Renderer_OpenGL {
 	public:
 		static bool init(GLFWwindow* pWindow, const bool debug);
 
 		static void draw(const VertexArray& vertex_arr);
+		// draws a range of the index buffer of the vertex array that is already bound,
+		// 'first_index' counts indices of 'index_type'
+		static void draw_elements(const IndexType index_type, const uint32_t indices_count, const uint32_t first_index, const uint32_t base_vertex, const uint32_t instance_count = 1, const uint32_t base_instance = 0);
+		// 'commands' is a GL_DRAW_INDIRECT_BUFFER of DrawElementsIndirectCommand starting at byte 'commands_offset',
+		// read from 'first_command'; 'indices_count' and 'instance_count' are what the commands draw, for the frame stats
+		static void multi_draw_indirect(const IndexType index_type, const uint32_t commands, const size_t commands_offset, const size_t first_command, const size_t command_count,
+			const size_t indices_count, const size_t instance_count);
 		static void set_clear_color(const float color[4]);
 		static void clear();
 		static void set_viewport(const uint32_t width, const uint32_t height, const uint32_t left_offset = 0, const uint32_t bottom_offset = 0);
@@ -20,6 +34,20 @@ namespace EngineCore {
 		static const char* get_vendor_str();
 		static const char* get_renderer_str();
 		static const char* get_version_str();
+
+		// every bind of programs, vertex arrays and textures goes through this cache
+		static GLStateCache& get_state();
+
+		// advances the frame StreamBuffer regions are fenced by and starts new frame stats,
+		// called once before recording a frame
+		static void begin_frame();
+		static uint64_t get_frame_index();
+
+		// counters of the frame being recorded
+		static RenderFrameStats const& get_frame_stats();
+		static void count_uniform_upload();
+		static void count_buffer_upload(const size_t bytes);
+		static void count_texture_upload(const size_t bytes);
 	};
 }
 
@@ -1,15 +1,23 @@
 
 #include "ShaderProgram.hpp"
+#include "Renderer_OpenGL.hpp"
+#include "GLStateCache.hpp"
 #include "EngineCore/Logs.hpp"
 #include "EngineCore/Modules/FileRead.hpp"
 #include <glad/glad.h>
 #include <glm/gtc/type_ptr.hpp>
 
+#include <type_traits>
+#include <string_view>
+
 namespace EngineCore {
 
-	bool create_shader(const char* source, const GLenum shader_type, GLuint& shader_id) {
+	bool create_shader(std::string_view source, const GLenum shader_type, GLuint& shader_id) {
 		shader_id = glCreateShader(shader_type);
-		glShaderSource(shader_id, 1, &source, nullptr);
+		// the source comes straight from a FileView, so it is not null-terminated
+		const GLchar* data = source.data();
+		const GLint length = static_cast<GLint>(source.size());
+		glShaderSource(shader_id, 1, &data, &length);
 		glCompileShader(shader_id);
 
 		GLint res;
@@ -25,11 +33,15 @@ namespace EngineCore {
 	}
 	
 	ShaderProgram::ShaderProgram(const char* path_vertex, const char* path_fragment) {
-		auto vertex_shader_src = read_file(path_vertex);
-		auto fragment_shader_src = read_file(path_fragment);
+		const FileView vertex_shader_src(path_vertex);
+		const FileView fragment_shader_src(path_fragment);
+		if (!vertex_shader_src.is_open() || !fragment_shader_src.is_open()) {
+			LOG_CRITICAL("[FILE READ] Failed to read shader '{}'", vertex_shader_src.is_open() ? path_fragment : path_vertex);
+			return;
+		}
 
 		GLuint vertex_shader_id = 0;
-		if (!create_shader(vertex_shader_src.c_str(), GL_VERTEX_SHADER, vertex_shader_id)) {
+		if (!create_shader(vertex_shader_src.str(), GL_VERTEX_SHADER, vertex_shader_id)) {
 			LOG_CRITICAL("Vertex shader compile error!");
 			LOG_CRITICAL("PATH = {}", path_vertex);
 			glDeleteShader(vertex_shader_id);
@@ -37,7 +49,7 @@ namespace EngineCore {
 		} 
 
 		GLuint fragment_shader_id = 0;
-		if (!create_shader(fragment_shader_src.c_str(), GL_FRAGMENT_SHADER, fragment_shader_id)) {
+		if (!create_shader(fragment_shader_src.str(), GL_FRAGMENT_SHADER, fragment_shader_id)) {
 			LOG_CRITICAL("Fragment shader compile error!");
 			LOG_CRITICAL("PATH = {}", path_fragment);
 			glDeleteShader(vertex_shader_id);
@@ -64,6 +76,7 @@ namespace EngineCore {
 		}
 		else {
 			m_isCompiled = true;
+			reflect_uniforms();
 		}
 
 		glDetachShader(m_id, vertex_shader_id);
@@ -73,21 +86,24 @@ namespace EngineCore {
 	}
 
 	ShaderProgram::~ShaderProgram() {
+		Renderer_OpenGL::get_state().on_program_deleted(m_id);
 		glDeleteProgram(m_id);
 	}
 
 	void ShaderProgram::bind() const {
-		glUseProgram(m_id);
+		Renderer_OpenGL::get_state().use_program(m_id);
 	}
 
 	void ShaderProgram::unbind() {
-		glUseProgram(0);
+		Renderer_OpenGL::get_state().use_program(0);
 	}
 
 	ShaderProgram& ShaderProgram::operator=(ShaderProgram&& shaderProgram) {
+		Renderer_OpenGL::get_state().on_program_deleted(m_id);
 		glDeleteProgram(m_id);
 		m_id = shaderProgram.m_id;
 		m_isCompiled = shaderProgram.m_isCompiled;
+		m_uniforms = std::move(shaderProgram.m_uniforms);
 
 		shaderProgram.m_id = 0;
 		shaderProgram.m_isCompiled = false;
@@ -97,37 +113,156 @@ namespace EngineCore {
 	ShaderProgram::ShaderProgram(ShaderProgram&& shaderProgram) {
 		m_id = shaderProgram.m_id;
 		m_isCompiled = shaderProgram.m_isCompiled;
+		m_uniforms = std::move(shaderProgram.m_uniforms);
 
 		shaderProgram.m_id = 0;
 		shaderProgram.m_isCompiled = false;
 	}
 
+	void ShaderProgram::reflect_uniforms() {
+		GLint count = 0, max_length = 0;
+		glGetProgramiv(m_id, GL_ACTIVE_UNIFORMS, &count);
+		glGetProgramiv(m_id, GL_ACTIVE_UNIFORM_MAX_LENGTH, &max_length);
+
+		std::string name(static_cast<size_t>(max_length), '\0');
+		for (GLint i = 0; i < count; ++i) {
+			GLsizei length = 0;
+			GLint size = 0;
+			GLenum type = 0;
+			glGetActiveUniform(m_id, static_cast<GLuint>(i), max_length, &length, &size, &type, name.data());
+
+			std::string uniform_name(name.data(), static_cast<size_t>(length));
+			GLint location = glGetUniformLocation(m_id, uniform_name.c_str());
+			if (location < 0) {
+				// uniform block member
+				continue;
+			}
+			m_uniforms[uniform_name] = { location, type };
+
+			// arrays of basic types are reported once as 'name[0]', register every element and the bare name
+			if (uniform_name.ends_with("[0]")) {
+				auto base = uniform_name.substr(0, uniform_name.size() - 3);
+				m_uniforms[base] = { location, type };
+				for (GLint j = 1; j < size; ++j) {
+					auto element = base + '[' + std::to_string(j) + ']';
+					m_uniforms[element] = { glGetUniformLocation(m_id, element.c_str()), type };
+				}
+			}
+		}
+	}
+
+	int ShaderProgram::get_location(const char* name) const {
+		auto it = m_uniforms.find(name);
+		return it != m_uniforms.end() ? it->second.location : -1;
+	}
+
+	template<typename T>
+	constexpr bool is_uniform_type_compatible(const GLenum type) {
+		if constexpr (std::is_same_v<T, glm::mat4>) {
+			return type == GL_FLOAT_MAT4;
+		}
+		else if constexpr (std::is_same_v<T, glm::mat3>) {
+			return type == GL_FLOAT_MAT3;
+		}
+		else if constexpr (std::is_same_v<T, glm::vec3>) {
+			return type == GL_FLOAT_VEC3;
+		}
+		else if constexpr (std::is_same_v<T, float>) {
+			return type == GL_FLOAT;
+		}
+		else if constexpr (std::is_same_v<T, unsigned int>) {
+			return type == GL_UNSIGNED_INT;
+		}
+		else if constexpr (std::is_same_v<T, int>) {
+			return type == GL_INT || type == GL_BOOL
+				|| type == GL_SAMPLER_2D || type == GL_SAMPLER_2D_ARRAY || type == GL_SAMPLER_CUBE;
+		}
+		return false;
+	}
+
+	template<typename T>
+	ShaderProgram::Uniform<T> ShaderProgram::get_uniform(const char* name) const {
+		auto it = m_uniforms.find(name);
+		if (it == m_uniforms.end()) {
+			return {};
+		}
+		if (!is_uniform_type_compatible<T>(it->second.type)) {
+			LOG_ERROR("SHADER PROGRAM: uniform '{}' has GL type 0x{:X}, incompatible with the requested handle", name, it->second.type);
+			return {};
+		}
+		return { it->second.location };
+	}
+
+	template ShaderProgram::Uniform<glm::mat4> ShaderProgram::get_uniform<glm::mat4>(const char*) const;
+	template ShaderProgram::Uniform<glm::mat3> ShaderProgram::get_uniform<glm::mat3>(const char*) const;
+	template ShaderProgram::Uniform<glm::vec3> ShaderProgram::get_uniform<glm::vec3>(const char*) const;
+	template ShaderProgram::Uniform<float> ShaderProgram::get_uniform<float>(const char*) const;
+	template ShaderProgram::Uniform<int> ShaderProgram::get_uniform<int>(const char*) const;
+	template ShaderProgram::Uniform<unsigned int> ShaderProgram::get_uniform<unsigned int>(const char*) const;
+
+	void ShaderProgram::set(Uniform<glm::mat4> uniform, const glm::mat4& mat) const {
+		glUniformMatrix4fv(uniform.location, 1, GL_FALSE, glm::value_ptr(mat));
+		Renderer_OpenGL::count_uniform_upload();
+	}
+
+	void ShaderProgram::set(Uniform<glm::mat3> uniform, const glm::mat3& mat) const {
+		glUniformMatrix3fv(uniform.location, 1, GL_FALSE, glm::value_ptr(mat));
+		Renderer_OpenGL::count_uniform_upload();
+	}
+
+	void ShaderProgram::set(Uniform<int> uniform, const int num) const {
+		glUniform1i(uniform.location, num);
+		Renderer_OpenGL::count_uniform_upload();
+	}
+
+	void ShaderProgram::set(Uniform<unsigned int> uniform, const unsigned int num) const {
+		glUniform1ui(uniform.location, num);
+		Renderer_OpenGL::count_uniform_upload();
+	}
+
+	void ShaderProgram::set(Uniform<float> uniform, const float num) const {
+		glUniform1f(uniform.location, num);
+		Renderer_OpenGL::count_uniform_upload();
+	}
+
+	void ShaderProgram::set(Uniform<glm::vec3> uniform, const glm::vec3& vec) const {
+		glUniform3f(uniform.location, vec[0], vec[1], vec[2]);
+		Renderer_OpenGL::count_uniform_upload();
+	}
+
 	void ShaderProgram::set_mat4(const char* name, const glm::mat4& mat) const {
-		glUniformMatrix4fv(glGetUniformLocation(m_id, name), 1, GL_FALSE, glm::value_ptr(mat));
+		glUniformMatrix4fv(get_location(name), 1, GL_FALSE, glm::value_ptr(mat));
+		Renderer_OpenGL::count_uniform_upload();
 	}
 
 	void ShaderProgram::set_mat3(const char* name, const glm::mat3& mat) const {
-		glUniformMatrix3fv(glGetUniformLocation(m_id, name), 1, GL_FALSE, glm::value_ptr(mat));
+		glUniformMatrix3fv(get_location(name), 1, GL_FALSE, glm::value_ptr(mat));
+		Renderer_OpenGL::count_uniform_upload();
 	}
 
 	void ShaderProgram::set_int(const char* name, const int num) const {
-		glUniform1i(glGetUniformLocation(m_id, name), num);
+		glUniform1i(get_location(name), num);
+		Renderer_OpenGL::count_uniform_upload();
 	};
 
 	void ShaderProgram::set_uint(const char* name, const unsigned int num) const {
-		glUniform1ui(glGetUniformLocation(m_id, name), num);
+		glUniform1ui(get_location(name), num);
+		Renderer_OpenGL::count_uniform_upload();
 	}
 
 	void ShaderProgram::set_float(const char* name, const float num) const {
-		glUniform1f(glGetUniformLocation(m_id, name), num);
+		glUniform1f(get_location(name), num);
+		Renderer_OpenGL::count_uniform_upload();
 	};
 
 	void ShaderProgram::set_vec3(const char* name, const float x, const float y, const float z) const {
-		glUniform3f(glGetUniformLocation(m_id, name), x, y, z);
+		glUniform3f(get_location(name), x, y, z);
+		Renderer_OpenGL::count_uniform_upload();
 	};
 
 	void ShaderProgram::set_vec3(const char* name, const glm::vec3& vec) const {
-		glUniform3f(glGetUniformLocation(m_id, name), vec[0], vec[1], vec[2]);
+		glUniform3f(get_location(name), vec[0], vec[1], vec[2]);
+		Renderer_OpenGL::count_uniform_upload();
 	}
 
 }
\ No newline at end of file
@@ -1,12 +1,22 @@
 #pragma once 
 #include <glm/glm.hpp>
 
+#include <string>
+#include <unordered_map>
+
 namespace EngineCore {
 
 	using uint32_t = unsigned int;
 
 	class ShaderProgram {
 	public:
+		// location of an active uniform resolved at link time, T is the C++ type it is set with
+		template<typename T>
+		struct Uniform {
+			int location = -1;
+			bool is_valid() const { return location >= 0; }
+		};
+
 		ShaderProgram(const char* path_vertex, const char* path_fragment);
 		ShaderProgram(ShaderProgram&&);
 		ShaderProgram& operator=(ShaderProgram&&);
@@ -27,9 +37,30 @@ namespace EngineCore {
 		void set_vec3(const char* name, const float x, const float y, const float z) const;
 		void set_vec3(const char* name, const glm::vec3& vec) const;
 
+		template<typename T>
+		Uniform<T> get_uniform(const char* name) const;
+
+		void set(Uniform<glm::mat4> uniform, const glm::mat4& mat) const;
+		void set(Uniform<glm::mat3> uniform, const glm::mat3& mat) const;
+		void set(Uniform<int> uniform, const int num) const;
+		void set(Uniform<unsigned int> uniform, const unsigned int num) const;
+		void set(Uniform<float> uniform, const float num) const;
+		void set(Uniform<glm::vec3> uniform, const glm::vec3& vec) const;
+
+		uint32_t get_id() const { return m_id; }
+
 	private:
+		struct UniformInfo {
+			int location;
+			uint32_t type;
+		};
+
+		void reflect_uniforms();
+		int get_location(const char* name) const;
+
 		bool m_isCompiled = false;
 		uint32_t m_id = 0;
+		std::unordered_map<std::string, UniformInfo> m_uniforms;
 	};
 
 
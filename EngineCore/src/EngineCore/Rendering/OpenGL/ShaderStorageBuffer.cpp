@@ -0,0 +1,92 @@
+#include "ShaderStorageBuffer.hpp"
+
+#include <glad/glad.h>
+
+#include "StreamBuffer.hpp"
+#include "Renderer_OpenGL.hpp"
+
+namespace EngineCore {
+
+	ShaderStorageBuffer::ShaderStorageBuffer(const StorageBinding binding, const EUsage usage)
+		: m_binding(binding)
+	{
+		if (usage == EUsage::Stream) {
+			m_stream = std::make_unique<StreamBuffer>();
+		}
+		else {
+			glCreateBuffers(1, &m_id);
+		}
+	}
+
+	ShaderStorageBuffer::~ShaderStorageBuffer() {
+		glDeleteBuffers(1, &m_id);
+	}
+
+	ShaderStorageBuffer& ShaderStorageBuffer::operator=(ShaderStorageBuffer&& buffer) noexcept {
+		glDeleteBuffers(1, &m_id);
+		m_id = buffer.m_id;
+		m_binding = buffer.m_binding;
+		m_capacity = buffer.m_capacity;
+		m_stream = std::move(buffer.m_stream);
+		m_stream_id = buffer.m_stream_id;
+		m_offset = buffer.m_offset;
+		m_size = buffer.m_size;
+		buffer.m_id = 0;
+		buffer.m_capacity = 0;
+		buffer.m_size = 0;
+		return *this;
+	}
+
+	ShaderStorageBuffer::ShaderStorageBuffer(ShaderStorageBuffer&& buffer) noexcept
+		: m_id(buffer.m_id)
+		, m_binding(buffer.m_binding)
+		, m_capacity(buffer.m_capacity)
+		, m_stream(std::move(buffer.m_stream))
+		, m_stream_id(buffer.m_stream_id)
+		, m_offset(buffer.m_offset)
+		, m_size(buffer.m_size)
+	{
+		buffer.m_id = 0;
+		buffer.m_capacity = 0;
+		buffer.m_size = 0;
+	}
+
+	void ShaderStorageBuffer::set_data(const void* data, const size_t size) {
+		if (m_stream) {
+			const auto range = m_stream->write(data, size);
+			m_stream_id = range.buffer;
+			m_offset = range.offset;
+			m_size = range.size;
+			return;
+		}
+
+		if (size > m_capacity) {
+			glNamedBufferData(m_id, static_cast<GLsizeiptr>(size), data, GL_DYNAMIC_DRAW);
+			m_capacity = size;
+		}
+		else {
+			glNamedBufferSubData(m_id, 0, static_cast<GLsizeiptr>(size), data);
+		}
+		Renderer_OpenGL::count_buffer_upload(size);
+	}
+
+	void ShaderStorageBuffer::bind() const {
+		if (m_stream) {
+			if (m_size > 0) {
+				glBindBufferRange(GL_SHADER_STORAGE_BUFFER, static_cast<GLuint>(m_binding), m_stream_id,
+					static_cast<GLintptr>(m_offset), static_cast<GLsizeiptr>(m_size));
+			}
+			return;
+		}
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, static_cast<GLuint>(m_binding), m_id);
+	}
+
+	uint32_t ShaderStorageBuffer::get_handle() const {
+		return m_stream ? m_stream_id : m_id;
+	}
+
+	size_t ShaderStorageBuffer::get_capacity() const {
+		return m_stream ? m_stream->get_frame_capacity() : m_capacity;
+	}
+
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+namespace EngineCore {
+	using uint32_t = unsigned int;
+
+	// binding points shared by every shader program, must match 'layout(std430, binding = N)' in the shaders
+	enum class StorageBinding : uint32_t {
+		PointLights = 0,
+		LightClusterGrid = 1,
+		LightClusterIndices = 2,
+		InstanceTransforms = 3,
+		DrawData = 4,
+		Materials = 5,
+	};
+
+	class StreamBuffer;
+
+	class ShaderStorageBuffer {
+	public:
+		enum class EUsage {
+			// one buffer, reallocated when the data outgrows it
+			Dynamic,
+			// rewritten every frame through a persistently mapped StreamBuffer ring
+			Stream,
+		};
+
+		ShaderStorageBuffer(const StorageBinding binding, const EUsage usage = EUsage::Dynamic);
+		~ShaderStorageBuffer();
+
+		ShaderStorageBuffer(const ShaderStorageBuffer&) = delete;
+		ShaderStorageBuffer& operator=(const ShaderStorageBuffer&) = delete;
+		ShaderStorageBuffer& operator=(ShaderStorageBuffer&& buffer) noexcept;
+		ShaderStorageBuffer(ShaderStorageBuffer&& buffer) noexcept;
+
+		// Dynamic reallocates only when the data outgrows the buffer,
+		// Stream copies into this frame's region and bind() binds that range
+		void set_data(const void* data, const size_t size);
+		void bind() const;
+
+		uint32_t get_handle() const;
+		size_t get_capacity() const;
+
+	private:
+		uint32_t m_id = 0;
+		StorageBinding m_binding;
+		size_t m_capacity = 0;
+
+		std::unique_ptr<StreamBuffer> m_stream;
+		// where the last Stream write went, the ring may have been replaced by a bigger one since
+		uint32_t m_stream_id = 0;
+		size_t m_offset = 0;
+		size_t m_size = 0;
+	};
+
+}
@@ -0,0 +1,132 @@
+#include "StreamBuffer.hpp"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "Renderer_OpenGL.hpp"
+#include "EngineCore/Logs.hpp"
+
+namespace EngineCore {
+
+	static constexpr GLbitfield MAP_FLAGS = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+	static constexpr GLuint64 WAIT_TIMEOUT_NS = 1000000000;
+
+	static size_t align_up(const size_t value, const size_t alignment) {
+		return (value + alignment - 1) / alignment * alignment;
+	}
+
+	size_t StreamBuffer::get_storage_alignment() {
+		static const size_t alignment = [] {
+			GLint res = 0;
+			glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &res);
+			// mat4 and uvec4 members need at least 16 bytes
+			return std::max<size_t>(static_cast<size_t>(res), 16);
+		}();
+		return alignment;
+	}
+
+	StreamBuffer::StreamBuffer(const size_t frame_capacity) {
+		allocate(frame_capacity);
+	}
+
+	StreamBuffer::~StreamBuffer() {
+		release();
+	}
+
+	void StreamBuffer::allocate(const size_t frame_capacity) {
+		m_frame_capacity = align_up(std::max<size_t>(frame_capacity, 1), get_storage_alignment());
+		const auto size = static_cast<GLsizeiptr>(m_frame_capacity * FRAMES_IN_FLIGHT);
+
+		glCreateBuffers(1, &m_id);
+		glNamedBufferStorage(m_id, size, nullptr, MAP_FLAGS);
+		m_mapped = static_cast<unsigned char*>(glMapNamedBufferRange(m_id, 0, size, MAP_FLAGS));
+		if (!m_mapped) {
+			LOG_CRITICAL("StreamBuffer: failed to map {} bytes", size);
+		}
+	}
+
+	// draws already recorded keep the old storage alive, GL frees it once they are done
+	void StreamBuffer::release() {
+		retire();
+		release_retired();
+	}
+
+	// the buffer stays valid for ranges written this frame, it is deleted when the next one starts
+	void StreamBuffer::retire() {
+		for (auto& fence : m_fences) {
+			if (fence) {
+				glDeleteSync(fence);
+				fence = nullptr;
+			}
+		}
+		if (m_id != 0) {
+			glUnmapNamedBuffer(m_id);
+			m_retired.push_back(m_id);
+		}
+		m_id = 0;
+		m_mapped = nullptr;
+	}
+
+	void StreamBuffer::release_retired() {
+		if (!m_retired.empty()) {
+			glDeleteBuffers(static_cast<GLsizei>(m_retired.size()), m_retired.data());
+			m_retired.clear();
+		}
+	}
+
+	void StreamBuffer::next_region() {
+		release_retired();
+		if (m_head > 0) {
+			m_fences[m_region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+			m_region = (m_region + 1) % FRAMES_IN_FLIGHT;
+		}
+		m_head = 0;
+
+		auto& fence = m_fences[m_region];
+		if (!fence) {
+			return;
+		}
+
+		GLenum status = glClientWaitSync(fence, 0, 0);
+		if (status == GL_TIMEOUT_EXPIRED) {
+			++m_stalls;
+			do {
+				status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, WAIT_TIMEOUT_NS);
+			} while (status == GL_TIMEOUT_EXPIRED);
+		}
+		if (status == GL_WAIT_FAILED) {
+			LOG_ERROR("StreamBuffer: waiting for a frame fence failed");
+		}
+		glDeleteSync(fence);
+		fence = nullptr;
+	}
+
+	StreamBuffer::Range StreamBuffer::write(const void* data, const size_t size, const size_t alignment) {
+		const uint64_t frame = Renderer_OpenGL::get_frame_index();
+		if (frame != m_frame) {
+			next_region();
+			m_frame = frame;
+		}
+
+		const size_t align = alignment != 0 ? alignment : get_storage_alignment();
+		size_t offset = align_up(m_head, align);
+		if (offset + size > m_frame_capacity) {
+			retire();
+			allocate(std::max(m_frame_capacity * 2, offset + size));
+			m_region = 0;
+			offset = 0;
+			LOG_INFO("StreamBuffer: grown to {} bytes per frame", m_frame_capacity);
+		}
+
+		const size_t start = static_cast<size_t>(m_region) * m_frame_capacity + offset;
+		if (m_mapped && size > 0) {
+			std::memcpy(m_mapped + start, data, size);
+			Renderer_OpenGL::count_buffer_upload(size);
+		}
+		m_head = offset + size;
+		return { m_id, start, size };
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+struct __GLsync;
+
+namespace EngineCore {
+
+	// Persistently mapped ring for data rewritten every frame. The buffer holds one region per
+	// frame in flight, a region is fenced when its frame is over and only written again once the
+	// GPU has passed the fence, so writes never wait on an implicit driver sync or reallocation.
+	// Frames are counted by Renderer_OpenGL::begin_frame.
+	class StreamBuffer {
+	public:
+		static constexpr uint32_t FRAMES_IN_FLIGHT = 3;
+
+		// bytes from the start of 'buffer', valid until the end of the frame it was written in
+		struct Range {
+			uint32_t buffer = 0;
+			size_t offset = 0;
+			size_t size = 0;
+		};
+
+		explicit StreamBuffer(const size_t frame_capacity = 64 * 1024);
+		~StreamBuffer();
+
+		StreamBuffer(StreamBuffer const&) = delete;
+		StreamBuffer& operator=(StreamBuffer const&) = delete;
+
+		// 'alignment' = 0 uses the shader storage offset alignment. A region that is too small for the
+		// frame is replaced by a bigger buffer and the rest of the frame is written there; the old one is
+		// kept until the next frame, so ranges written before stay valid but name the old buffer
+		Range write(const void* data, const size_t size, const size_t alignment = 0);
+
+		uint32_t get_handle() const { return m_id; }
+		size_t get_frame_capacity() const { return m_frame_capacity; }
+		// writes that had to wait for the GPU to release their region
+		size_t get_stall_count() const { return m_stalls; }
+
+		static size_t get_storage_alignment();
+
+	private:
+		void allocate(const size_t frame_capacity);
+		void release();
+		void retire();
+		void release_retired();
+		void next_region();
+
+		uint32_t m_id = 0;
+		unsigned char* m_mapped = nullptr;
+		size_t m_frame_capacity = 0;
+
+		uint32_t m_region = 0;
+		size_t m_head = 0;
+		uint64_t m_frame = UINT64_MAX;
+		std::array<__GLsync*, FRAMES_IN_FLIGHT> m_fences{};
+		// buffers replaced during the current frame
+		std::vector<uint32_t> m_retired;
+
+		size_t m_stalls = 0;
+	};
+
+}
\ No newline at end of file
@@ -1,13 +1,34 @@
 #include <glad/glad.h>
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 #include "Texture2D.hpp"
+#include "Renderer_OpenGL.hpp"
+#include "GLStateCache.hpp"
 #include "EngineCore/Logs.hpp"
 
+// EXT_texture_compression_s3tc is not part of the generated loader
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
 namespace EngineCore {
 
 	using uint32_t = unsigned int;
 
+    static GLenum block_format_to_GLenum(const BlockFormat format) {
+        switch (format) {
+        case BlockFormat::BC1: return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+        case BlockFormat::BC3: return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        case BlockFormat::BC5: return GL_COMPRESSED_RG_RGTC2;
+        case BlockFormat::BC7: return GL_COMPRESSED_RGBA_BPTC_UNORM;
+        }
+        return GL_NONE;
+    }
+
     Texture2D::Texture2D(Image_t const& img, Texture2D::type t):
         m_width(img.width), 
         m_height(img.height),
@@ -15,16 +36,21 @@ namespace EngineCore {
 	{
         const GLsizei mip_levels = static_cast<GLsizei>(log2(std::max(img.width, img.height))) + 1;
         glCreateTextures(GL_TEXTURE_2D, 1, &m_id);
+        m_mip_levels = static_cast<uint32_t>(mip_levels);
 
         if (img.fmt == Image_t::format::JPEG) {
+            m_format = GL_RGB8;
             glTextureStorage2D(m_id, mip_levels, GL_RGB8, img.width, img.height);
             glTextureSubImage2D(m_id, 0, 0, 0, img.width, img.height, GL_RGB, GL_UNSIGNED_BYTE, img.image);
+            Renderer_OpenGL::count_texture_upload(size_t(img.width) * img.height * 3);
         }
         if (img.fmt == Image_t::format::PNG) {
             //(GLuint texture, GLsizei levels, GLenum internalformat, GLsizei width, GLsizei height);
+            m_format = GL_RGBA8;
             glTextureStorage2D(m_id, mip_levels, GL_RGBA8, img.width, img.height);
             //(GLuint texture, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const void* pixels)
             glTextureSubImage2D(m_id, 0, 0, 0, img.width, img.height, GL_RGBA, GL_UNSIGNED_BYTE, img.image);
+            Renderer_OpenGL::count_texture_upload(size_t(img.width) * img.height * 4);
         }
 
 
@@ -33,39 +59,112 @@ namespace EngineCore {
         glTextureParameteri(m_id, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
         glTextureParameteri(m_id, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
         glGenerateTextureMipmap(m_id);
+
+        for (GLsizei level = 0; level < mip_levels; ++level) {
+            m_memory_size += get_level_size(m_format, std::max(img.width >> level, 1), std::max(img.height >> level, 1));
+        }
 	}
 
+    Texture2D::Texture2D(CompressedImage_t const& img, Texture2D::type t):
+        m_width(img.width),
+        m_height(img.height),
+        m_format(block_format_to_GLenum(img.format)),
+        m_mip_levels(static_cast<uint32_t>(img.levels.size())),
+        m_type(t)
+    {
+        glCreateTextures(GL_TEXTURE_2D, 1, &m_id);
+        glTextureStorage2D(m_id, static_cast<GLsizei>(m_mip_levels), m_format, img.width, img.height);
+        for (uint32_t i = 0; i < m_mip_levels; ++i) {
+            auto const& level = img.levels[i];
+            glCompressedTextureSubImage2D(m_id, static_cast<GLint>(i), 0, 0, level.width, level.height,
+                m_format, static_cast<GLsizei>(level.size), img.data.data() + level.offset);
+            Renderer_OpenGL::count_texture_upload(level.size);
+            m_memory_size += level.size;
+        }
+
+        glTextureParameteri(m_id, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTextureParameteri(m_id, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glTextureParameteri(m_id, GL_TEXTURE_MIN_FILTER, m_mip_levels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+        glTextureParameteri(m_id, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    }
+
+    bool Texture2D::is_format_supported(const BlockFormat format) {
+        if (format == BlockFormat::BC5 || format == BlockFormat::BC7) {
+            return true;
+        }
+
+        static const bool s3tc = []() {
+            GLint count = 0;
+            glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+            for (GLint i = 0; i < count; ++i) {
+                auto name = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i)));
+                if (name && std::strcmp(name, "GL_EXT_texture_compression_s3tc") == 0) {
+                    return true;
+                }
+            }
+            LOG_WARN("GL_EXT_texture_compression_s3tc is missing, BC1/BC3 textures are decoded from their sources");
+            return false;
+        }();
+        return s3tc;
+    }
+
+    size_t Texture2D::get_level_size(const uint32_t format, const uint32_t width, const uint32_t height) {
+        switch (format) {
+        case GL_COMPRESSED_RGB_S3TC_DXT1_EXT: return get_compressed_level_size(BlockFormat::BC1, width, height);
+        case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT: return get_compressed_level_size(BlockFormat::BC3, width, height);
+        case GL_COMPRESSED_RG_RGTC2: return get_compressed_level_size(BlockFormat::BC5, width, height);
+        case GL_COMPRESSED_RGBA_BPTC_UNORM: return get_compressed_level_size(BlockFormat::BC7, width, height);
+        case GL_RGB8: return size_t(width) * height * 3;
+        default: return size_t(width) * height * 4;
+        }
+    }
+
     Texture2D::~Texture2D() {
+        Renderer_OpenGL::get_state().on_texture_deleted(m_id);
         glDeleteTextures(1, &m_id);
     }
 
     Texture2D& Texture2D::operator=(Texture2D&& texture) noexcept {
+        Renderer_OpenGL::get_state().on_texture_deleted(m_id);
         glDeleteTextures(1, &m_id);
         m_id = texture.m_id;
         m_width = texture.m_width;
         m_height = texture.m_height;
+        m_format = texture.m_format;
+        m_mip_levels = texture.m_mip_levels;
         m_type = texture.m_type;
+        m_memory_size = texture.m_memory_size;
         texture.m_id = 0;
         texture.m_width = 0;
         texture.m_height = 0;
+        texture.m_format = 0;
+        texture.m_mip_levels = 0;
         texture.m_type = Texture2D::type::none;
+        texture.m_memory_size = 0;
         return *this;
     }
 
     Texture2D::Texture2D(Texture2D&& texture) noexcept {
+        Renderer_OpenGL::get_state().on_texture_deleted(m_id);
         glDeleteTextures(1, &m_id);
         m_id = texture.m_id;
         m_width = texture.m_width;
         m_height = texture.m_height;
+        m_format = texture.m_format;
+        m_mip_levels = texture.m_mip_levels;
         m_type = texture.m_type;
+        m_memory_size = texture.m_memory_size;
         texture.m_id = 0;
         texture.m_width = 0;
         texture.m_height = 0;
+        texture.m_format = 0;
+        texture.m_mip_levels = 0;
         texture.m_type = Texture2D::type::none;
+        texture.m_memory_size = 0;
     }
 
     void Texture2D::bind(const uint32_t unit) const {
-        glBindTextureUnit(unit, m_id);
+        Renderer_OpenGL::get_state().bind_texture(unit, m_id);
     }
 
 }
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <cstddef>
+
 #include "EngineCore/Modules/FileRead.hpp"
+#include "EngineCore/Modules/TextureFile.hpp"
 
 namespace EngineCore {
 	using uint32_t = unsigned int;
@@ -16,6 +19,8 @@ namespace EngineCore {
 		};
 
 		Texture2D(Image_t const& img, type t);
+		// uploads the cooked levels as they are, no mipmaps are generated
+		Texture2D(CompressedImage_t const& img, type t);
 		~Texture2D();
 
 		Texture2D(const Texture2D&) = delete;
@@ -30,19 +35,47 @@ namespace EngineCore {
 		type get_type() const {
 			return m_type;
 		}
+		uint32_t get_width() const {
+			return m_width;
+		}
+		uint32_t get_height() const {
+			return m_height;
+		}
+		// sized internal format of the storage (GL_RGB8 / GL_RGBA8 or a block compressed one)
+		uint32_t get_format() const {
+			return m_format;
+		}
+		uint32_t get_mip_levels() const {
+			return m_mip_levels;
+		}
+		// GPU storage of all mip levels in bytes
+		size_t get_memory_size() const {
+			return m_memory_size;
+		}
+
+		// BC1/BC3 come from EXT_texture_compression_s3tc, the others are core; render thread only
+		static bool is_format_supported(const BlockFormat format);
+		// bytes of a width x height level in 'format', any format get_format() returns
+		static size_t get_level_size(const uint32_t format, const uint32_t width, const uint32_t height);
 
 		void free() {
 			m_id = 0;
 			m_width = 0;
 			m_height = 0;
+			m_format = 0;
+			m_mip_levels = 0;
 			m_type = Texture2D::type::none;
+			m_memory_size = 0;
 		}
 
 	private:
 		uint32_t m_id = 0;
 		uint32_t m_width = 0;
 		uint32_t m_height = 0;
+		uint32_t m_format = 0;
+		uint32_t m_mip_levels = 0;
 		type m_type;
+		size_t m_memory_size = 0;
 	};
 
 
@@ -0,0 +1,93 @@
+#include "TextureCache.hpp"
+#include "EngineCore/Logs.hpp"
+
+#include <filesystem>
+
+namespace EngineCore {
+
+	TextureCache& TextureCache::get() {
+		static TextureCache cache;
+		return cache;
+	}
+
+	std::string TextureCache::make_key(std::string const& path, Texture2D::type type) {
+		std::error_code ec;
+		auto canonical = std::filesystem::weakly_canonical(path, ec);
+		std::string key = ec ? path : canonical.generic_string();
+		key += '#';
+		key += static_cast<char>(type);
+		return key;
+	}
+
+	bool TextureCache::is_resident(std::string const& path, Texture2D::type type) const {
+		auto key = make_key(path, type);
+		std::lock_guard lock(m_mutex);
+		auto it = m_textures.find(key);
+		return it != m_textures.end() && !it->second.expired();
+	}
+
+	TextureCache::TextureHandle TextureCache::find(std::string const& path, Texture2D::type type) {
+		auto key = make_key(path, type);
+		std::lock_guard lock(m_mutex);
+		auto it = m_textures.find(key);
+		if (it == m_textures.end()) {
+			return nullptr;
+		}
+
+		auto texture = it->second.lock();
+		if (!texture) {
+			m_textures.erase(it);
+			return nullptr;
+		}
+
+		++m_hits;
+		m_bytes_saved += texture->get_memory_size();
+		return texture;
+	}
+
+	TextureCache::TextureHandle TextureCache::insert(std::string const& path, Texture2D::type type, TextureImage const& img) {
+		auto key = make_key(path, type);
+
+		Texture2D* created = nullptr;
+		if (auto compressed = std::get_if<CompressedImage_t>(&img)) {
+			created = Texture2D::is_format_supported(compressed->format)
+				? new Texture2D(*compressed, type)
+				: new Texture2D(read_image(path.c_str()), type);
+		}
+		else {
+			created = new Texture2D(std::get<Image_t>(img), type);
+		}
+
+		TextureHandle texture(created, [this](Texture2D* texture) {
+			m_gpu_bytes_resident -= texture->get_memory_size();
+			--m_textures_resident;
+			delete texture;
+		});
+
+		++m_misses;
+		m_gpu_bytes_resident += texture->get_memory_size();
+		++m_textures_resident;
+
+		std::lock_guard lock(m_mutex);
+		m_textures[key] = texture;
+		return texture;
+	}
+
+	TextureCache::TextureHandle TextureCache::load(std::string const& path, Texture2D::type type) {
+		if (auto texture = find(path, type)) {
+			return texture;
+		}
+		return insert(path, type, load_texture_image(path));
+	}
+
+	TextureCache::Stats TextureCache::get_stats() const {
+		Stats stats;
+		stats.hits = m_hits;
+		stats.misses = m_misses;
+		stats.bytes_saved = m_bytes_saved;
+		stats.gpu_bytes_resident = m_gpu_bytes_resident;
+		stats.textures_resident = m_textures_resident;
+		return stats;
+	}
+
+}
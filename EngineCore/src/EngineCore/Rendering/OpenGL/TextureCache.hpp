@@ -0,0 +1,56 @@
+#pragma once
+
+#include <string>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <unordered_map>
+
+#include "EngineCore/Rendering/OpenGL/Texture2D.hpp"
+#include "EngineCore/Modules/TextureFile.hpp"
+
+namespace EngineCore {
+
+	// Shares Texture2D objects between meshes. Entries are keyed by canonical file path and texture type
+	// and held weakly, a texture is released as soon as the last mesh using it is gone.
+	class TextureCache {
+	public:
+		using TextureHandle = std::shared_ptr<Texture2D>;
+
+		struct Stats {
+			size_t hits = 0;
+			size_t misses = 0;
+			size_t bytes_saved = 0;
+			size_t gpu_bytes_resident = 0;
+			size_t textures_resident = 0;
+		};
+
+		static TextureCache& get();
+
+		// thread safe, doesn't touch GL
+		bool is_resident(std::string const& path, Texture2D::type type) const;
+
+		// render thread only; cooked images the GL can't sample are replaced by their decoded source
+		TextureHandle find(std::string const& path, Texture2D::type type);
+		TextureHandle insert(std::string const& path, Texture2D::type type, TextureImage const& img);
+		TextureHandle load(std::string const& path, Texture2D::type type);
+
+		Stats get_stats() const;
+
+		// canonical path and type, MaterialTable keys its layers the same way
+		static std::string make_key(std::string const& path, Texture2D::type type);
+
+	private:
+		TextureCache() = default;
+
+		std::unordered_map<std::string, std::weak_ptr<Texture2D>> m_textures;
+		mutable std::mutex m_mutex;
+
+		std::atomic<size_t> m_hits{ 0 };
+		std::atomic<size_t> m_misses{ 0 };
+		std::atomic<size_t> m_bytes_saved{ 0 };
+		std::atomic<size_t> m_gpu_bytes_resident{ 0 };
+		std::atomic<size_t> m_textures_resident{ 0 };
+	};
+
+}
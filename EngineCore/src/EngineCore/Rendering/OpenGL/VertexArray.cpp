@@ -2,21 +2,25 @@
 #include "VertexArray.hpp"
 #include "VertexBuffer.hpp"
 #include "IndexBuffer.hpp"
+#include "Renderer_OpenGL.hpp"
+#include "GLStateCache.hpp"
 #include <glad/glad.h>
 
 namespace EngineCore {
 
 	VertexArray::VertexArray() {
-		glGenVertexArrays(1, &m_id);
+		glCreateVertexArrays(1, &m_id);
 	}
 
 	VertexArray::~VertexArray() {
+		Renderer_OpenGL::get_state().on_vertex_array_deleted(m_id);
 		glDeleteVertexArrays(1, &m_id);
 	}
 
 	VertexArray& VertexArray::operator=(VertexArray&& vertex_array) noexcept {
 		m_id = vertex_array.m_id;
 		m_elements_count = vertex_array.m_elements_count;
+		m_index_type = vertex_array.m_index_type;
 		vertex_array.m_id = 0;
 		vertex_array.m_elements_count = 0;
 		return *this;
@@ -25,50 +29,67 @@ namespace EngineCore {
 	VertexArray::VertexArray(VertexArray&& vertex_array) noexcept 
 		:m_id(vertex_array.m_id)
 		,m_elements_count(vertex_array.m_elements_count)
+		,m_index_type(vertex_array.m_index_type)
 	{
 		vertex_array.m_id = 0;
 		vertex_array.m_elements_count = 0;
 	}
 
 	void VertexArray::bind() const {
-		glBindVertexArray(m_id);
+		Renderer_OpenGL::get_state().bind_vertex_array(m_id);
 	}
 
 	void VertexArray::unbind() {
-		glBindVertexArray(0);
+		Renderer_OpenGL::get_state().bind_vertex_array(0);
 	}
 
-	void VertexArray::add_vertex_buffer(const VertexBuffer& vertex_buffer) {
-		bind();
-		
+	// set up through DSA, so creating a mesh never touches the bound vertex array
+	uint32_t VertexArray::add_vertex_buffer(const VertexBuffer& vertex_buffer) {
+		const uint32_t first_attribute = m_elements_count;
 		for (const auto& cur : vertex_buffer.get_layout().get_elements()) {
-			glad_glEnableVertexAttribArray(m_elements_count);
+			glEnableVertexArrayAttrib(m_id, m_elements_count);
 
-			glBindVertexBuffer(
+			glVertexArrayVertexBuffer(
+				m_id,
 				m_elements_count,
 				vertex_buffer.get_handle(),
-				cur.offset,
+				vertex_buffer.get_offset() + cur.offset,
 				static_cast<GLsizei>(vertex_buffer.get_layout().get_stride())
 			);
 
-			glVertexAttribFormat(
+			glVertexArrayAttribFormat(
+				m_id,
 				m_elements_count,
 				static_cast<GLint>(cur.components_cnt),
 				cur.component_type,
-				GL_FALSE, 
+				cur.normalized ? GL_TRUE : GL_FALSE,
 				0
 			);
 
-			glVertexAttribBinding(m_elements_count, m_elements_count);
+			glVertexArrayAttribBinding(m_id, m_elements_count, m_elements_count);
 
 			++m_elements_count;
 		}
+		return first_attribute;
+	}
+
+	void VertexArray::set_vertex_buffer(const uint32_t first_attribute, const VertexBuffer& vertex_buffer) {
+		uint32_t attribute = first_attribute;
+		for (const auto& cur : vertex_buffer.get_layout().get_elements()) {
+			glVertexArrayVertexBuffer(
+				m_id,
+				attribute++,
+				vertex_buffer.get_handle(),
+				vertex_buffer.get_offset() + cur.offset,
+				static_cast<GLsizei>(vertex_buffer.get_layout().get_stride())
+			);
+		}
 	}
 
 	void VertexArray::set_index_buffer(const IndexBuffer& index_buffer) {
-		bind();
-		index_buffer.bind();
+		glVertexArrayElementBuffer(m_id, index_buffer.get_handle());
 		m_indicies_count = index_buffer.get_count();
+		m_index_type = index_buffer.get_index_type();
 	}
 
 }
\ No newline at end of file
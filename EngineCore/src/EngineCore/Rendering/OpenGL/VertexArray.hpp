@@ -16,15 +16,20 @@ namespace EngineCore {
 		VertexArray& operator=(VertexArray&& vertexArray) noexcept;
 		VertexArray(VertexArray&& vertexArray) noexcept;
 
-		void add_vertex_buffer(const VertexBuffer& vertex_buffer);
+		// returns the first attribute of the buffer, needed to re-point a Stream buffer after set_data
+		uint32_t add_vertex_buffer(const VertexBuffer& vertex_buffer);
+		void set_vertex_buffer(const uint32_t first_attribute, const VertexBuffer& vertex_buffer);
 		void set_index_buffer(const IndexBuffer& index_buffer);
 		void bind() const;
 		static void unbind();
 		size_t get_indicies_count() const { return m_indicies_count; };
+		IndexType get_index_type() const { return m_index_type; }
+		uint32_t get_id() const { return m_id; }
 
 	private:
 		uint32_t m_id = 0;
 		uint32_t m_elements_count = 0;
 		size_t m_indicies_count = 0;
+		IndexType m_index_type = IndexType::UInt32;
 	};
 }
\ No newline at end of file
@@ -1,11 +1,17 @@
 
 #include "VertexBuffer.hpp"
+#include "StreamBuffer.hpp"
+#include "Renderer_OpenGL.hpp"
 
 #include "EngineCore/Logs.hpp" 
 
 #include <glad/glad.h>
 
 #include <glm/glm.hpp>
+#include <glm/gtc/packing.hpp>
+
+#include <algorithm>
+#include <cmath>
 
 namespace EngineCore {
 
@@ -16,12 +22,18 @@ namespace EngineCore {
 			return 1;
 		case ShaderDataType::Float2:
 		case ShaderDataType::Int2:
+		case ShaderDataType::Half2:
+		case ShaderDataType::Short2Norm:
+		case ShaderDataType::UShort2Norm:
 			return 2;
 		case ShaderDataType::Float3:
 		case ShaderDataType::Int3:
 			return 3;
 		case ShaderDataType::Float4:
 		case ShaderDataType::Int4:
+		case ShaderDataType::Half4:
+		case ShaderDataType::Short4Norm:
+		case ShaderDataType::UShort4Norm:
 			return 4;
 		}
 		LOG_ERROR("shader_data_type_to_components_count: Unknown ShaderDataType!");
@@ -40,6 +52,13 @@ namespace EngineCore {
 		case ShaderDataType::Int3:
 		case ShaderDataType::Int4:
 			return sizeof(GLint) * shader_data_type_to_components_count(type);
+		case ShaderDataType::Half2:
+		case ShaderDataType::Half4:
+		case ShaderDataType::Short2Norm:
+		case ShaderDataType::Short4Norm:
+		case ShaderDataType::UShort2Norm:
+		case ShaderDataType::UShort4Norm:
+			return sizeof(GLshort) * shader_data_type_to_components_count(type);
 		}
 		LOG_ERROR("shader_data_type_size: Unknown ShaderDataType!");
 		return 0;
@@ -57,11 +76,32 @@ namespace EngineCore {
 		case ShaderDataType::Int3:
 		case ShaderDataType::Int4:
 			return GL_INT;
+		case ShaderDataType::Half2:
+		case ShaderDataType::Half4:
+			return GL_HALF_FLOAT;
+		case ShaderDataType::Short2Norm:
+		case ShaderDataType::Short4Norm:
+			return GL_SHORT;
+		case ShaderDataType::UShort2Norm:
+		case ShaderDataType::UShort4Norm:
+			return GL_UNSIGNED_SHORT;
 		}
 		LOG_ERROR("shader_data_type_to_component_type: Unknown ShaderDataType!");
 		return GL_FLOAT;
 	}
 
+	constexpr bool shader_data_type_is_normalized(const ShaderDataType type) {
+		switch (type) {
+		case ShaderDataType::Short2Norm:
+		case ShaderDataType::Short4Norm:
+		case ShaderDataType::UShort2Norm:
+		case ShaderDataType::UShort4Norm:
+			return true;
+		default:
+			return false;
+		}
+	}
+
 	constexpr GLenum usage_to_GLenum(const VertexBuffer::EUsage usage) {
 
 		switch (usage) {
@@ -80,14 +120,63 @@ namespace EngineCore {
 		,components_cnt(shader_data_type_to_components_count(_type))
 		,size(shader_data_type_size(_type))
 		,offset(0)
+		,normalized(shader_data_type_is_normalized(_type))
 	{}
 
-	VertexBuffer::VertexBuffer(const std::vector<Vertex>& data, BufferLayout buf_layout, const EUsage usage)
+	static int16_t to_snorm16(const float value) {
+		return static_cast<int16_t>(std::round(std::clamp(value, -1.f, 1.f) * 32767.f));
+	}
+
+	static uint16_t to_unorm16(const float value) {
+		return static_cast<uint16_t>(std::round(std::clamp(value, 0.f, 1.f) * 65535.f));
+	}
+
+	// projects the unit sphere onto an octahedron unfolded into [-1, 1]^2
+	glm::vec2 encode_octahedral(const glm::vec3& normal) {
+		const float length = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+		if (length == 0.f) {
+			return glm::vec2(0.f);
+		}
+		const glm::vec3 n = normal / length;
+		if (n.z >= 0.f) {
+			return glm::vec2(n.x, n.y);
+		}
+		return glm::vec2(
+			(1.f - std::abs(n.y)) * (n.x >= 0.f ? 1.f : -1.f),
+			(1.f - std::abs(n.x)) * (n.y >= 0.f ? 1.f : -1.f)
+		);
+	}
+
+	static_assert(sizeof(PackedVertex) == 16, "PackedVertex has to match PackedPNT_layout");
+
+	PackedVertex pack_vertex(Vertex const& vertex, const glm::vec3& bounds_min, const glm::vec3& bounds_extent) {
+		PackedVertex res;
+		for (int i = 0; i < 3; ++i) {
+			const float t = bounds_extent[i] > 0.f ? (vertex.position[i] - bounds_min[i]) / bounds_extent[i] : 0.f;
+			res.position[i] = to_unorm16(t);
+		}
+		res.position[3] = 0;
+
+		const glm::vec2 normal = encode_octahedral(vertex.normal);
+		res.normal[0] = to_snorm16(normal.x);
+		res.normal[1] = to_snorm16(normal.y);
+
+		res.texture_position[0] = glm::packHalf1x16(vertex.texture_position.x);
+		res.texture_position[1] = glm::packHalf1x16(vertex.texture_position.y);
+		return res;
+	}
+
+	VertexBuffer::VertexBuffer(std::span<const Vertex> data, BufferLayout buf_layout, const EUsage usage)
 		: m_buffer_layout(std::move(buf_layout))
+		, m_usage(usage)
 	{
-		glGenBuffers(1, &m_id);
-		glBindBuffer(GL_ARRAY_BUFFER, m_id);
-		glBufferData(GL_ARRAY_BUFFER, data.size() * sizeof(Vertex), data.data(), usage_to_GLenum(usage));
+		if (usage == EUsage::Stream) {
+			m_stream = std::make_unique<StreamBuffer>(std::max<size_t>(data.size_bytes(), sizeof(Vertex)));
+		}
+		else {
+			glCreateBuffers(1, &m_id);
+		}
+		set_data(data);
 	}
 
 	VertexBuffer::VertexBuffer():
@@ -100,17 +189,52 @@ namespace EngineCore {
 
 	VertexBuffer& VertexBuffer::operator=(VertexBuffer&& vertexBuffer) noexcept {
 		m_id = vertexBuffer.m_id;
+		m_usage = vertexBuffer.m_usage;
+		m_capacity = vertexBuffer.m_capacity;
+		m_count = vertexBuffer.m_count;
+		m_stream = std::move(vertexBuffer.m_stream);
+		m_stream_id = vertexBuffer.m_stream_id;
+		m_offset = vertexBuffer.m_offset;
 		vertexBuffer.m_id = 0;
+		vertexBuffer.m_capacity = 0;
+		vertexBuffer.m_count = 0;
 		return *this;
 	}
 
 	VertexBuffer::VertexBuffer(VertexBuffer&& vertexBuffer) noexcept {
 		m_id = vertexBuffer.m_id;
+		m_usage = vertexBuffer.m_usage;
+		m_capacity = vertexBuffer.m_capacity;
+		m_count = vertexBuffer.m_count;
+		m_stream = std::move(vertexBuffer.m_stream);
+		m_stream_id = vertexBuffer.m_stream_id;
+		m_offset = vertexBuffer.m_offset;
 		vertexBuffer.m_id = 0;
+		vertexBuffer.m_capacity = 0;
+		vertexBuffer.m_count = 0;
+	}
+
+	void VertexBuffer::set_data(std::span<const Vertex> data) {
+		m_count = data.size();
+		if (m_stream) {
+			const auto range = m_stream->write(data.data(), data.size_bytes(), sizeof(Vertex));
+			m_stream_id = range.buffer;
+			m_offset = range.offset;
+			return;
+		}
+
+		if (data.size_bytes() > m_capacity || m_capacity == 0) {
+			glNamedBufferData(m_id, data.size_bytes(), data.data(), usage_to_GLenum(m_usage));
+			m_capacity = data.size_bytes();
+		}
+		else {
+			glNamedBufferSubData(m_id, 0, data.size_bytes(), data.data());
+		}
+		Renderer_OpenGL::count_buffer_upload(data.size_bytes());
 	}
 
 	uint32_t VertexBuffer::get_handle() const {
-		return m_id;
+		return m_stream ? m_stream_id : m_id;
 	};
 
 }
\ No newline at end of file
@@ -1,6 +1,9 @@
 #pragma once
 
 #include <vector>
+#include <span>
+#include <memory>
+#include <cstdint>
 #include <glm/glm.hpp>
 
 namespace EngineCore {
@@ -15,6 +18,14 @@ namespace EngineCore {
 		Int2,
 		Int3,
 		Int4,
+		// read as float by the shader
+		Half2,
+		Half4,
+		// normalized to [-1, 1] / [0, 1] by the vertex fetch
+		Short2Norm,
+		Short4Norm,
+		UShort2Norm,
+		UShort4Norm,
 	};
 
 	struct BufElement {
@@ -23,6 +34,7 @@ namespace EngineCore {
 		size_t components_cnt;
 		size_t size;
 		size_t offset;
+		bool normalized;
 
 		BufElement(const ShaderDataType type);
 	};
@@ -33,6 +45,19 @@ namespace EngineCore {
 		glm::vec2 texture_position;
 	};
 
+	// What meshes keep on the GPU, 16 bytes instead of the 32 of Vertex: the position is quantized
+	// to 16 bits inside the mesh bounds, the normal is octahedral encoded into two snorm16 and
+	// texture coordinates are halfs. The shader gets the position back from the bounds of its draw.
+	struct PackedVertex {
+		uint16_t position[4];
+		int16_t normal[2];
+		uint16_t texture_position[2];
+	};
+
+	// 'bounds_extent' = max - min of the mesh positions, a zero component quantizes to 0
+	PackedVertex pack_vertex(Vertex const& vertex, const glm::vec3& bounds_min, const glm::vec3& bounds_extent);
+	glm::vec2 encode_octahedral(const glm::vec3& normal);
+
 
 	class BufferLayout {
 	public:
@@ -62,16 +87,25 @@ namespace EngineCore {
 		ShaderDataType::Float3,
 		ShaderDataType::Float2,
 	};
+
+	static BufferLayout PackedPNT_layout{
+		ShaderDataType::UShort4Norm,
+		ShaderDataType::Short2Norm,
+		ShaderDataType::Half2,
+	};
 	
+	class StreamBuffer;
+
 	class VertexBuffer {
 	public:
 		enum class EUsage {
 			Static,
 			Dynamic,
+			// vertices are rewritten every frame into a persistently mapped StreamBuffer ring
 			Stream,
 		};
 
-		VertexBuffer(const std::vector<Vertex>& data, BufferLayout buf_layout, const EUsage usage = VertexBuffer::EUsage::Static);
+		VertexBuffer(std::span<const Vertex> data, BufferLayout buf_layout, const EUsage usage = VertexBuffer::EUsage::Static);
 		VertexBuffer();
 		
 		~VertexBuffer();
@@ -81,7 +115,14 @@ namespace EngineCore {
 		VertexBuffer& operator=(VertexBuffer&& vertexBuffer) noexcept;
 		VertexBuffer(VertexBuffer&& vertexBuffer) noexcept;
 
+		// Stream data moves to another region every frame, vertex arrays using the buffer
+		// have to be pointed at it again with VertexArray::set_vertex_buffer
+		void set_data(std::span<const Vertex> data);
+
 		uint32_t get_handle() const;
+		// byte offset of the current data inside get_handle(), non zero only for Stream
+		size_t get_offset() const { return m_offset; }
+		size_t get_count() const { return m_count; }
 
 		const BufferLayout& get_layout() const { return m_buffer_layout; }
 
@@ -89,5 +130,13 @@ namespace EngineCore {
 	private:
 		uint32_t m_id = 0;
 		BufferLayout m_buffer_layout;
+		EUsage m_usage = EUsage::Static;
+		size_t m_capacity = 0;
+		size_t m_count = 0;
+
+		std::unique_ptr<StreamBuffer> m_stream;
+		// where the last Stream write went, the ring may have been replaced by a bigger one since
+		uint32_t m_stream_id = 0;
+		size_t m_offset = 0;
 	};
 }
\ No newline at end of file
@@ -1,6 +1,5 @@
 #version 430
-
-const uint MAX_POINT_LIGHT_ARRAY_SIZE = 32;
+#extension GL_EXT_nonuniform_qualifier : enable
 
 struct Fragment {
     vec3 position_eye;
@@ -8,12 +7,21 @@ struct Fragment {
     vec2 texture_position;
 };
 
-struct Material {
-    sampler2D diffuse0;
-    sampler2D specular0;
-    float shininess;
+// filled by MaterialTable: textures = (diffuse array, layer, specular array, layer), array -1 samples white,
+// params.x = shininess
+struct MaterialData {
+    ivec4 textures;
+    vec4 params;
 };
 
+layout(std430, binding = 5) readonly buffer Materials {
+    MaterialData materials[];
+};
+
+// MaterialTable texture arrays on units 0..15; fragments of different draws may share a wave,
+// so the index is not dynamically uniform and has to go through nonuniformEXT or a constant
+layout(binding = 0) uniform sampler2DArray material_arrays[16];
+
 struct PointLight {
     vec3 position_eye;
 
@@ -27,9 +35,30 @@ struct PointLight {
     float intensity;
 };
 
-struct PointLightArray {
-    uint size;
-    PointLight pnts[MAX_POINT_LIGHT_ARRAY_SIZE];
+// packed by Application: xyz = value, w = scalar parameter
+struct PointLightData {
+    vec4 position_intensity;
+    vec4 ambient_shininess;
+    vec4 diffuse_linear;
+    vec4 specular_quadro;
+};
+
+layout(std430, binding = 0) readonly buffer PointLightBuffer {
+    uint point_lights_count;
+    uint point_lights_pad[3];
+    PointLightData point_lights[];
+};
+
+// light clusters built by LightClusters: dims = (tiles x, tiles y, slices z, enabled),
+// params = (tile width px, tile height px, slice scale, slice bias), clusters[i] = (offset, count)
+layout(std430, binding = 1) readonly buffer LightClusterGrid {
+    uvec4 cluster_dims;
+    vec4 cluster_params;
+    uvec2 clusters[];
+};
+
+layout(std430, binding = 2) readonly buffer LightClusterIndices {
+    uint cluster_light_indices[];
 };
 
 struct texture_t {
@@ -37,28 +66,83 @@ struct texture_t {
     vec3 diffuse;
     vec3 specular;
     vec3 normal;
+    float shininess;
 };
 
 in Fragment frag;
+flat in uint material_index;
 out vec4 fragment_color;
 
-uniform Material material;
-uniform PointLightArray PLA;
+uniform mat4 view_matrix;
+
+#ifndef GL_EXT_nonuniform_qualifier
+#define SAMPLE_ARRAY(i) case i: return texture(material_arrays[i], position).rgb
+#endif
+
+vec3 sample_material(const int array, const int layer) {
+    vec3 position = vec3(frag.texture_position, float(layer));
+#ifdef GL_EXT_nonuniform_qualifier
+    if (array >= 0) {
+        return texture(material_arrays[nonuniformEXT(array)], position).rgb;
+    }
+#else
+    switch (array) {
+    SAMPLE_ARRAY(0); SAMPLE_ARRAY(1); SAMPLE_ARRAY(2); SAMPLE_ARRAY(3);
+    SAMPLE_ARRAY(4); SAMPLE_ARRAY(5); SAMPLE_ARRAY(6); SAMPLE_ARRAY(7);
+    SAMPLE_ARRAY(8); SAMPLE_ARRAY(9); SAMPLE_ARRAY(10); SAMPLE_ARRAY(11);
+    SAMPLE_ARRAY(12); SAMPLE_ARRAY(13); SAMPLE_ARRAY(14); SAMPLE_ARRAY(15);
+    }
+#endif
+    return vec3(1.0f);
+}
 
-const texture_t text = texture_t(
-    texture(material.diffuse0, frag.texture_position).rgb,
-    texture(material.diffuse0, frag.texture_position).rgb,
-    texture(material.specular0, frag.texture_position).rgb,
-    normalize(frag.normal_eye)
-);
+texture_t text;
 
 vec3 calc_light(const PointLight light);
 
+PointLight unpack_light(const uint index) {
+    PointLightData data = point_lights[index];
+    return PointLight(
+        vec3(view_matrix * vec4(data.position_intensity.xyz, 1.0f)),
+        data.ambient_shininess.xyz,
+        data.diffuse_linear.xyz,
+        data.specular_quadro.xyz,
+        data.ambient_shininess.w,
+        data.diffuse_linear.w,
+        data.specular_quadro.w,
+        data.position_intensity.w
+    );
+}
+
 void main() {
+    MaterialData material = materials[material_index];
+    vec3 diffuse = sample_material(material.textures.x, material.textures.y);
+    text = texture_t(
+        diffuse,
+        diffuse,
+        sample_material(material.textures.z, material.textures.w),
+        normalize(frag.normal_eye),
+        material.params.x
+    );
+
     vec3 res = {0.f, 0.f, 0.f};
 
-    for (uint i = 0; i < PLA.size; ++i) {
-        res += calc_light(PLA.pnts[i]);
+    if (cluster_dims.w != 0) {
+        uvec3 cluster = uvec3(
+            uint(gl_FragCoord.x / cluster_params.x),
+            uint(gl_FragCoord.y / cluster_params.y),
+            uint(max(log(-frag.position_eye.z) * cluster_params.z + cluster_params.w, 0.0f))
+        );
+        cluster = min(cluster, cluster_dims.xyz - 1u);
+        uvec2 range = clusters[cluster.x + cluster_dims.x * (cluster.y + cluster_dims.y * cluster.z)];
+
+        for (uint i = 0; i < range.y; ++i) {
+            res += calc_light(unpack_light(cluster_light_indices[range.x + i]));
+        }
+    } else {
+        for (uint i = 0; i < point_lights_count; ++i) {
+            res += calc_light(unpack_light(i));
+        }
     }
         
     fragment_color = vec4(res, 1.f);
@@ -79,7 +163,7 @@ vec3 calc_light(const PointLight light) {
     //   
     vec3 view_dir = normalize(-frag.position_eye);
     vec3 reflect_dir = reflect(-light_dir, text.normal);
-    float specular_value = pow(max(dot(view_dir, reflect_dir), 0.0f), material.shininess);
+    float specular_value = pow(max(dot(view_dir, reflect_dir), 0.0f), text.shininess);
     vec3 specular = text.specular * specular_value * light.specular;
 
     return (specular + diffuse + ambient) * attenuation;
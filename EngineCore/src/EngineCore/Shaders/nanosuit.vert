@@ -1,12 +1,26 @@
 #version 430
 
-layout(location = 0) in vec3 vertex_position;
-layout(location = 1) in vec3 normal_vec;
+// MeshPool PackedVertex: position quantized inside the mesh bounds, octahedral normal, half uv
+layout(location = 0) in vec4 vertex_position;
+layout(location = 1) in vec2 normal_octahedral;
 layout(location = 2) in vec2 texture_coord;
+// MeshPool draw id: the baseInstance of the draw, or its index inside a multi-draw
+layout(location = 3) in uint draw_id;
 
-uniform mat4 module_view_matrix;
-uniform mat4 mvp_matrix;
-uniform mat3 normal_matrix;
+// written by RenderQueue in execution order: model transform, mesh bounds and MaterialTable entry of each draw
+struct DrawEntry {
+    mat4 module;
+    vec4 position_offset;
+    vec4 position_scale;
+    uvec4 material;
+};
+
+layout(std430, binding = 4) readonly buffer DrawData {
+    DrawEntry draws[];
+};
+
+uniform mat4 view_matrix;
+uniform mat4 projection_matrix;
         
 struct Fragment {
     vec3 position_eye;
@@ -15,10 +29,27 @@ struct Fragment {
 };
 
 out Fragment frag;
+flat out uint material_index;
+
+vec3 decode_normal(vec2 e) {
+    vec3 n = vec3(e, 1.0f - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0f);
+    n.x += n.x >= 0.0f ? -t : t;
+    n.y += n.y >= 0.0f ? -t : t;
+    return normalize(n);
+}
 
 void main() {
+    uint entry = draw_id;
+    mat4 module = draws[entry].module;
+    mat3 normal_matrix = transpose(inverse(mat3(module)));
+
+    vec3 position = draws[entry].position_offset.xyz + vertex_position.xyz * draws[entry].position_scale.xyz;
+    vec4 position_eye = view_matrix * module * vec4(position, 1.0f);
+
+    material_index = draws[entry].material.x;
     frag.texture_position = texture_coord;
-    frag.normal_eye = normal_matrix * normal_vec;
-    frag.position_eye = vec3(module_view_matrix * vec4(vertex_position, 1.0f));
-    gl_Position = mvp_matrix * vec4(vertex_position, 1.0f);
+    frag.normal_eye = normal_matrix * decode_normal(normal_octahedral);
+    frag.position_eye = vec3(position_eye);
+    gl_Position = projection_matrix * position_eye;
 }
\ No newline at end of file
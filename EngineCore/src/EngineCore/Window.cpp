@@ -2,6 +2,7 @@
 
 #include "EngineCore/Window.hpp"
 #include "EngineCore/Logs.hpp"
+#include "EngineCore/Profiler.hpp"
 
 #include "Rendering/OpenGL/Renderer_OpenGL.hpp"
 
@@ -9,8 +10,9 @@
 
 namespace EngineCore {
 
-    Window::Window(std::string title, const uint32_t width, const uint32_t height)
+    Window::Window(std::string title, const uint32_t width, const uint32_t height, const bool headless)
         : m_data({ move(title), width, height })
+        , m_headless(headless)
 	{
 		int exitCode = init();
 	};
@@ -19,6 +21,19 @@ namespace EngineCore {
 		shutdown();
 	};
 
+    static GLFWwindow* create_headless_window(const uint32_t width, const uint32_t height, const char* title) {
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        // EGL goes to the GPU driver when there is one, OSMesa renders on the CPU (llvmpipe)
+        for (const int api : { GLFW_EGL_CONTEXT_API, GLFW_OSMESA_CONTEXT_API }) {
+            glfwWindowHint(GLFW_CONTEXT_CREATION_API, api);
+            if (GLFWwindow* pWindow = glfwCreateWindow(width, height, title, nullptr, nullptr)) {
+                LOG_INFO("Headless context created with {0}", api == GLFW_EGL_CONTEXT_API ? "EGL" : "OSMesa");
+                return pWindow;
+            }
+        }
+        return nullptr;
+    }
+
 	int Window::init() {
         LOG_INFO("Window created: '{0}'. size {1}x{2}", m_data.title, m_data.width, m_data.height);
 
@@ -27,6 +42,13 @@ namespace EngineCore {
             }
         );
 
+#ifdef GLFW_PLATFORM_NULL
+        // no display server on build agents, a hidden window on a real platform works too but needs one
+        if (m_headless) {
+            glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+        }
+#endif
+
         if (!glfwInit()) {
             LOG_CRITICAL("Failed to initialize GLFW!");
             return -1;
@@ -34,7 +56,9 @@ namespace EngineCore {
 
         glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GL_TRUE);
 
-        m_pWindow = glfwCreateWindow(m_data.width, m_data.height, m_data.title.c_str(), nullptr, nullptr);
+        m_pWindow = m_headless
+            ? create_headless_window(m_data.width, m_data.height, m_data.title.c_str())
+            : glfwCreateWindow(m_data.width, m_data.height, m_data.title.c_str(), nullptr, nullptr);
 
         if (!m_pWindow)
         {
@@ -142,18 +166,26 @@ namespace EngineCore {
             }
         );
 
-        UIModule::on_window_create(m_pWindow);
+        if (!m_headless) {
+            UIModule::on_window_create(m_pWindow);
+        }
         return 0;
 	}
 
 	void Window::shutdown() {
-        UIModule::on_window_close();
+        if (!m_headless) {
+            UIModule::on_window_close();
+        }
         glfwDestroyWindow(m_pWindow);
         glfwTerminate();
 	}
 
 	void Window::on_update() {
-        glfwSwapBuffers(m_pWindow);
+        PROFILE_SCOPE("Window::on_update");
+        // headless frames stay in the offscreen framebuffer, there is nothing to present
+        if (!m_headless) {
+            glfwSwapBuffers(m_pWindow);
+        }
         glfwPollEvents();
 	}
 
@@ -3,6 +3,9 @@
 #include <EngineCore/Input.hpp>
 #include <EngineCore/Camera.hpp>
 #include <EngineCore/Event.hpp>
+#include <EngineCore/CameraPath.hpp>
+#include <EngineCore/Profiler.hpp>
+#include <EngineCore/RenderStats.hpp>
 
 #include "ImGui/imgui.h"
 #include <imgui_internal.h>
@@ -11,7 +14,17 @@
 
 #include <deque>
 #include <chrono>
+#include <fstream>
 #include <ctime>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <EngineCore/Logs.hpp>
 
 const char* TITLE = "3DEngine";
@@ -37,6 +50,206 @@ class Editor : public EngineCore::Application {
     double sum = 0;
     double timed = 0;
 
+    int m_light_scene = 0;
+    int m_cube_field = 0;
+
+    // camera path for the frame benchmark, a keyframe is taken every CAMERA_PATH_STEP seconds while recording
+    static constexpr float CAMERA_PATH_STEP = 0.25f;
+    EngineCore::CameraPath m_camera_path;
+    bool m_recording_path = false;
+    std::chrono::steady_clock::time_point m_path_start;
+
+    // profiler panel: flame graph of one frame, the newest one whose GPU zones arrived unless frozen
+    bool m_profiler_frozen = false;
+    EngineCore::ProfileFrame m_profiler_frame;
+    std::vector<std::string> m_profiler_tracks;
+    std::string m_trace_status;
+
+    // render stats overlay in the top right corner, rows of the last frame go to the CSV while recording
+    bool m_show_render_stats = true;
+    std::ofstream m_stats_csv;
+
+    static ImU32 get_zone_color(std::string_view name) {
+        const size_t hash = std::hash<std::string_view>{}(name);
+        return IM_COL32(90 + hash % 120, 90 + (hash >> 8) % 120, 90 + (hash >> 16) % 120, 255);
+    }
+
+    void draw_profiler() {
+        ImGui::Begin("Profiler");
+
+        bool enabled = EngineCore::Profiler::is_enabled();
+        if (ImGui::Checkbox("Enabled", &enabled)) {
+            EngineCore::Profiler::set_enabled(enabled);
+        }
+        ImGui::SameLine();
+        ImGui::Checkbox("Freeze", &m_profiler_frozen);
+        ImGui::SameLine();
+        if (ImGui::Button("Export trace")) {
+            static constexpr const char* TRACE_PATH = "trace.json";
+            m_trace_status = EngineCore::Profiler::write_chrome_trace(TRACE_PATH) ? std::format("written to {}", TRACE_PATH) : "export failed";
+        }
+        if (!m_trace_status.empty()) {
+            ImGui::SameLine();
+            ImGui::TextUnformatted(m_trace_status.c_str());
+        }
+
+        auto const& frames = EngineCore::Profiler::get_frames();
+        if (!m_profiler_frozen && frames.size() > EngineCore::Profiler::GPU_FRAMES_IN_FLIGHT) {
+            m_profiler_frame = frames[frames.size() - 1 - EngineCore::Profiler::GPU_FRAMES_IN_FLIGHT];
+            m_profiler_tracks = EngineCore::Profiler::get_track_names();
+        }
+        auto const& frame = m_profiler_frame;
+        const int64_t frame_ns = std::max<int64_t>(frame.end_ns - frame.start_ns, 1);
+        ImGui::Text("Frame %llu: %.3f ms, %zu zones, %zu dropped", static_cast<unsigned long long>(frame.number),
+            frame_ns / 1e6, frame.zones.size(), EngineCore::Profiler::get_dropped_zone_count());
+
+        // one band per track, a row per depth; GPU zones run after their commands were sent and may spill past the frame
+        std::vector<int> track_rows(m_profiler_tracks.size(), 0);
+        for (auto const& zone : frame.zones) {
+            if (zone.track < track_rows.size()) {
+                track_rows[zone.track] = std::max<int>(track_rows[zone.track], zone.depth + 1);
+            }
+        }
+
+        static constexpr float LABEL_WIDTH = 110.f;
+        const float row_height = ImGui::GetTextLineHeightWithSpacing();
+        const ImVec2 origin = ImGui::GetCursorScreenPos();
+        const float width = std::max(ImGui::GetContentRegionAvail().x - LABEL_WIDTH, 50.f);
+        ImDrawList* draw_list = ImGui::GetWindowDrawList();
+
+        float y = origin.y;
+        for (size_t track = 0; track < m_profiler_tracks.size(); ++track) {
+            if (track_rows[track] == 0) {
+                continue;
+            }
+            draw_list->AddText(ImVec2(origin.x, y), IM_COL32(220, 220, 220, 255), m_profiler_tracks[track].c_str());
+
+            for (auto const& zone : frame.zones) {
+                if (zone.track != track) {
+                    continue;
+                }
+                auto to_x = [&](const int64_t ns) {
+                    const double t = std::clamp(static_cast<double>(ns - frame.start_ns) / frame_ns, 0.0, 1.0);
+                    return origin.x + LABEL_WIDTH + static_cast<float>(t) * width;
+                };
+                const ImVec2 min(to_x(zone.start_ns), y + zone.depth * row_height);
+                const ImVec2 max(std::max(to_x(zone.end_ns), min.x + 1.f), min.y + row_height - 1.f);
+
+                draw_list->AddRectFilled(min, max, get_zone_color(zone.name));
+                draw_list->PushClipRect(min, max, true);
+                draw_list->AddText(ImVec2(min.x + 2.f, min.y), IM_COL32(0, 0, 0, 255), zone.name);
+                draw_list->PopClipRect();
+                if (ImGui::IsMouseHoveringRect(min, max)) {
+                    ImGui::SetTooltip("%s\n%.3f ms", zone.name, (zone.end_ns - zone.start_ns) / 1e6);
+                }
+            }
+            y += track_rows[track] * row_height + 4.f;
+        }
+        ImGui::Dummy(ImVec2(LABEL_WIDTH + width, y - origin.y));
+
+        // total time per zone name, nested zones count in their parents too
+        struct ZoneTotal {
+            std::string_view name;
+            double ms = 0.0;
+            size_t count = 0;
+        };
+        std::unordered_map<std::string_view, ZoneTotal> totals;
+        for (auto const& zone : frame.zones) {
+            auto& total = totals[zone.name];
+            total.name = zone.name;
+            total.ms += (zone.end_ns - zone.start_ns) / 1e6;
+            ++total.count;
+        }
+        std::vector<ZoneTotal> sorted;
+        for (auto const& [name, total] : totals) {
+            sorted.push_back(total);
+        }
+        std::sort(sorted.begin(), sorted.end(), [](ZoneTotal const& a, ZoneTotal const& b) { return a.ms > b.ms; });
+
+        ImGui::Separator();
+        for (size_t i = 0; i < std::min<size_t>(sorted.size(), 12); ++i) {
+            ImGui::Text("%8.3f ms %5zux  %.*s", sorted[i].ms, sorted[i].count, static_cast<int>(sorted[i].name.size()), sorted[i].name.data());
+        }
+
+        ImGui::End();
+    }
+
+    void draw_render_stats() {
+        auto const& stats = get_render_frame_stats();
+        if (m_stats_csv.is_open() && stats.frame != 0) {
+            EngineCore::write_csv_row(m_stats_csv, stats, get_cpu_frame_ms(), get_gpu_frame_ms());
+        }
+        if (!m_show_render_stats) {
+            return;
+        }
+
+        const ImGuiViewport* viewport = ImGui::GetMainViewport();
+        ImGui::SetNextWindowPos(ImVec2(viewport->WorkPos.x + viewport->WorkSize.x - 10.f, viewport->WorkPos.y + 10.f), ImGuiCond_Always, ImVec2(1.f, 0.f));
+        ImGui::SetNextWindowViewport(viewport->ID);
+        ImGui::SetNextWindowBgAlpha(0.6f);
+        const ImGuiWindowFlags flags = ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoDocking | ImGuiWindowFlags_AlwaysAutoResize
+            | ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_NoFocusOnAppearing | ImGuiWindowFlags_NoNav | ImGuiWindowFlags_NoMove;
+        if (ImGui::Begin("Render stats", nullptr, flags)) {
+            ImGui::Text("Frame %llu", static_cast<unsigned long long>(stats.frame));
+            ImGui::Text("Draw calls: %zu (%zu draws)", stats.draw_calls, stats.draws);
+            ImGui::Text("Triangles: %zu in %zu instances", stats.get_triangles(), stats.instances);
+            ImGui::Text("Binds: %zu programs, %zu VAOs, %zu textures", stats.program_binds, stats.vertex_array_binds, stats.texture_binds);
+            ImGui::Text("Uniforms: %zu", stats.uniform_uploads);
+            ImGui::Text("Buffers: %zu uploads, %.1f KB", stats.buffer_uploads, stats.buffer_bytes / 1024.0);
+            ImGui::Text("Textures: %.1f KB", stats.texture_bytes / 1024.0);
+            if (m_stats_csv.is_open()) {
+                ImGui::TextUnformatted("Recording render_stats.csv");
+            }
+        }
+        ImGui::End();
+    }
+
+    void set_stats_recording(const bool recording) {
+        if (!recording) {
+            m_stats_csv.close();
+            return;
+        }
+        m_stats_csv.open("render_stats.csv", std::ios::trunc);
+        if (m_stats_csv.is_open()) {
+            EngineCore::write_csv_header(m_stats_csv);
+        }
+    }
+
+    void record_camera_path() {
+        const float time = std::chrono::duration<float>(std::chrono::steady_clock::now() - m_path_start).count();
+        auto const& keyframes = m_camera_path.get_keyframes();
+        if (keyframes.empty() || time - keyframes.back().time >= CAMERA_PATH_STEP) {
+            m_camera_path.add_keyframe(time, camera);
+        }
+    }
+
+    // light benchmark scene: N small lights scattered around the model
+    void set_light_scene(const size_t count) {
+        point_lights.clear();
+        if (count <= 1) {
+            point_lights.push_back({});
+            return;
+        }
+
+        std::mt19937 rng(1337);
+        std::uniform_real_distribution<float> pos_xy(-30.f, 30.f);
+        std::uniform_real_distribution<float> pos_z(-2.f, 18.f);
+        std::uniform_real_distribution<float> color(0.2f, 1.f);
+
+        point_lights.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            EngineCore::Application::PointLight light;
+            light.position = { pos_xy(rng), pos_xy(rng), pos_z(rng) };
+            light.ambient = glm::vec3(0.f);
+            light.diffuse = { color(rng), color(rng), color(rng) };
+            light.specular = light.diffuse;
+            light.intensity = 1.f;
+            light.linear = 0.7f;
+            light.quadro = 1.8f;
+            point_lights.push_back(light);
+        }
+    }
+
     void FPS_calc(void) {
         elapsed_seconds = start_timepoint - last_timepoint;
         last_timepoint = start_timepoint;
@@ -59,6 +272,7 @@ class Editor : public EngineCore::Application {
         m_background_color[1] = 0.510f;
         m_background_color[2] = 0.510f;
         m_background_color[3] = 0.f;
+        set_light_scene(1);
     }
 
     void camera_pos_update() {
@@ -132,6 +346,9 @@ class Editor : public EngineCore::Application {
     void on_update() override {
         FPS_calc();
         camera_pos_update();
+        if (m_recording_path) {
+            record_camera_path();
+        }
         if (EngineCore::Input::is_key_pressed(EngineCore::KeyCode::KEY_ESCAPE)) {
             close();
         }
@@ -165,7 +382,81 @@ class Editor : public EngineCore::Application {
 
         ImGui::ColorEdit3("Background", m_background_color);
 
+        ImGui::Separator();
+        ImGui::Text("Meshes drawn: %zu | culled: %zu", get_culling_stats().drawn, get_culling_stats().culled);
+
+        ImGui::Separator();
+        if (ImGui::Checkbox("Record camera path", &m_recording_path) && m_recording_path) {
+            m_camera_path.clear();
+            m_path_start = std::chrono::steady_clock::now();
+        }
+        ImGui::Text("Keyframes: %zu (%.1f s)", m_camera_path.get_keyframes().size(), m_camera_path.get_duration());
+        if (ImGui::Button("Save path") && !m_camera_path.empty()) {
+            m_camera_path.save(PROJECT_SOURCE_DIR "resources/bench/recorded.campath");
+        }
+
         ImGui::End();
+
+        ImGui::Begin("Lighting");
+
+        static const char* light_scenes[] = { "1 light", "1k lights", "4k lights", "16k lights" };
+        static const size_t light_counts[] = { 1, 1024, 4096, 16384 };
+        if (ImGui::Combo("Scene", &m_light_scene, light_scenes, IM_ARRAYSIZE(light_scenes))) {
+            set_light_scene(light_counts[m_light_scene]);
+        }
+        ImGui::Checkbox("Clustered", &clustered_lighting);
+        ImGui::Text("Lights: %zu", point_lights.size());
+        ImGui::Text("CPU binning: %.3f ms", get_light_binning_ms());
+        ImGui::Text("Frame: %.3f ms", 1000.0 * sum / fps_over.size());
+
+        ImGui::End();
+
+        ImGui::Begin("Instancing");
+
+        static const char* cube_fields[] = { "Off", "2 cubes", "1k cubes", "10k cubes", "100k cubes" };
+        static const size_t cube_counts[] = { 0, 2, 1000, 10000, 100000 };
+        if (ImGui::Combo("Cube field", &m_cube_field, cube_fields, IM_ARRAYSIZE(cube_fields))) {
+            cube_field_count = cube_counts[m_cube_field];
+        }
+        ImGui::Checkbox("Instanced", &instanced_drawing);
+        ImGui::Checkbox("Mixed with soldiers", &mixed_cube_field);
+        ImGui::Text("Visible cubes: %zu / %zu", get_visible_cube_count(), cube_field_count);
+        ImGui::Text("Draw calls: %zu", get_draw_call_count());
+        ImGui::Checkbox("Render stats overlay", &m_show_render_stats);
+        bool recording_stats = m_stats_csv.is_open();
+        if (ImGui::Checkbox("Record render stats CSV", &recording_stats)) {
+            set_stats_recording(recording_stats);
+        }
+        ImGui::Text("CPU frame: %.3f ms", get_cpu_frame_ms());
+        if (has_gpu_timer()) {
+            ImGui::Text("GPU frame: %.3f ms", get_gpu_frame_ms());
+        }
+
+        ImGui::Separator();
+        auto const& queue_stats = get_render_queue_stats();
+        ImGui::Checkbox("Sorted submission", &sorted_submission);
+        ImGui::Checkbox("Multi-draw indirect", &multi_draw_indirect);
+        ImGui::Text("Queued commands: %zu", queue_stats.commands);
+        ImGui::Text("Program binds: %zu (saved %zu)", queue_stats.program_binds, queue_stats.program_binds_saved);
+        ImGui::Text("Material binds: %zu (saved %zu)", queue_stats.material_binds, queue_stats.material_binds_saved);
+        ImGui::Text("VAO binds: %zu (saved %zu)", queue_stats.vertex_array_binds, queue_stats.vertex_array_binds_saved);
+        ImGui::Text("Multi-draws: %zu covering %zu commands", queue_stats.multi_draw_batches, queue_stats.multi_draw_commands);
+        ImGui::Text("GL state calls: %zu issued, %zu skipped", get_gl_state_stats().issued, get_gl_state_stats().skipped);
+        auto const& material_stats = get_material_stats();
+        ImGui::Text("Materials: %zu in %zu texture arrays", material_stats.materials, material_stats.texture_arrays);
+        ImGui::Text("Layers: %zu / %zu (%.1f MB)", material_stats.layers_used, material_stats.layers_allocated, material_stats.gpu_bytes / (1024.0 * 1024.0));
+
+        ImGui::Separator();
+        ImGui::Checkbox("Levels of detail", &lod_enabled);
+        ImGui::SliderFloat("LOD error (px)", &lod_error_pixels, 0.25f, 8.f);
+        ImGui::Text("Triangles: %zu (full detail %zu)", queue_stats.triangles, queue_stats.full_detail_triangles);
+        ImGui::Text("Instances per LOD: %zu / %zu / %zu / %zu",
+            queue_stats.lod_instances[0], queue_stats.lod_instances[1], queue_stats.lod_instances[2], queue_stats.lod_instances[3]);
+
+        ImGui::End();
+
+        draw_profiler();
+        draw_render_stats();
     };
 
     void setup_dockspace_menu() {
@@ -220,7 +511,33 @@ class Editor : public EngineCore::Application {
 
 
 
-int main() {
+// --headless <frames> renders offscreen without a window, for CI;
+// --dump <directory> and --dump-every <n> write every n-th frame (1 when only --dump is given)
+int main(int argc, char** argv) {
+    bool headless = false;
+    EngineCore::Application::HeadlessOptions options;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--headless") == 0 && i + 1 < argc) {
+            headless = true;
+            options.frame_count = static_cast<uint32_t>(std::max(std::atoi(argv[++i]), 1));
+        }
+        else if (std::strcmp(argv[i], "--dump") == 0 && i + 1 < argc) {
+            options.dump_directory = argv[++i];
+            options.dump_interval = std::max(options.dump_interval, 1u);
+        }
+        else if (std::strcmp(argv[i], "--dump-every") == 0 && i + 1 < argc) {
+            options.dump_interval = static_cast<uint32_t>(std::max(std::atoi(argv[++i]), 0));
+        }
+        else {
+            std::fprintf(stderr, "usage: %s [--headless <frames> [--dump <directory>] [--dump-every <n>]]\n", argv[0]);
+            return 2;
+        }
+    }
+
     Editor App;
+    if (headless) {
+        return App.start_headless(1024, 768, options);
+    }
     return App.start(1024, 768, "3DEngine");
 }
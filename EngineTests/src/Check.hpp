@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cmath>
+#include <cstdio>
+#include <format>
+
+// CHECK prints every failed condition with its location and carries on, main() returns
+// the failure count through get_failures() so ctest sees a non zero exit code
+
+namespace EngineTests {
+
+    inline int& get_failures() {
+        static int failures = 0;
+        return failures;
+    }
+
+    inline void report_failure(const char* file, const int line, const char* expression) {
+        ++get_failures();
+        std::fputs(std::format("{}:{}: CHECK({}) failed\n", file, line, expression).c_str(), stderr);
+    }
+
+    inline bool is_near(const float a, const float b, const float epsilon = 1e-4f) {
+        return std::fabs(a - b) <= epsilon;
+    }
+
+}
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            ::EngineTests::report_failure(__FILE__, __LINE__, #condition); \
+        } \
+    } while (false)
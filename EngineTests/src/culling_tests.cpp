@@ -0,0 +1,190 @@
+#include "Check.hpp"
+
+#include "EngineCore/Modules/CullingBatch.hpp"
+#include "EngineCore/Bounds.hpp"
+
+#include <glm/ext/matrix_clip_space.hpp>
+#include <glm/ext/matrix_transform.hpp>
+#include <glm/trigonometric.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+// Frustum plane extraction, sphere and box tests against it, and the CullingBatch kernels
+// against a per-object Frustum::intersects loop.
+
+using EngineCore::AABB;
+using EngineCore::BoundingSphere;
+using EngineCore::CullingBatch;
+using EngineCore::Frustum;
+using EngineTests::is_near;
+
+// the distance is compared relative to its size, the far plane loses precision with the far / near ratio
+static bool is_plane(const Frustum& frustum, const Frustum::Plane plane, const glm::vec4& expected) {
+    auto const& res = frustum.get_plane(plane);
+    return is_near(res.x, expected.x) && is_near(res.y, expected.y) && is_near(res.z, expected.z)
+        && is_near(res.w, expected.w, 1e-4f * std::max(1.f, std::fabs(expected.w)));
+}
+
+// 90 degrees, square, 1 to 100, camera at the origin looking down -z
+static Frustum make_perspective_frustum() {
+    const glm::mat4 projection = glm::perspective(glm::radians(90.f), 1.f, 1.f, 100.f);
+    const glm::mat4 view = glm::lookAt(glm::vec3(0.f), glm::vec3(0.f, 0.f, -1.f), glm::vec3(0.f, 1.f, 0.f));
+    return Frustum::from_matrix(projection * view);
+}
+
+static void test_planes_from_identity() {
+    // the clip cube itself, every plane is one unit from the origin
+    const Frustum frustum = Frustum::from_matrix(glm::mat4(1.f));
+    CHECK(is_plane(frustum, Frustum::Left, { 1.f, 0.f, 0.f, 1.f }));
+    CHECK(is_plane(frustum, Frustum::Right, { -1.f, 0.f, 0.f, 1.f }));
+    CHECK(is_plane(frustum, Frustum::Bottom, { 0.f, 1.f, 0.f, 1.f }));
+    CHECK(is_plane(frustum, Frustum::Top, { 0.f, -1.f, 0.f, 1.f }));
+    CHECK(is_plane(frustum, Frustum::Near, { 0.f, 0.f, 1.f, 1.f }));
+    CHECK(is_plane(frustum, Frustum::Far, { 0.f, 0.f, -1.f, 1.f }));
+}
+
+static void test_planes_from_ortho() {
+    const Frustum frustum = Frustum::from_matrix(glm::ortho(-2.f, 2.f, -1.f, 3.f, 0.5f, 10.f));
+    CHECK(is_plane(frustum, Frustum::Left, { 1.f, 0.f, 0.f, 2.f }));
+    CHECK(is_plane(frustum, Frustum::Right, { -1.f, 0.f, 0.f, 2.f }));
+    CHECK(is_plane(frustum, Frustum::Bottom, { 0.f, 1.f, 0.f, 1.f }));
+    CHECK(is_plane(frustum, Frustum::Top, { 0.f, -1.f, 0.f, 3.f }));
+    // the camera looks down -z, near and far are distances along it
+    CHECK(is_plane(frustum, Frustum::Near, { 0.f, 0.f, -1.f, -0.5f }));
+    CHECK(is_plane(frustum, Frustum::Far, { 0.f, 0.f, 1.f, 10.f }));
+}
+
+static void test_planes_from_perspective() {
+    const Frustum frustum = make_perspective_frustum();
+    const float diagonal = std::sqrt(0.5f);
+    CHECK(is_plane(frustum, Frustum::Left, { diagonal, 0.f, -diagonal, 0.f }));
+    CHECK(is_plane(frustum, Frustum::Right, { -diagonal, 0.f, -diagonal, 0.f }));
+    CHECK(is_plane(frustum, Frustum::Bottom, { 0.f, diagonal, -diagonal, 0.f }));
+    CHECK(is_plane(frustum, Frustum::Top, { 0.f, -diagonal, -diagonal, 0.f }));
+    CHECK(is_plane(frustum, Frustum::Near, { 0.f, 0.f, -1.f, -1.f }));
+    CHECK(is_plane(frustum, Frustum::Far, { 0.f, 0.f, 1.f, 100.f }));
+
+    // planes are in the space the matrix maps from: moving the camera moves them
+    const glm::mat4 projection = glm::perspective(glm::radians(90.f), 1.f, 1.f, 100.f);
+    const glm::mat4 view = glm::lookAt(glm::vec3(0.f, 0.f, 10.f), glm::vec3(0.f), glm::vec3(0.f, 1.f, 0.f));
+    const Frustum moved = Frustum::from_matrix(projection * view);
+    CHECK(is_plane(moved, Frustum::Near, { 0.f, 0.f, -1.f, 9.f }));
+    CHECK(is_plane(moved, Frustum::Far, { 0.f, 0.f, 1.f, 90.f }));
+}
+
+static void test_sphere_intersection() {
+    const Frustum frustum = make_perspective_frustum();
+    CHECK(frustum.intersects(BoundingSphere{ { 0.f, 0.f, -10.f }, 1.f }));
+    CHECK(!frustum.intersects(BoundingSphere{ { 0.f, 0.f, 10.f }, 1.f }));
+    CHECK(!frustum.intersects(BoundingSphere{ { 0.f, 0.f, -150.f }, 1.f }));
+    CHECK(!frustum.intersects(BoundingSphere{ { 50.f, 0.f, -10.f }, 1.f }));
+    CHECK(!frustum.intersects(BoundingSphere{ { 0.f, -50.f, -10.f }, 1.f }));
+
+    // straddling a plane counts as visible
+    CHECK(frustum.intersects(BoundingSphere{ { 0.f, 0.f, -100.5f }, 1.f }));
+    CHECK(frustum.intersects(BoundingSphere{ { 0.f, 0.f, -0.5f }, 1.f }));
+    // left plane: x = z at z = -10, the center is 0.35 outside
+    CHECK(frustum.intersects(BoundingSphere{ { -10.5f, 0.f, -10.f }, 1.f }));
+    // 1.41 outside, more than the radius
+    CHECK(!frustum.intersects(BoundingSphere{ { -12.f, 0.f, -10.f }, 1.f }));
+    // a sphere around the whole frustum
+    CHECK(frustum.intersects(BoundingSphere{ { 0.f, 0.f, -50.f }, 500.f }));
+}
+
+static void test_box_intersection() {
+    const Frustum frustum = make_perspective_frustum();
+    CHECK(frustum.intersects(AABB{ { -1.f, -1.f, -11.f }, { 1.f, 1.f, -9.f } }));
+    CHECK(!frustum.intersects(AABB{ { -1.f, -1.f, 9.f }, { 1.f, 1.f, 11.f } }));
+    CHECK(!frustum.intersects(AABB{ { -1.f, -1.f, -160.f }, { 1.f, 1.f, -140.f } }));
+    CHECK(!frustum.intersects(AABB{ { 40.f, -1.f, -11.f }, { 60.f, 1.f, -9.f } }));
+
+    // one corner inside the left plane is enough
+    CHECK(frustum.intersects(AABB{ { -12.f, -1.f, -11.f }, { -10.5f, 1.f, -9.f } }));
+    CHECK(!frustum.intersects(AABB{ { -14.f, -1.f, -11.f }, { -12.f, 1.f, -9.f } }));
+    // bigger than the frustum, no corner inside but never outside a single plane
+    CHECK(frustum.intersects(AABB{ glm::vec3(-500.f), glm::vec3(500.f) }));
+
+    // the sphere of a box is conservative: the box is culled, its sphere is not
+    const AABB tall{ { -11.6f, -4.f, -10.5f }, { -11.1f, 4.f, -10.f } };
+    CHECK(!frustum.intersects(tall));
+    CHECK(frustum.intersects(BoundingSphere::from_aabb(tall)));
+}
+
+static std::vector<uint32_t> cull_each(const Frustum& frustum, std::vector<BoundingSphere> const& spheres) {
+    std::vector<uint32_t> res;
+    for (size_t i = 0; i < spheres.size(); ++i) {
+        if (frustum.intersects(spheres[i])) {
+            res.push_back(static_cast<uint32_t>(i));
+        }
+    }
+    return res;
+}
+
+static void check_kernels(const Frustum& frustum, std::vector<BoundingSphere> const& spheres) {
+    CullingBatch batch;
+    for (auto const& sphere : spheres) {
+        batch.push_back(sphere);
+    }
+    CHECK(batch.size() == spheres.size());
+
+    const auto expected = cull_each(frustum, spheres);
+    std::vector<uint32_t> visible;
+    for (const auto path : { CullingBatch::Path::Scalar, CullingBatch::Path::SSE, CullingBatch::Path::AVX2 }) {
+        // paths the CPU lacks fall back to the best one, the result has to be the same either way
+        const size_t count = batch.cull(frustum, visible, path);
+        CHECK(count == visible.size());
+        CHECK(visible == expected);
+        if (visible != expected) {
+            std::fputs(std::format("  {} path: {} visible, expected {}\n", CullingBatch::get_path_name(path), visible.size(), expected.size()).c_str(), stderr);
+        }
+    }
+    batch.cull(frustum, visible);
+    CHECK(visible == expected);
+}
+
+static void test_kernels_match() {
+    std::mt19937 rng(1337);
+    std::uniform_real_distribution<float> position(-120.f, 120.f);
+    std::uniform_real_distribution<float> radius(0.f, 4.f);
+
+    // not a multiple of 8, the padding must never show up in the result
+    std::vector<BoundingSphere> spheres(10007);
+    for (auto& sphere : spheres) {
+        sphere.center = { position(rng), position(rng), position(rng) };
+        sphere.radius = radius(rng);
+    }
+
+    const Frustum frustum = make_perspective_frustum();
+    CHECK(!cull_each(frustum, spheres).empty());
+    check_kernels(frustum, spheres);
+
+    const glm::mat4 projection = glm::perspective(glm::radians(60.f), 16.f / 9.f, 0.1f, 80.f);
+    const glm::mat4 view = glm::lookAt(glm::vec3(20.f, 5.f, -3.f), glm::vec3(-4.f, 2.f, 30.f), glm::vec3(0.f, 1.f, 0.f));
+    check_kernels(Frustum::from_matrix(projection * view), spheres);
+
+    // spheres behind the camera exactly touching the near plane are kept by every path
+    std::vector<BoundingSphere> touching;
+    for (int i = 0; i < 13; ++i) {
+        touching.push_back({ { 0.f, 0.f, 1.f + static_cast<float>(i) }, 2.f + static_cast<float>(i) });
+    }
+    check_kernels(frustum, touching);
+
+    check_kernels(frustum, {});
+}
+
+int main() {
+    test_planes_from_identity();
+    test_planes_from_ortho();
+    test_planes_from_perspective();
+    test_sphere_intersection();
+    test_box_intersection();
+    test_kernels_match();
+
+    std::puts(std::format("culling: {} failures, best path {}", EngineTests::get_failures(),
+        CullingBatch::get_path_name(CullingBatch::get_best_path())).c_str());
+    return EngineTests::get_failures() == 0 ? 0 : 1;
+}
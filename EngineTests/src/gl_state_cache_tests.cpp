@@ -0,0 +1,181 @@
+#include "Check.hpp"
+
+#include "EngineCore/Rendering/OpenGL/GLStateCache.hpp"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// GLStateCache driven through GLFunctions that record what reaches the "driver" instead of calling GL.
+
+using EngineCore::GLFunctions;
+using EngineCore::GLStateCache;
+
+// GLFunctions holds plain function pointers, the recording functions write here
+static std::vector<std::string> g_calls;
+
+static GLFunctions get_recording_functions() {
+    GLFunctions res;
+    res.use_program = [](uint32_t program) {
+        g_calls.push_back(std::format("use_program {}", program));
+    };
+    res.bind_vertex_array = [](uint32_t vertex_array) {
+        g_calls.push_back(std::format("bind_vertex_array {}", vertex_array));
+    };
+    res.bind_texture_unit = [](uint32_t unit, uint32_t texture) {
+        g_calls.push_back(std::format("bind_texture_unit {} {}", unit, texture));
+    };
+    res.set_depth_test = [](bool enabled) {
+        g_calls.push_back(std::format("set_depth_test {}", enabled));
+    };
+    res.set_clear_color = [](float r, float g, float b, float a) {
+        g_calls.push_back(std::format("set_clear_color {} {} {} {}", r, g, b, a));
+    };
+    return res;
+}
+
+// the recorded calls since the last take_calls()
+static std::vector<std::string> take_calls() {
+    auto res = std::move(g_calls);
+    g_calls.clear();
+    return res;
+}
+
+static bool has_stats(GLStateCache const& cache, const size_t issued, const size_t skipped) {
+    return cache.get_stats().issued == issued && cache.get_stats().skipped == skipped;
+}
+
+static void test_redundant_calls_are_skipped() {
+    GLStateCache cache(get_recording_functions());
+    take_calls();
+
+    // unknown state is always forwarded, repeats are dropped
+    cache.use_program(3);
+    cache.use_program(3);
+    cache.bind_vertex_array(7);
+    cache.bind_vertex_array(7);
+    cache.bind_vertex_array(8);
+    cache.set_depth_test(true);
+    cache.set_depth_test(true);
+    cache.set_depth_test(false);
+    CHECK((take_calls() == std::vector<std::string>{ "use_program 3", "bind_vertex_array 7", "bind_vertex_array 8", "set_depth_test true", "set_depth_test false" }));
+    CHECK(has_stats(cache, 5, 3));
+
+    const float grey[4] = { 0.5f, 0.5f, 0.5f, 1.f };
+    const float red[4] = { 1.f, 0.f, 0.f, 1.f };
+    cache.set_clear_color(grey);
+    cache.set_clear_color(grey);
+    cache.set_clear_color(red);
+    CHECK(take_calls().size() == 2);
+    CHECK(has_stats(cache, 7, 4));
+
+    // binding 0 is a value like any other
+    cache.use_program(0);
+    cache.use_program(0);
+    CHECK((take_calls() == std::vector<std::string>{ "use_program 0" }));
+
+    cache.reset_stats();
+    CHECK(has_stats(cache, 0, 0));
+    cache.use_program(0);
+    CHECK(has_stats(cache, 0, 1));
+    CHECK(take_calls().empty());
+}
+
+static void test_texture_units_are_separate() {
+    GLStateCache cache(get_recording_functions());
+    take_calls();
+
+    cache.bind_texture(0, 10);
+    cache.bind_texture(1, 10);
+    cache.bind_texture(0, 10);
+    cache.bind_texture(1, 11);
+    CHECK((take_calls() == std::vector<std::string>{ "bind_texture_unit 0 10", "bind_texture_unit 1 10", "bind_texture_unit 1 11" }));
+    CHECK(has_stats(cache, 3, 1));
+
+    // units past the cached range are forwarded every time
+    const uint32_t unit = GLStateCache::MAX_TEXTURE_UNITS;
+    cache.bind_texture(unit, 12);
+    cache.bind_texture(unit, 12);
+    CHECK(take_calls().size() == 2);
+    CHECK(has_stats(cache, 5, 1));
+}
+
+static void test_invalidate() {
+    GLStateCache cache(get_recording_functions());
+    const float grey[4] = { 0.5f, 0.5f, 0.5f, 1.f };
+    cache.use_program(3);
+    cache.bind_vertex_array(7);
+    cache.bind_texture(2, 10);
+    cache.set_depth_test(true);
+    cache.set_clear_color(grey);
+    take_calls();
+    cache.reset_stats();
+
+    // something else changed the context, the same values have to be set again
+    cache.invalidate();
+    cache.use_program(3);
+    cache.bind_vertex_array(7);
+    cache.bind_texture(2, 10);
+    cache.set_depth_test(true);
+    cache.set_clear_color(grey);
+    CHECK(take_calls().size() == 5);
+    CHECK(has_stats(cache, 5, 0));
+
+    cache.use_program(3);
+    cache.bind_texture(2, 10);
+    CHECK(take_calls().empty());
+    CHECK(has_stats(cache, 5, 2));
+}
+
+static void test_deleted_objects() {
+    GLStateCache cache(get_recording_functions());
+    cache.use_program(3);
+    cache.bind_vertex_array(7);
+    cache.bind_texture(0, 10);
+    cache.bind_texture(5, 10);
+    cache.bind_texture(6, 11);
+    take_calls();
+    cache.reset_stats();
+
+    // objects that are not bound change nothing
+    cache.on_program_deleted(4);
+    cache.on_vertex_array_deleted(8);
+    cache.on_texture_deleted(12);
+    cache.on_texture_deleted(0);
+    cache.use_program(3);
+    cache.bind_vertex_array(7);
+    cache.bind_texture(0, 10);
+    CHECK(take_calls().empty());
+    CHECK(has_stats(cache, 0, 3));
+
+    // the name of a deleted program may be reused, the next use is forwarded whatever it is
+    cache.on_program_deleted(3);
+    cache.use_program(3);
+    CHECK((take_calls() == std::vector<std::string>{ "use_program 3" }));
+
+    // a deleted vertex array or texture falls back to 0 wherever it was bound
+    cache.on_vertex_array_deleted(7);
+    cache.bind_vertex_array(0);
+    CHECK(take_calls().empty());
+    cache.bind_vertex_array(7);
+    CHECK((take_calls() == std::vector<std::string>{ "bind_vertex_array 7" }));
+
+    cache.on_texture_deleted(10);
+    cache.bind_texture(0, 0);
+    cache.bind_texture(5, 0);
+    cache.bind_texture(6, 11);
+    CHECK(take_calls().empty());
+    cache.bind_texture(5, 10);
+    CHECK((take_calls() == std::vector<std::string>{ "bind_texture_unit 5 10" }));
+    CHECK(has_stats(cache, 3, 7));
+}
+
+int main() {
+    test_redundant_calls_are_skipped();
+    test_texture_units_are_separate();
+    test_invalidate();
+    test_deleted_objects();
+
+    std::puts(std::format("gl state cache: {} failures", EngineTests::get_failures()).c_str());
+    return EngineTests::get_failures() == 0 ? 0 : 1;
+}
@@ -0,0 +1,582 @@
+#include "BlockEncoder.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <utility>
+#include <algorithm>
+
+#if defined(_M_X64) || defined(__SSE2__)
+	#define COOKER_SSE2
+	#include <emmintrin.h>
+#endif
+
+namespace TextureCooker {
+
+	// one array per channel, so four pixels go through SSE at once
+	struct BlockSoA {
+		alignas(16) float channel[4][16];
+	};
+
+	// the channels a fit works on: [first, first + count)
+	struct Channels {
+		int first;
+		int count;
+	};
+
+	static constexpr Channels RGB{ 0, 3 };
+	static constexpr Channels RGBA{ 0, 4 };
+
+	static BlockSoA to_soa(PixelBlock const& block) {
+		BlockSoA res;
+		for (int i = 0; i < 16; ++i) {
+			for (int c = 0; c < 4; ++c) {
+				res.channel[c][i] = block.rgba[i][c];
+			}
+		}
+		return res;
+	}
+
+	// t[i] = dot(pixel[i] - origin, direction)
+	static void project_block(BlockSoA const& block, const Channels channels, const float origin[4], const float direction[4], float t[16]) {
+#ifdef COOKER_SSE2
+		for (int i = 0; i < 16; i += 4) {
+			__m128 sum = _mm_setzero_ps();
+			for (int c = channels.first; c < channels.first + channels.count; ++c) {
+				const __m128 d = _mm_sub_ps(_mm_load_ps(block.channel[c] + i), _mm_set1_ps(origin[c]));
+				sum = _mm_add_ps(sum, _mm_mul_ps(d, _mm_set1_ps(direction[c])));
+			}
+			_mm_storeu_ps(t + i, sum);
+		}
+#else
+		for (int i = 0; i < 16; ++i) {
+			float sum = 0.f;
+			for (int c = channels.first; c < channels.first + channels.count; ++c) {
+				sum += (block.channel[c][i] - origin[c]) * direction[c];
+			}
+			t[i] = sum;
+		}
+#endif
+	}
+
+	// level of every pixel on the e0 -> e1 line: the number of 'thresholds' (ascending, in [0, 1]) below
+	// its projection. Levels are positions along the line, formats map them to their index order.
+	static void assign_levels(BlockSoA const& block, const Channels channels, const float e0[4], const float e1[4],
+		const float* thresholds, const int threshold_count, uint8_t levels[16]) {
+		float direction[4] = {};
+		float length2 = 0.f;
+		for (int c = channels.first; c < channels.first + channels.count; ++c) {
+			direction[c] = e1[c] - e0[c];
+			length2 += direction[c] * direction[c];
+		}
+		if (length2 < 1e-6f) {
+			std::memset(levels, 0, 16);
+			return;
+		}
+		for (int c = channels.first; c < channels.first + channels.count; ++c) {
+			direction[c] /= length2;
+		}
+
+		alignas(16) float t[16];
+		project_block(block, channels, e0, direction, t);
+
+#ifdef COOKER_SSE2
+		for (int i = 0; i < 16; i += 4) {
+			const __m128 ti = _mm_load_ps(t + i);
+			__m128i count = _mm_setzero_si128();
+			for (int k = 0; k < threshold_count; ++k) {
+				// the compare mask is -1 where t is past the threshold
+				count = _mm_sub_epi32(count, _mm_castps_si128(_mm_cmpgt_ps(ti, _mm_set1_ps(thresholds[k]))));
+			}
+			alignas(16) int32_t out[4];
+			_mm_store_si128(reinterpret_cast<__m128i*>(out), count);
+			for (int j = 0; j < 4; ++j) {
+				levels[i + j] = static_cast<uint8_t>(out[j]);
+			}
+		}
+#else
+		for (int i = 0; i < 16; ++i) {
+			int count = 0;
+			for (int k = 0; k < threshold_count; ++k) {
+				count += t[i] > thresholds[k];
+			}
+			levels[i] = static_cast<uint8_t>(count);
+		}
+#endif
+	}
+
+	static float block_error(BlockSoA const& block, const Channels channels, const float palette[][4], const uint8_t levels[16]) {
+		float error = 0.f;
+		for (int i = 0; i < 16; ++i) {
+			for (int c = channels.first; c < channels.first + channels.count; ++c) {
+				const float d = palette[levels[i]][c] - block.channel[c][i];
+				error += d * d;
+			}
+		}
+		return error;
+	}
+
+	// endpoints from the extent of the block along its principal axis
+	static void fit_principal_axis(BlockSoA const& block, const Channels channels, float e0[4], float e1[4]) {
+		float mean[4] = {};
+		float axis[4] = {};
+		for (int c = channels.first; c < channels.first + channels.count; ++c) {
+			float sum = 0.f, low = 255.f, high = 0.f;
+			for (int i = 0; i < 16; ++i) {
+				sum += block.channel[c][i];
+				low = std::min(low, block.channel[c][i]);
+				high = std::max(high, block.channel[c][i]);
+			}
+			mean[c] = sum / 16.f;
+			// the bounding box diagonal is a good start for the power iteration
+			axis[c] = high - low;
+		}
+
+		float covariance[4][4] = {};
+		for (int i = 0; i < 16; ++i) {
+			for (int a = channels.first; a < channels.first + channels.count; ++a) {
+				for (int b = a; b < channels.first + channels.count; ++b) {
+					covariance[a][b] += (block.channel[a][i] - mean[a]) * (block.channel[b][i] - mean[b]);
+				}
+			}
+		}
+		for (int a = channels.first; a < channels.first + channels.count; ++a) {
+			for (int b = channels.first; b < a; ++b) {
+				covariance[a][b] = covariance[b][a];
+			}
+		}
+
+		for (int iteration = 0; iteration < 8; ++iteration) {
+			float next[4] = {};
+			float length2 = 0.f;
+			for (int a = channels.first; a < channels.first + channels.count; ++a) {
+				for (int b = channels.first; b < channels.first + channels.count; ++b) {
+					next[a] += covariance[a][b] * axis[b];
+				}
+				length2 += next[a] * next[a];
+			}
+			if (length2 < 1e-12f) {
+				break;
+			}
+			const float inv_length = 1.f / std::sqrt(length2);
+			for (int c = channels.first; c < channels.first + channels.count; ++c) {
+				axis[c] = next[c] * inv_length;
+			}
+		}
+
+		float length2 = 0.f;
+		for (int c = channels.first; c < channels.first + channels.count; ++c) {
+			length2 += axis[c] * axis[c];
+		}
+		if (length2 > 1e-12f) {
+			const float inv_length = 1.f / std::sqrt(length2);
+			for (int c = channels.first; c < channels.first + channels.count; ++c) {
+				axis[c] *= inv_length;
+			}
+		}
+
+		alignas(16) float t[16];
+		project_block(block, channels, mean, axis, t);
+		const float t_min = *std::min_element(t, t + 16);
+		const float t_max = *std::max_element(t, t + 16);
+
+		for (int c = 0; c < 4; ++c) {
+			e0[c] = std::clamp(mean[c] + t_min * axis[c], 0.f, 255.f);
+			e1[c] = std::clamp(mean[c] + t_max * axis[c], 0.f, 255.f);
+		}
+	}
+
+	// least squares endpoints for the given levels, 'weights' is the share of e1 at each level
+	static bool refit_endpoints(BlockSoA const& block, const Channels channels, const float* weights, const uint8_t levels[16], float e0[4], float e1[4]) {
+		float a = 0.f, b = 0.f, c = 0.f;
+		float x0[4] = {}, x1[4] = {};
+		for (int i = 0; i < 16; ++i) {
+			const float w = weights[levels[i]];
+			a += (1.f - w) * (1.f - w);
+			b += (1.f - w) * w;
+			c += w * w;
+			for (int ch = channels.first; ch < channels.first + channels.count; ++ch) {
+				x0[ch] += (1.f - w) * block.channel[ch][i];
+				x1[ch] += w * block.channel[ch][i];
+			}
+		}
+
+		const float determinant = a * c - b * b;
+		if (std::abs(determinant) < 1e-6f) {
+			return false;
+		}
+		const float inv_determinant = 1.f / determinant;
+		for (int ch = channels.first; ch < channels.first + channels.count; ++ch) {
+			e0[ch] = std::clamp((c * x0[ch] - b * x1[ch]) * inv_determinant, 0.f, 255.f);
+			e1[ch] = std::clamp((a * x1[ch] - b * x0[ch]) * inv_determinant, 0.f, 255.f);
+		}
+		return true;
+	}
+
+	static void write_le16(uint8_t* out, const uint16_t value) {
+		out[0] = static_cast<uint8_t>(value);
+		out[1] = static_cast<uint8_t>(value >> 8);
+	}
+
+	static void write_le32(uint8_t* out, const uint32_t value) {
+		for (int i = 0; i < 4; ++i) {
+			out[i] = static_cast<uint8_t>(value >> (8 * i));
+		}
+	}
+
+	// ---- BC1: two RGB565 endpoints, 2 bit indices ----
+
+	static constexpr float BC1_THRESHOLDS[3] = { 1.f / 6.f, 3.f / 6.f, 5.f / 6.f };
+	static constexpr float BC1_WEIGHTS[4] = { 0.f, 1.f / 3.f, 2.f / 3.f, 1.f };
+	// level on the line -> index in the block: 0 and 1 are the endpoints
+	static constexpr uint32_t BC1_INDICES[4] = { 0, 2, 3, 1 };
+
+	static uint16_t pack_565(const float color[4]) {
+		const auto r = static_cast<uint16_t>(std::clamp(std::lround(color[0] * 31.f / 255.f), 0l, 31l));
+		const auto g = static_cast<uint16_t>(std::clamp(std::lround(color[1] * 63.f / 255.f), 0l, 63l));
+		const auto b = static_cast<uint16_t>(std::clamp(std::lround(color[2] * 31.f / 255.f), 0l, 31l));
+		return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+	}
+
+	static void unpack_565(const uint16_t color, float out[4]) {
+		const uint32_t r = (color >> 11) & 31;
+		const uint32_t g = (color >> 5) & 63;
+		const uint32_t b = color & 31;
+		out[0] = static_cast<float>((r << 3) | (r >> 2));
+		out[1] = static_cast<float>((g << 2) | (g >> 4));
+		out[2] = static_cast<float>((b << 3) | (b >> 2));
+		out[3] = 255.f;
+	}
+
+	struct BC1Candidate {
+		uint16_t color0 = 0;
+		uint16_t color1 = 0;
+		uint8_t levels[16] = {};
+		float error = 0.f;
+	};
+
+	static BC1Candidate try_bc1(BlockSoA const& block, const float e0[4], const float e1[4]) {
+		BC1Candidate res;
+		res.color0 = pack_565(e0);
+		res.color1 = pack_565(e1);
+
+		float q0[4], q1[4];
+		unpack_565(res.color0, q0);
+		unpack_565(res.color1, q1);
+		assign_levels(block, RGB, q0, q1, BC1_THRESHOLDS, 3, res.levels);
+
+		float palette[4][4];
+		for (int k = 0; k < 4; ++k) {
+			for (int c = 0; c < 4; ++c) {
+				palette[k][c] = q0[c] + (q1[c] - q0[c]) * BC1_WEIGHTS[k];
+			}
+		}
+		res.error = block_error(block, RGB, palette, res.levels);
+		return res;
+	}
+
+	static void write_bc1(BC1Candidate candidate, uint8_t out[8]) {
+		// color0 > color1 selects the 4 color mode
+		if (candidate.color0 < candidate.color1) {
+			std::swap(candidate.color0, candidate.color1);
+			for (auto& level : candidate.levels) {
+				level = static_cast<uint8_t>(3 - level);
+			}
+		}
+
+		uint32_t indices = 0;
+		if (candidate.color0 != candidate.color1) {
+			for (int i = 0; i < 16; ++i) {
+				indices |= BC1_INDICES[candidate.levels[i]] << (2 * i);
+			}
+		}
+
+		write_le16(out, candidate.color0);
+		write_le16(out + 2, candidate.color1);
+		write_le32(out + 4, indices);
+	}
+
+	static void encode_bc1_color(BlockSoA const& block, uint8_t out[8]) {
+		float e0[4], e1[4];
+		fit_principal_axis(block, RGB, e0, e1);
+
+		BC1Candidate best = try_bc1(block, e0, e1);
+		for (int iteration = 0; iteration < 2 && best.error > 0.f; ++iteration) {
+			if (!refit_endpoints(block, RGB, BC1_WEIGHTS, best.levels, e0, e1)) {
+				break;
+			}
+			const auto candidate = try_bc1(block, e0, e1);
+			if (candidate.error >= best.error) {
+				break;
+			}
+			best = candidate;
+		}
+		write_bc1(best, out);
+	}
+
+	// ---- BC4: one channel, two 8 bit endpoints, 3 bit indices ----
+
+	static constexpr float BC4_THRESHOLDS[7] = {
+		0.5f / 7.f, 1.5f / 7.f, 2.5f / 7.f, 3.5f / 7.f, 4.5f / 7.f, 5.5f / 7.f, 6.5f / 7.f
+	};
+	static constexpr float BC4_WEIGHTS[8] = { 0.f, 1.f / 7.f, 2.f / 7.f, 3.f / 7.f, 4.f / 7.f, 5.f / 7.f, 6.f / 7.f, 1.f };
+
+	struct BC4Candidate {
+		uint8_t value0 = 0;
+		uint8_t value1 = 0;
+		uint8_t levels[16] = {};
+		float error = 0.f;
+	};
+
+	static BC4Candidate try_bc4(BlockSoA const& block, const int channel, const float e0[4], const float e1[4]) {
+		BC4Candidate res;
+		res.value0 = static_cast<uint8_t>(std::lround(e0[channel]));
+		res.value1 = static_cast<uint8_t>(std::lround(e1[channel]));
+
+		float q0[4] = {}, q1[4] = {};
+		q0[channel] = res.value0;
+		q1[channel] = res.value1;
+		assign_levels(block, { channel, 1 }, q0, q1, BC4_THRESHOLDS, 7, res.levels);
+
+		float palette[8][4] = {};
+		for (int k = 0; k < 8; ++k) {
+			palette[k][channel] = q0[channel] + (q1[channel] - q0[channel]) * BC4_WEIGHTS[k];
+		}
+		res.error = block_error(block, { channel, 1 }, palette, res.levels);
+		return res;
+	}
+
+	static void write_bc4(BC4Candidate candidate, uint8_t out[8]) {
+		// value0 > value1 selects the 8 value mode
+		if (candidate.value0 < candidate.value1) {
+			std::swap(candidate.value0, candidate.value1);
+			for (auto& level : candidate.levels) {
+				level = static_cast<uint8_t>(7 - level);
+			}
+		}
+
+		uint64_t indices = 0;
+		if (candidate.value0 != candidate.value1) {
+			for (int i = 0; i < 16; ++i) {
+				// the endpoints are indices 0 and 1, the values between them follow
+				const uint8_t level = candidate.levels[i];
+				const uint64_t index = level == 0 ? 0 : level == 7 ? 1 : level + 1;
+				indices |= index << (3 * i);
+			}
+		}
+
+		out[0] = candidate.value0;
+		out[1] = candidate.value1;
+		for (int i = 0; i < 6; ++i) {
+			out[2 + i] = static_cast<uint8_t>(indices >> (8 * i));
+		}
+	}
+
+	static void encode_bc4_channel(BlockSoA const& block, const int channel, uint8_t out[8]) {
+		float e0[4] = {}, e1[4] = {};
+		e0[channel] = *std::min_element(block.channel[channel], block.channel[channel] + 16);
+		e1[channel] = *std::max_element(block.channel[channel], block.channel[channel] + 16);
+
+		BC4Candidate best = try_bc4(block, channel, e0, e1);
+		for (int iteration = 0; iteration < 2 && best.error > 0.f; ++iteration) {
+			if (!refit_endpoints(block, { channel, 1 }, BC4_WEIGHTS, best.levels, e0, e1)) {
+				break;
+			}
+			const auto candidate = try_bc4(block, channel, e0, e1);
+			if (candidate.error >= best.error) {
+				break;
+			}
+			best = candidate;
+		}
+		write_bc4(best, out);
+	}
+
+	// ---- BC7 mode 6: RGBA 7 bit endpoints with a p-bit each, 4 bit indices ----
+
+	static constexpr int BC7_WEIGHTS4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+	struct BC7Tables {
+		float thresholds[15];
+		float weights[16];
+	};
+
+	static constexpr BC7Tables make_bc7_tables() {
+		BC7Tables res{};
+		for (int k = 0; k < 16; ++k) {
+			res.weights[k] = BC7_WEIGHTS4[k] / 64.f;
+		}
+		for (int k = 0; k < 15; ++k) {
+			res.thresholds[k] = (BC7_WEIGHTS4[k] + BC7_WEIGHTS4[k + 1]) / 128.f;
+		}
+		return res;
+	}
+
+	static constexpr BC7Tables BC7_TABLES = make_bc7_tables();
+
+	struct BC7Endpoint {
+		uint8_t color[4] = {};
+		uint8_t p = 0;
+
+		int value(const int c) const { return (color[c] << 1) | p; }
+	};
+
+	// the p-bit is shared by the four channels, keep the one that lands closer
+	static BC7Endpoint quantize_bc7(const float endpoint[4]) {
+		BC7Endpoint best;
+		float best_error = 0.f;
+		for (uint8_t p = 0; p < 2; ++p) {
+			BC7Endpoint candidate;
+			candidate.p = p;
+			float error = 0.f;
+			for (int c = 0; c < 4; ++c) {
+				candidate.color[c] = static_cast<uint8_t>(std::clamp(std::lround((endpoint[c] - p) * 0.5f), 0l, 127l));
+				const float d = static_cast<float>(candidate.value(c)) - endpoint[c];
+				error += d * d;
+			}
+			if (p == 0 || error < best_error) {
+				best = candidate;
+				best_error = error;
+			}
+		}
+		return best;
+	}
+
+	struct BC7Candidate {
+		BC7Endpoint e0;
+		BC7Endpoint e1;
+		uint8_t levels[16] = {};
+		float error = 0.f;
+	};
+
+	static BC7Candidate try_bc7(BlockSoA const& block, const float e0[4], const float e1[4]) {
+		BC7Candidate res;
+		res.e0 = quantize_bc7(e0);
+		res.e1 = quantize_bc7(e1);
+
+		float q0[4], q1[4];
+		for (int c = 0; c < 4; ++c) {
+			q0[c] = static_cast<float>(res.e0.value(c));
+			q1[c] = static_cast<float>(res.e1.value(c));
+		}
+		assign_levels(block, RGBA, q0, q1, BC7_TABLES.thresholds, 15, res.levels);
+
+		float palette[16][4];
+		for (int k = 0; k < 16; ++k) {
+			for (int c = 0; c < 4; ++c) {
+				palette[k][c] = static_cast<float>(((64 - BC7_WEIGHTS4[k]) * res.e0.value(c) + BC7_WEIGHTS4[k] * res.e1.value(c) + 32) >> 6);
+			}
+		}
+		res.error = block_error(block, RGBA, palette, res.levels);
+		return res;
+	}
+
+	struct BitWriter {
+		uint8_t* out;
+		uint32_t position = 0;
+
+		void write(const uint32_t value, const uint32_t bits) {
+			for (uint32_t i = 0; i < bits; ++i, ++position) {
+				if ((value >> i) & 1) {
+					out[position >> 3] |= static_cast<uint8_t>(1 << (position & 7));
+				}
+			}
+		}
+	};
+
+	static void write_bc7(BC7Candidate candidate, uint8_t out[16]) {
+		// the top index bit of pixel 0 is implied zero
+		if (candidate.levels[0] >= 8) {
+			std::swap(candidate.e0, candidate.e1);
+			for (auto& level : candidate.levels) {
+				level = static_cast<uint8_t>(15 - level);
+			}
+		}
+
+		std::memset(out, 0, 16);
+		BitWriter writer{ out };
+		writer.write(1 << 6, 7);
+		for (int c = 0; c < 4; ++c) {
+			writer.write(candidate.e0.color[c], 7);
+			writer.write(candidate.e1.color[c], 7);
+		}
+		writer.write(candidate.e0.p, 1);
+		writer.write(candidate.e1.p, 1);
+		writer.write(candidate.levels[0], 3);
+		for (int i = 1; i < 16; ++i) {
+			writer.write(candidate.levels[i], 4);
+		}
+	}
+
+	void encode_bc1(PixelBlock const& block, uint8_t out[8]) {
+		encode_bc1_color(to_soa(block), out);
+	}
+
+	void encode_bc3(PixelBlock const& block, uint8_t out[16]) {
+		const auto soa = to_soa(block);
+		encode_bc4_channel(soa, 3, out);
+		encode_bc1_color(soa, out + 8);
+	}
+
+	void encode_bc5(PixelBlock const& block, uint8_t out[16]) {
+		const auto soa = to_soa(block);
+		encode_bc4_channel(soa, 0, out);
+		encode_bc4_channel(soa, 1, out + 8);
+	}
+
+	void encode_bc7(PixelBlock const& block, uint8_t out[16]) {
+		const auto soa = to_soa(block);
+
+		float e0[4], e1[4];
+		fit_principal_axis(soa, RGBA, e0, e1);
+
+		BC7Candidate best = try_bc7(soa, e0, e1);
+		for (int iteration = 0; iteration < 3 && best.error > 0.f; ++iteration) {
+			if (!refit_endpoints(soa, RGBA, BC7_TABLES.weights, best.levels, e0, e1)) {
+				break;
+			}
+			const auto candidate = try_bc7(soa, e0, e1);
+			if (candidate.error >= best.error) {
+				break;
+			}
+			best = candidate;
+		}
+		write_bc7(best, out);
+	}
+
+	void encode_block(const BlockFormat format, PixelBlock const& block, uint8_t* out) {
+		switch (format) {
+		case BlockFormat::BC1: encode_bc1(block, out); break;
+		case BlockFormat::BC3: encode_bc3(block, out); break;
+		case BlockFormat::BC5: encode_bc5(block, out); break;
+		case BlockFormat::BC7: encode_bc7(block, out); break;
+		}
+	}
+
+	void encode_block_rows(const BlockFormat format, const uint8_t* rgba, const uint32_t width, const uint32_t height,
+		const uint32_t first_row, const uint32_t last_row, uint8_t* out) {
+		const uint32_t blocks_x = std::max((width + 3) / 4, 1u);
+		const size_t block_bytes = EngineCore::get_block_bytes(format);
+
+		PixelBlock block;
+		for (uint32_t by = first_row; by < last_row; ++by) {
+			for (uint32_t bx = 0; bx < blocks_x; ++bx) {
+				for (uint32_t y = 0; y < 4; ++y) {
+					const uint32_t sy = std::min(by * 4 + y, height - 1);
+					for (uint32_t x = 0; x < 4; ++x) {
+						const uint32_t sx = std::min(bx * 4 + x, width - 1);
+						std::memcpy(block.rgba[y * 4 + x], rgba + (size_t(sy) * width + sx) * 4, 4);
+					}
+				}
+				encode_block(format, block, out + (size_t(by) * blocks_x + bx) * block_bytes);
+			}
+		}
+	}
+
+	const char* get_simd_path_name() {
+#ifdef COOKER_SSE2
+		return "SSE2";
+#else
+		return "scalar";
+#endif
+	}
+
+}
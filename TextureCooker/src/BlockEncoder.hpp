@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+#include "EngineCore/Modules/TextureFile.hpp"
+
+namespace TextureCooker {
+
+	using EngineCore::BlockFormat;
+
+	// 4x4 RGBA8 pixels, row by row
+	struct PixelBlock {
+		uint8_t rgba[16][4];
+	};
+
+	// Endpoints come from the principal axis of the block, get quantized, pixels are assigned by
+	// projecting them on the quantized line and a least squares refit runs once more.
+	// BC1/BC3 color always uses the 4 color mode, BC7 only mode 6 (one subset, 4 bit indices).
+	void encode_bc1(PixelBlock const& block, uint8_t out[8]);
+	void encode_bc3(PixelBlock const& block, uint8_t out[16]);
+	// red and green as two BC4 blocks
+	void encode_bc5(PixelBlock const& block, uint8_t out[16]);
+	void encode_bc7(PixelBlock const& block, uint8_t out[16]);
+
+	void encode_block(const BlockFormat format, PixelBlock const& block, uint8_t* out);
+
+	// encodes block rows [first_row, last_row) of a width x height RGBA8 image into 'out',
+	// which holds the whole level; edge blocks repeat the last row and column
+	void encode_block_rows(const BlockFormat format, const uint8_t* rgba, const uint32_t width, const uint32_t height,
+		const uint32_t first_row, const uint32_t last_row, uint8_t* out);
+
+	// "SSE2" or "scalar", fixed at compile time
+	const char* get_simd_path_name();
+
+}
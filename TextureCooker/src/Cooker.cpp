@@ -0,0 +1,159 @@
+#include "Cooker.hpp"
+
+#include "EngineCore/Modules/FileRead.hpp"
+#include "EngineCore/Modules/TextureFile.hpp"
+#include "EngineCore/Modules/ThreadPool.hpp"
+
+#include <bit>
+#include <cmath>
+#include <future>
+#include <algorithm>
+
+namespace TextureCooker {
+
+	// encode tasks get at least this many blocks, smaller levels go in one task
+	static constexpr size_t MIN_BLOCKS_PER_TASK = 1024;
+
+	bool decode_rgba(std::string const& path, RgbaImage& image) {
+		const auto decoded = EngineCore::read_image(path.c_str());
+		if (!decoded.image || decoded.channels < 1 || decoded.channels > 4) {
+			return false;
+		}
+
+		image.width = static_cast<uint32_t>(decoded.width);
+		image.height = static_cast<uint32_t>(decoded.height);
+		image.pixels.resize(size_t(image.width) * image.height * 4);
+
+		const size_t count = size_t(image.width) * image.height;
+		const int channels = decoded.channels;
+		for (size_t i = 0; i < count; ++i) {
+			const uint8_t* src = decoded.image + i * channels;
+			uint8_t* dst = image.pixels.data() + i * 4;
+			// 1 and 2 channel images are grey (+ alpha)
+			dst[0] = src[0];
+			dst[1] = channels >= 3 ? src[1] : src[0];
+			dst[2] = channels >= 3 ? src[2] : src[0];
+			dst[3] = channels == 4 ? src[3] : channels == 2 ? src[1] : 255;
+		}
+		return true;
+	}
+
+	RgbaImage downsample(RgbaImage const& image, const bool normal_map) {
+		RgbaImage res;
+		res.width = std::max(image.width / 2, 1u);
+		res.height = std::max(image.height / 2, 1u);
+		res.pixels.resize(size_t(res.width) * res.height * 4);
+
+		for (uint32_t y = 0; y < res.height; ++y) {
+			const uint32_t y0 = std::min(y * 2, image.height - 1);
+			const uint32_t y1 = std::min(y * 2 + 1, image.height - 1);
+			for (uint32_t x = 0; x < res.width; ++x) {
+				const uint32_t x0 = std::min(x * 2, image.width - 1);
+				const uint32_t x1 = std::min(x * 2 + 1, image.width - 1);
+
+				const uint8_t* taps[4] = {
+					image.pixels.data() + (size_t(y0) * image.width + x0) * 4,
+					image.pixels.data() + (size_t(y0) * image.width + x1) * 4,
+					image.pixels.data() + (size_t(y1) * image.width + x0) * 4,
+					image.pixels.data() + (size_t(y1) * image.width + x1) * 4,
+				};
+				uint8_t* dst = res.pixels.data() + (size_t(y) * res.width + x) * 4;
+
+				if (!normal_map) {
+					for (int c = 0; c < 4; ++c) {
+						dst[c] = static_cast<uint8_t>((taps[0][c] + taps[1][c] + taps[2][c] + taps[3][c] + 2) / 4);
+					}
+					continue;
+				}
+
+				float normal[3] = {};
+				for (auto tap : taps) {
+					for (int c = 0; c < 3; ++c) {
+						normal[c] += tap[c] / 127.5f - 1.f;
+					}
+				}
+				const float length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+				for (int c = 0; c < 3; ++c) {
+					const float n = length > 1e-6f ? normal[c] / length : (c == 2 ? 1.f : 0.f);
+					dst[c] = static_cast<uint8_t>(std::clamp(std::lround((n + 1.f) * 127.5f), 0l, 255l));
+				}
+				dst[3] = static_cast<uint8_t>((taps[0][3] + taps[1][3] + taps[2][3] + taps[3][3] + 2) / 4);
+			}
+		}
+		return res;
+	}
+
+	bool is_cooked(std::string const& path) {
+		uint64_t source_mtime = 0, source_size = 0, cooked_mtime = 0, cooked_size = 0;
+		return EngineCore::get_file_stamp(path, source_mtime, source_size)
+			&& EngineCore::get_file_stamp(EngineCore::get_cooked_path(path), cooked_mtime, cooked_size)
+			&& cooked_mtime >= source_mtime;
+	}
+
+	static BlockFormat choose_format(RgbaImage const& image, const FormatChoice choice) {
+		switch (choice) {
+		case FormatChoice::BC1: return BlockFormat::BC1;
+		case FormatChoice::BC3: return BlockFormat::BC3;
+		case FormatChoice::BC5: return BlockFormat::BC5;
+		case FormatChoice::BC7: return BlockFormat::BC7;
+		case FormatChoice::Auto: break;
+		}
+
+		for (size_t i = 3; i < image.pixels.size(); i += 4) {
+			if (image.pixels[i] != 255) {
+				return BlockFormat::BC3;
+			}
+		}
+		return BlockFormat::BC1;
+	}
+
+	bool cook_texture(std::string const& path, RgbaImage image, CookOptions const& options, EngineCore::ThreadPool& pool, CookResult& result) {
+		const BlockFormat format = choose_format(image, options.format);
+		// same level count as Texture2D, so cooked and decoded textures share texture arrays
+		const auto level_count = static_cast<uint32_t>(std::bit_width(std::max(image.width, image.height)));
+
+		EngineCore::CompressedImage_t cooked;
+		cooked.allocate(format, image.width, image.height, level_count);
+
+		result = {};
+		result.format = format;
+		result.width = image.width;
+		result.height = image.height;
+		result.levels = level_count;
+
+		// levels are kept until their tasks are done, the next one is filtered meanwhile
+		std::vector<RgbaImage> levels;
+		levels.reserve(level_count);
+		levels.push_back(std::move(image));
+
+		std::vector<std::future<void>> tasks;
+		for (uint32_t i = 0; i < level_count; ++i) {
+			if (i > 0) {
+				levels.push_back(downsample(levels.back(), format == BlockFormat::BC5));
+			}
+			auto const& level = levels.back();
+			auto const& target = cooked.levels[i];
+			result.uncompressed_bytes += size_t(level.width) * level.height * 4;
+
+			const uint32_t blocks_x = std::max((level.width + 3) / 4, 1u);
+			const uint32_t blocks_y = std::max((level.height + 3) / 4, 1u);
+			const uint32_t rows_per_task = static_cast<uint32_t>(std::max<size_t>(MIN_BLOCKS_PER_TASK / blocks_x, 1));
+
+			uint8_t* out = cooked.data.data() + target.offset;
+			for (uint32_t row = 0; row < blocks_y; row += rows_per_task) {
+				const uint32_t last_row = std::min(row + rows_per_task, blocks_y);
+				tasks.push_back(pool.submit([format, &level, row, last_row, out]() {
+					encode_block_rows(format, level.pixels.data(), level.width, level.height, row, last_row, out);
+				}));
+			}
+		}
+
+		for (auto& task : tasks) {
+			task.get();
+		}
+
+		result.cooked_bytes = cooked.data.size();
+		return EngineCore::write_dds(EngineCore::get_cooked_path(path), cooked);
+	}
+
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include "BlockEncoder.hpp"
+
+namespace EngineCore {
+	class ThreadPool;
+}
+
+namespace TextureCooker {
+
+	enum class FormatChoice {
+		// BC1 when every pixel is opaque, BC3 otherwise
+		Auto,
+		BC1, BC3, BC5, BC7
+	};
+
+	struct CookOptions {
+		FormatChoice format = FormatChoice::Auto;
+		// cook even when the output is newer than the source
+		bool force = false;
+	};
+
+	// one level, 4 bytes per pixel
+	struct RgbaImage {
+		uint32_t width = 0;
+		uint32_t height = 0;
+		std::vector<uint8_t> pixels;
+	};
+
+	struct CookResult {
+		BlockFormat format = BlockFormat::BC1;
+		uint32_t width = 0;
+		uint32_t height = 0;
+		uint32_t levels = 0;
+		// RGBA8 with a full mip chain, what Texture2D allocates for the source
+		size_t uncompressed_bytes = 0;
+		size_t cooked_bytes = 0;
+	};
+
+	// any image stb_image reads, expanded to RGBA
+	bool decode_rgba(std::string const& path, RgbaImage& image);
+
+	// 2x2 box filter, odd sizes repeat the last row or column; normal maps are renormalized
+	RgbaImage downsample(RgbaImage const& image, const bool normal_map);
+
+	bool is_cooked(std::string const& path);
+
+	// builds the mip chain, encodes every level on 'pool' and writes get_cooked_path(path)
+	bool cook_texture(std::string const& path, RgbaImage image, CookOptions const& options, EngineCore::ThreadPool& pool, CookResult& result);
+
+}
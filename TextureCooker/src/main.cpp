@@ -0,0 +1,161 @@
+#include "Cooker.hpp"
+
+#include "EngineCore/Modules/ThreadPool.hpp"
+#include "EngineCore/Modules/TextureFile.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <format>
+#include <future>
+#include <string>
+#include <vector>
+#include <optional>
+#include <algorithm>
+#include <filesystem>
+
+// Offline texture cooker: writes '<source>.dds' next to every source image with a block compressed
+// mip chain, which the engine loads instead of decoding the source. Up to date outputs are skipped.
+// usage: TextureCooker [-f auto|bc1|bc3|bc5|bc7] [-j threads] [--force] <image or directory>...
+
+using namespace TextureCooker;
+
+static constexpr const char* SOURCE_EXTENSIONS[] = { ".png", ".jpg", ".jpeg", ".tga", ".bmp" };
+
+static bool is_source_image(std::filesystem::path const& path) {
+	auto extension = path.extension().string();
+	std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+	return std::find(std::begin(SOURCE_EXTENSIONS), std::end(SOURCE_EXTENSIONS), extension) != std::end(SOURCE_EXTENSIONS);
+}
+
+static void collect_sources(std::string const& input, std::vector<std::string>& sources) {
+	std::error_code ec;
+	if (!std::filesystem::is_directory(input, ec)) {
+		sources.push_back(input);
+		return;
+	}
+	for (auto const& entry : std::filesystem::recursive_directory_iterator(input, ec)) {
+		if (entry.is_regular_file() && is_source_image(entry.path())) {
+			sources.push_back(entry.path().generic_string());
+		}
+	}
+}
+
+static bool parse_format(const char* name, FormatChoice& format) {
+	static constexpr std::pair<const char*, FormatChoice> FORMATS[] = {
+		{ "auto", FormatChoice::Auto }, { "bc1", FormatChoice::BC1 }, { "bc3", FormatChoice::BC3 },
+		{ "bc5", FormatChoice::BC5 }, { "bc7", FormatChoice::BC7 },
+	};
+	for (auto const& [key, value] : FORMATS) {
+		if (std::strcmp(name, key) == 0) {
+			format = value;
+			return true;
+		}
+	}
+	return false;
+}
+
+static int print_usage() {
+	std::fputs("usage: TextureCooker [-f auto|bc1|bc3|bc5|bc7] [-j threads] [--force] <image or directory>...\n", stderr);
+	return 2;
+}
+
+int main(int argc, char** argv) {
+	CookOptions options;
+	size_t thread_count = EngineCore::ThreadPool::default_thread_count();
+	std::vector<std::string> sources;
+
+	for (int i = 1; i < argc; ++i) {
+		const char* arg = argv[i];
+		if (std::strcmp(arg, "-f") == 0 && i + 1 < argc) {
+			if (!parse_format(argv[++i], options.format)) {
+				return print_usage();
+			}
+		}
+		else if (std::strcmp(arg, "-j") == 0 && i + 1 < argc) {
+			thread_count = static_cast<size_t>(std::max(std::atoi(argv[++i]), 1));
+		}
+		else if (std::strcmp(arg, "--force") == 0) {
+			options.force = true;
+		}
+		else if (arg[0] == '-') {
+			return print_usage();
+		}
+		else {
+			collect_sources(arg, sources);
+		}
+	}
+	if (sources.empty()) {
+		return print_usage();
+	}
+	std::sort(sources.begin(), sources.end());
+	sources.erase(std::unique(sources.begin(), sources.end()), sources.end());
+
+	std::vector<std::string> pending;
+	for (auto const& source : sources) {
+		if (options.force || !is_cooked(source)) {
+			pending.push_back(source);
+		}
+	}
+
+	EngineCore::ThreadPool pool(thread_count);
+	std::puts(std::format("cooking {} of {} textures on {} threads ({})",
+		pending.size(), sources.size(), pool.get_thread_count(), get_simd_path_name()).c_str());
+
+	const auto start = std::chrono::steady_clock::now();
+	size_t failed = 0;
+	size_t uncompressed_bytes = 0;
+	size_t cooked_bytes = 0;
+
+	auto decode = [&pool](std::string const& path) {
+		return pool.submit([path]() -> std::optional<RgbaImage> {
+			RgbaImage image;
+			if (!decode_rgba(path, image)) {
+				return std::nullopt;
+			}
+			return image;
+		});
+	};
+
+	// the next source decodes on the pool while the current one is encoded
+	std::future<std::optional<RgbaImage>> next;
+	if (!pending.empty()) {
+		next = decode(pending.front());
+	}
+
+	for (size_t i = 0; i < pending.size(); ++i) {
+		auto image = next.get();
+		if (i + 1 < pending.size()) {
+			next = decode(pending[i + 1]);
+		}
+
+		auto const& path = pending[i];
+		if (!image) {
+			std::fputs(std::format("failed to decode '{}'\n", path).c_str(), stderr);
+			++failed;
+			continue;
+		}
+
+		const auto texture_start = std::chrono::steady_clock::now();
+		CookResult result;
+		if (!cook_texture(path, std::move(*image), options, pool, result)) {
+			std::fputs(std::format("failed to write '{}'\n", EngineCore::get_cooked_path(path)).c_str(), stderr);
+			++failed;
+			continue;
+		}
+
+		uncompressed_bytes += result.uncompressed_bytes;
+		cooked_bytes += result.cooked_bytes;
+		const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - texture_start).count();
+		std::puts(std::format("{} {}x{} {} levels {}: {} KB -> {} KB in {:.1f} ms",
+			path, result.width, result.height, result.levels, EngineCore::get_block_format_name(result.format),
+			result.uncompressed_bytes / 1024, result.cooked_bytes / 1024, ms).c_str());
+	}
+
+	const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	std::puts(std::format("cooked {} textures, {} failed: {:.1f} MB -> {:.1f} MB in {:.2f} s",
+		pending.size() - failed, failed, uncompressed_bytes / (1024.0 * 1024.0), cooked_bytes / (1024.0 * 1024.0), seconds).c_str());
+
+	return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,38 @@
+#version 430
+
+// the point light uniforms nanosuit.frag had before lights moved into a storage buffer,
+// every field is read so none of them is optimized out
+const uint MAX_POINT_LIGHT_ARRAY_SIZE = 32;
+
+struct PointLight {
+    vec3 position_eye;
+
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;
+    float shininess;
+
+    float linear;
+    float quadro;
+    float intensity;
+};
+
+struct PointLightArray {
+    uint size;
+    PointLight pnts[MAX_POINT_LIGHT_ARRAY_SIZE];
+};
+
+uniform PointLightArray PLA;
+
+out vec4 frag_color;
+
+void main() {
+    vec3 res = vec3(0.0);
+    for (uint i = 0; i < PLA.size; ++i) {
+        PointLight light = PLA.pnts[i];
+        float dist = length(light.position_eye - gl_FragCoord.xyz);
+        float attenuation = light.intensity / (1.0 + light.linear * dist + light.quadro * dist * dist);
+        res += (light.ambient + light.diffuse + light.specular * pow(0.5, light.shininess)) * attenuation;
+    }
+    frag_color = vec4(res, 1.0);
+}
@@ -0,0 +1,7 @@
+#version 430
+
+// bench --uniforms only links this program, nothing is drawn with it
+void main() {
+    const vec2 positions[3] = vec2[](vec2(-1.0, -1.0), vec2(3.0, -1.0), vec2(-1.0, 3.0));
+    gl_Position = vec4(positions[gl_VertexID], 0.0, 1.0);
+}